@@ -0,0 +1,10 @@
+#version 330 core
+// Temporal accumulation: copy the jittered frame; constant-alpha blending averages it
+// into the history target.
+uniform sampler2D uScene;
+
+out vec4 FragColor;
+
+void main(){
+    FragColor = vec4(texelFetch(uScene, ivec2(gl_FragCoord.xy), 0).rgb, 1.0);
+}
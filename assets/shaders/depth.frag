@@ -0,0 +1,4 @@
+#version 330 core
+// Depth pre-pass, linked with phong.vert; color writes are masked
+void main(){
+}
@@ -0,0 +1,44 @@
+#version 330 core
+// FXAA (after Lottes' FXAA 3.11 console variant): estimate the local edge direction
+// from luma and blend along it. Runs on the scene-resolution image while stretching
+// it over the window.
+uniform sampler2D uScene;
+uniform vec2 uTexel;    // 1 / allocated target size
+uniform vec2 uExtent;   // rendered part of the target, in uv
+uniform vec2 uWindow;   // window size in pixels
+
+out vec4 FragColor;
+
+const float kReduceMin = 1.0 / 128.0;
+const float kReduceMul = 1.0 / 8.0;
+const float kSpanMax = 8.0;
+
+// Keep taps inside the rendered rectangle of the larger target
+vec3 fetch(vec2 uv){
+    return texture(uScene, clamp(uv, 0.5 * uTexel, uExtent - 0.5 * uTexel)).rgb;
+}
+
+float luma(vec3 c){ return dot(c, vec3(0.299, 0.587, 0.114)); }
+
+void main(){
+    vec2 uv = gl_FragCoord.xy / uWindow * uExtent;
+    vec3 rgbM = fetch(uv);
+    float lumaNW = luma(fetch(uv + vec2(-1.0, -1.0) * uTexel));
+    float lumaNE = luma(fetch(uv + vec2( 1.0, -1.0) * uTexel));
+    float lumaSW = luma(fetch(uv + vec2(-1.0,  1.0) * uTexel));
+    float lumaSE = luma(fetch(uv + vec2( 1.0,  1.0) * uTexel));
+    float lumaM = luma(rgbM);
+    float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+    float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+    vec2 dir = vec2(-((lumaNW + lumaNE) - (lumaSW + lumaSE)),
+                     ((lumaNW + lumaSW) - (lumaNE + lumaSE)));
+    float dirReduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * (0.25 * kReduceMul), kReduceMin);
+    float rcpDirMin = 1.0 / (min(abs(dir.x), abs(dir.y)) + dirReduce);
+    dir = clamp(dir * rcpDirMin, vec2(-kSpanMax), vec2(kSpanMax)) * uTexel;
+
+    vec3 rgbA = 0.5 * (fetch(uv + dir * (1.0 / 3.0 - 0.5)) + fetch(uv + dir * (2.0 / 3.0 - 0.5)));
+    vec3 rgbB = rgbA * 0.5 + 0.25 * (fetch(uv - dir * 0.5) + fetch(uv + dir * 0.5));
+    float lumaB = luma(rgbB);
+    FragColor = vec4((lumaB < lumaMin || lumaB > lumaMax) ? rgbA : rgbB, 1.0);
+}
@@ -2,9 +2,19 @@
 layout(location=0) in vec3 aPos;
 layout(location=1) in vec3 aCol;
 out vec3 vCol;
-uniform mat4 uView, uProj;
+layout(std140) uniform Frame {     // written once per frame, see gfx/UniformBuffers.hpp
+    mat4  uView;
+    mat4  uProj;
+    mat4  uViewProj;
+    vec4  uViewPos;     // camera position, world space
+    vec4  uLightDir;    // normalized, world space (direction towards surface)
+    vec4  uEnvSky;      // sky tint (hemisphere + reflection), a = environment intensity
+    vec4  uEnvGround;   // ground tint
+    ivec4 uFrameFlags;  // x = lighting, y = environment
+    float uWireWidth;   // wireframe edge width in target pixels (WIREFRAME)
+};
 void main(){
   vCol = aCol;
-  gl_Position = uProj * uView * vec4(aPos,1.0);
+  gl_Position = uViewProj * vec4(aPos,1.0);
 }
 
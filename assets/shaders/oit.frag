@@ -0,0 +1,17 @@
+#version 330 core
+// Resolve weighted blended transparency: average color = weighted sum / weight sum,
+// coverage = 1 - product of (1 - alpha). Blended over the opaque image.
+uniform sampler2D uAccum;   // rgb = sum of color * alpha * weight, a = revealage
+uniform sampler2D uWeight;  // r = sum of alpha * weight
+uniform ivec2 uOrigin;      // viewport origin; targets start at 0
+
+out vec4 FragColor;
+
+void main(){
+    ivec2 p = ivec2(gl_FragCoord.xy) - uOrigin;
+    vec4 accum = texelFetch(uAccum, p, 0);
+    float revealage = accum.a;
+    if (revealage >= 1.0) discard;
+    float weight = texelFetch(uWeight, p, 0).r;
+    FragColor = vec4(accum.rgb / max(weight, 1e-5), 1.0 - revealage);
+}
@@ -1,39 +1,124 @@
 #version 330 core
+// Compile-time features (see gfx/ShaderVariants.hpp): LIGHTING, ENVIRONMENT,
+// BASE_COLOR_TEX, NORMAL_TEX, BATCHED, OIT, WIREFRAME. Each draw runs the smallest variant.
 in vec3 vCol;
 in vec3 vNormal;
 in vec3 vWorldPos;
 in vec2 vUV;
+in vec4 vTangent;
+flat in uint vMaterial;
+#ifdef WIREFRAME
+noperspective in vec3 vBary;  // from phong.geom
+#endif
 
-out vec4 FragColor;
+layout(location = 0) out vec4 FragColor;
+layout(location = 1) out vec4 OitWeight;  // OIT pass only, see gfx/WeightedOit.hpp
+
+layout(std140) uniform Frame {     // written once per frame, see gfx/UniformBuffers.hpp
+    mat4  uView;
+    mat4  uProj;
+    mat4  uViewProj;
+    vec4  uViewPos;     // camera position, world space
+    vec4  uLightDir;    // normalized, world space (direction towards surface)
+    vec4  uEnvSky;      // sky tint (hemisphere + reflection), a = environment intensity
+    vec4  uEnvGround;   // ground tint
+    ivec4 uFrameFlags;  // x = lighting, y = environment (variants use LIGHTING/ENVIRONMENT)
+    float uWireWidth;   // wireframe edge width in target pixels (WIREFRAME)
+};
+
+layout(std140) uniform Material {  // one range per draw
+    vec4  uBaseColorFactor; // glTF baseColorFactor (rgb multiplicative, a used for blending)
+    float uNormalScale;     // glTF normalTexture.scale
+    bool  uHasBaseColorTex; // layout only; BASE_COLOR_TEX / NORMAL_TEX pick the variant
+    bool  uHasNormalTex;
+};
 
-uniform vec3 uLightDir;    // normalized, world space (direction towards surface)
-uniform vec3 uViewPos;     // camera position, world space
-uniform bool uUseLighting;
-uniform bool uHasBaseColorTex;
 uniform sampler2D uBaseColorTex;
-uniform vec4 uBaseColorFactor; // glTF baseColorFactor (rgb multiplicative, a used for blending)
-// Simple environment lighting controls
-uniform bool  uUseEnv;           // enable environment contribution
-uniform vec3  uEnvSkyColor;      // sky tint (used for hemisphere + reflection)
-uniform vec3  uEnvGroundColor;   // ground tint
-uniform float uEnvIntensity;     // scale of environment contribution
+uniform sampler2D uNormalTex;  // tangent-space normal map (linear)
+
+// Batched mode: materials come from a table indexed per vertex instead of the block above.
+// Three texels per material: base color factor; (normal scale, base array, base layer,
+// normal array); (normal layer). Array -1 means no texture.
+#ifdef BATCHED
+uniform samplerBuffer uMaterialTable;
+uniform sampler2DArray uTexArrays[4];  // textures bucketed by size and color space
+#endif
+
+// Weighted blended OIT: target 0 gets depth-weighted premultiplied color plus alpha
+// (blended into the product of 1 - alpha), target 1 the weight
+void writeColor(vec4 c){
+#ifdef WIREFRAME
+    // Pixels to the nearest edge from the barycentric gradients; each triangle draws its
+    // half of the shared edge, faded over one pixel
+    vec3 px = vBary / max(fwidth(vBary), vec3(1e-6));
+    float edge = clamp(0.5 * uWireWidth + 0.5 - min(px.x, min(px.y, px.z)), 0.0, 1.0);
+    c.rgb = mix(c.rgb, vec3(0.08), edge);
+#endif
+#ifdef OIT
+    float w = c.a * clamp(3e3 * pow(1.0 - gl_FragCoord.z, 3.0), 1e-2, 3e3);
+    FragColor = vec4(c.rgb * c.a * w, c.a);
+    OitWeight = vec4(c.a * w);
+#else
+    FragColor = c;
+#endif
+}
+
+// GLSL 3.30 only indexes sampler arrays with constants; gradients are taken outside
+// the branch because neighbouring fragments may pick different arrays
+#ifdef BATCHED
+vec4 sampleArray(int a, vec3 uvLayer, vec2 dx, vec2 dy){
+    if (a == 0) return textureGrad(uTexArrays[0], uvLayer, dx, dy);
+    if (a == 1) return textureGrad(uTexArrays[1], uvLayer, dx, dy);
+    if (a == 2) return textureGrad(uTexArrays[2], uvLayer, dx, dy);
+    return textureGrad(uTexArrays[3], uvLayer, dx, dy);
+}
+#endif
 
 void main(){
     vec4 base = vec4(vCol, 1.0);
-    if (uHasBaseColorTex) {
-        base = texture(uBaseColorTex, vUV);
-    }
-    base *= uBaseColorFactor;
-
-    if(!uUseLighting){
-        FragColor = base;
-        return;
-    }
+#ifdef BATCHED
+    // Per-vertex materials, so texture presence stays a runtime test here
+    int m = int(vMaterial) * 3;
+    vec4 slots = texelFetch(uMaterialTable, m + 1);
+    float normalLayer = texelFetch(uMaterialTable, m + 2).x;
+    vec2 dx = dFdx(vUV), dy = dFdy(vUV);
+    vec4 factor = texelFetch(uMaterialTable, m);
+    float normalScale = slots.x;
+    if (slots.y >= 0.0) base = sampleArray(int(slots.y), vec3(vUV, slots.z), dx, dy);
+    bool hasNormal = slots.w >= 0.0;
+    vec3 tn = hasNormal ? sampleArray(int(slots.w), vec3(vUV, normalLayer), dx, dy).xyz : vec3(0.0, 0.0, 1.0);
+#else
+    vec4 factor = uBaseColorFactor;
+    float normalScale = uNormalScale;
+  #ifdef BASE_COLOR_TEX
+    base = texture(uBaseColorTex, vUV);
+  #endif
+  #ifdef NORMAL_TEX
+    bool hasNormal = true;
+    vec3 tn = texture(uNormalTex, vUV).xyz;
+  #else
+    bool hasNormal = false;
+    vec3 tn = vec3(0.0, 0.0, 1.0);
+  #endif
+#endif
+    base *= factor;
 
+#ifndef LIGHTING
+    writeColor(base);
+#else
     // Phong lighting
     vec3 N = normalize(vNormal);
-    vec3 L = normalize(uLightDir);
-    vec3 V = normalize(uViewPos - vWorldPos);
+  #if defined(NORMAL_TEX) || defined(BATCHED)
+    if (hasNormal && dot(vTangent.xyz, vTangent.xyz) > 0.0) {
+        vec3 T = normalize(vTangent.xyz - N * dot(N, vTangent.xyz));
+        vec3 B = cross(N, T) * vTangent.w;
+        tn = tn * 2.0 - 1.0;
+        tn.xy *= normalScale;
+        N = normalize(mat3(T, B, N) * tn);
+    }
+  #endif
+    vec3 L = normalize(uLightDir.xyz);
+    vec3 V = normalize(uViewPos.xyz - vWorldPos);
     vec3 R = reflect(-L, N);
 
     float diff = max(dot(N, L), 0.0);
@@ -46,18 +131,21 @@ void main(){
 
     // Environment lighting (simple hemisphere + view-dependent reflection tint)
     vec3 envAdd = vec3(0.0);
-    if (uUseEnv) {
+  #ifdef ENVIRONMENT
+    {
         // Hemisphere ambient based on normal's upness
         float h = clamp(N.y * 0.5 + 0.5, 0.0, 1.0);
-        vec3 hemi = mix(uEnvGroundColor, uEnvSkyColor, h) * baseColor;
+        vec3 hemi = mix(uEnvGround.rgb, uEnvSky.rgb, h) * baseColor;
         // Simple reflection tint from reflection vector
         vec3 Rv = reflect(-V, N);
         float rMix = clamp(Rv.y * 0.5 + 0.5, 0.0, 1.0);
-        vec3 envRefl = mix(uEnvGroundColor, uEnvSkyColor, rMix);
+        vec3 envRefl = mix(uEnvGround.rgb, uEnvSky.rgb, rMix);
         float fres = pow(1.0 - max(dot(N, V), 0.0), 5.0);
         vec3 refl = envRefl * (0.5 * fres);
-        envAdd = (hemi + refl) * uEnvIntensity;
+        envAdd = (hemi + refl) * uEnvSky.a;
     }
+  #endif
 
-    FragColor = vec4(ambient + diffuse + specular + envAdd, base.a);
+    writeColor(vec4(ambient + diffuse + specular + envAdd, base.a));
+#endif
 }
@@ -3,22 +3,83 @@ layout(location=0) in vec3 aPos;
 layout(location=1) in vec3 aNormal;
 layout(location=2) in vec3 aCol;
 layout(location=3) in vec2 aUV;
+layout(location=4) in vec4 aTangent; // xyz world-space tangent, w bitangent sign
+layout(location=5) in uvec4 aJoints;  // indices into the joint palette
+layout(location=6) in vec4 aWeights;
+layout(location=7) in uvec2 aMorph;   // first delta record, record count
+layout(location=8) in uint aMaterial; // batched mode: row in the material table
 
+#ifdef WIREFRAME
+// phong.geom sits in between and forwards these under the names phong.frag expects
+#define vCol      gCol
+#define vNormal   gNormal
+#define vWorldPos gWorldPos
+#define vUV       gUV
+#define vTangent  gTangent
+#define vMaterial gMaterial
+#endif
 out vec3 vCol;
 out vec3 vNormal;
 out vec3 vWorldPos;
 out vec2 vUV;
+out vec4 vTangent;
+flat out uint vMaterial;
+
+layout(std140) uniform Frame {     // written once per frame, see gfx/UniformBuffers.hpp
+    mat4  uView;
+    mat4  uProj;
+    mat4  uViewProj;
+    vec4  uViewPos;     // camera position, world space
+    vec4  uLightDir;    // normalized, world space (direction towards surface)
+    vec4  uEnvSky;      // sky tint (hemisphere + reflection), a = environment intensity
+    vec4  uEnvGround;   // ground tint
+    ivec4 uFrameFlags;  // x = lighting, y = environment
+    float uWireWidth;   // wireframe edge width in target pixels (WIREFRAME)
+};
 
 uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProj;
 uniform mat3 uNormalMat;
+uniform bool uSkinned;
+uniform samplerBuffer uJoints;        // joint palette, 4 texels per matrix
+uniform bool uMorphed;
+uniform samplerBuffer uMorphDeltas;   // 2 texels per record: (position delta, weight slot), (normal delta)
+uniform samplerBuffer uMorphWeights;  // one weight per slot
+
+// The depth pre-pass runs this shader too (with depth.frag, on the packed position
+// stream at location 0), so the shading pass can test with GL_EQUAL
+invariant gl_Position;
+
+mat4 jointMatrix(uint j){
+    int b = int(j) * 4;
+    return mat4(texelFetch(uJoints, b), texelFetch(uJoints, b + 1), texelFetch(uJoints, b + 2), texelFetch(uJoints, b + 3));
+}
 
 void main(){
-    vec4 worldPos = uModel * vec4(aPos,1.0);
+    vec4 pos = vec4(aPos, 1.0);
+    vec3 nrm = aNormal;
+    vec3 tan = aTangent.xyz;
+    if (uMorphed) {
+        for (uint i = 0u; i < aMorph.y; ++i) {
+            int r = int(aMorph.x + i) * 2;
+            vec4 dp = texelFetch(uMorphDeltas, r);
+            float w = texelFetch(uMorphWeights, int(dp.w)).r;
+            pos.xyz += w * dp.xyz;
+            nrm += w * texelFetch(uMorphDeltas, r + 1).xyz;
+        }
+    }
+    if (uSkinned) {
+        mat4 skin = aWeights.x * jointMatrix(aJoints.x) + aWeights.y * jointMatrix(aJoints.y) +
+                    aWeights.z * jointMatrix(aJoints.z) + aWeights.w * jointMatrix(aJoints.w);
+        pos = skin * pos;
+        nrm = mat3(skin) * nrm;
+        tan = mat3(skin) * tan;
+    }
+    vec4 worldPos = uModel * pos;
     vWorldPos = worldPos.xyz;
-    vNormal   = normalize(uNormalMat * aNormal);
+    vNormal   = normalize(uNormalMat * nrm);
     vCol      = aCol;
     vUV       = aUV;
-    gl_Position = uProj * uView * worldPos;
+    vMaterial = aMaterial;
+    vTangent  = vec4(mat3(uModel) * tan, aTangent.w);
+    gl_Position = uViewProj * worldPos;
 }
@@ -0,0 +1,10 @@
+#version 330 core
+in vec3 vCol;
+out vec4 FragColor;
+
+void main(){
+    // Round points
+    vec2 d = gl_PointCoord - vec2(0.5);
+    if (dot(d, d) > 0.25) discard;
+    FragColor = vec4(vCol, 1.0);
+}
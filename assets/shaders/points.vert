@@ -0,0 +1,19 @@
+#version 330 core
+layout(location=0) in vec3 aPos;
+layout(location=1) in vec4 aCol;
+
+out vec3 vCol;
+
+uniform mat4 uModel;
+uniform mat4 uView;
+uniform mat4 uProj;
+uniform float uPointScale; // pixels per world unit at distance 1
+uniform float uSpacing;    // approximate point spacing of the node, world units
+
+void main(){
+    vec4 viewPos = uView * uModel * vec4(aPos, 1.0);
+    vCol = aCol.rgb;
+    gl_Position = uProj * viewPos;
+    // Size points to close the gaps of their LOD level, within a sane pixel range
+    gl_PointSize = clamp(uSpacing * uPointScale / max(-viewPos.z, 1e-4), 1.0, 6.0);
+}
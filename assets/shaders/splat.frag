@@ -0,0 +1,13 @@
+#version 330 core
+in vec4 vColor;
+in vec2 vPos;
+out vec4 FragColor;
+
+void main(){
+    // Gaussian falloff; vPos is in units of sqrt(2) standard deviations
+    float power = -dot(vPos, vPos);
+    if (power < -4.0) discard;
+    float alpha = exp(power) * vColor.a;
+    if (alpha < 1.0 / 255.0) discard;
+    FragColor = vec4(vColor.rgb, alpha);
+}
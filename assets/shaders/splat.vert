@@ -0,0 +1,76 @@
+#version 330 core
+layout(location=0) in vec2 aCorner;  // quad corner in [-2,2]
+layout(location=1) in uint aIndex;   // splat index, back-to-front order
+
+out vec4 vColor;
+out vec2 vPos;
+
+uniform usampler2D uSplats;  // two RGBA32UI texels per splat
+uniform mat4 uModelView;
+uniform mat4 uProj;
+uniform vec2 uViewport;
+uniform vec2 uFocal;         // focal length in pixels
+
+const int kTexWidth = 4096;
+
+// unpackHalf2x16 needs GLSL 4.20
+float halfToFloat(uint h){
+    uint e = (h >> 10) & 31u;
+    uint m = h & 1023u;
+    float v = (e == 0u) ? float(m) * exp2(-24.0) : (1.0 + float(m) / 1024.0) * exp2(float(e) - 15.0);
+    return ((h & 0x8000u) != 0u) ? -v : v;
+}
+
+vec4 unpackUnorm(uint c){
+    return vec4(float(c & 255u), float((c >> 8) & 255u), float((c >> 16) & 255u), float(c >> 24)) / 255.0;
+}
+
+void main(){
+    int texel = int(aIndex) * 2;
+    uvec4 t0 = texelFetch(uSplats, ivec2(texel % kTexWidth, texel / kTexWidth), 0);
+    uvec4 t1 = texelFetch(uSplats, ivec2((texel + 1) % kTexWidth, (texel + 1) / kTexWidth), 0);
+
+    vec3 center = uintBitsToFloat(t0.xyz);
+    vec4 viewPos = uModelView * vec4(center, 1.0);
+    vec4 clip = uProj * viewPos;
+    float bound = 1.2 * clip.w;
+    if (viewPos.z > -1e-3 || clip.x < -bound || clip.x > bound || clip.y < -bound || clip.y > bound){
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0); // outside the clip volume
+        return;
+    }
+
+    // 3D covariance = R S S^T R^T from scale and rotation (w,x,y,z)
+    vec3 s = vec3(halfToFloat(t1.x & 0xFFFFu), halfToFloat(t1.x >> 16), halfToFloat(t1.y & 0xFFFFu));
+    vec4 q = (unpackUnorm(t1.z) * 255.0 - 128.0) / 128.0;
+    q /= max(length(q), 1e-6);
+    float w = q.x, x = q.y, y = q.z, z = q.w;
+    mat3 R = mat3(
+        1.0 - 2.0 * (y * y + z * z), 2.0 * (x * y + w * z),       2.0 * (x * z - w * y),
+        2.0 * (x * y - w * z),       1.0 - 2.0 * (x * x + z * z), 2.0 * (y * z + w * x),
+        2.0 * (x * z + w * y),       2.0 * (y * z - w * x),       1.0 - 2.0 * (x * x + y * y));
+    mat3 M = R * mat3(s.x, 0.0, 0.0, 0.0, s.y, 0.0, 0.0, 0.0, s.z);
+    mat3 sigma = M * transpose(M);
+
+    // Project with the Jacobian of the perspective divide (EWA splatting)
+    float zv = -viewPos.z;
+    mat3 J = mat3(
+        uFocal.x / zv, 0.0, 0.0,
+        0.0, uFocal.y / zv, 0.0,
+        uFocal.x * viewPos.x / (zv * zv), uFocal.y * viewPos.y / (zv * zv), 0.0);
+    mat3 T = J * mat3(uModelView);
+    mat3 cov = T * sigma * transpose(T);
+
+    // Low-pass filter keeps sub-pixel splats visible
+    float a = cov[0][0] + 0.3, b = cov[0][1], d = cov[1][1] + 0.3;
+    float mid = 0.5 * (a + d);
+    float radius = length(vec2(0.5 * (a - d), b));
+    float l1 = mid + radius, l2 = max(mid - radius, 0.1);
+    vec2 axis = (abs(b) > 1e-6) ? normalize(vec2(b, l1 - a)) : ((a >= d) ? vec2(1.0, 0.0) : vec2(0.0, 1.0));
+    vec2 major = min(sqrt(2.0 * l1), 1024.0) * axis;
+    vec2 minor = min(sqrt(2.0 * l2), 1024.0) * vec2(axis.y, -axis.x);
+
+    vColor = unpackUnorm(t0.w);
+    vPos = aCorner;
+    vec2 ndc = clip.xy / clip.w + (aCorner.x * major + aCorner.y * minor) * 2.0 / uViewport;
+    gl_Position = vec4(ndc, clip.z / clip.w, 1.0);
+}
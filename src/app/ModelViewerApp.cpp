@@ -1,111 +1,57 @@
 #include "app/ModelViewerApp.hpp"
+#include "core/Timer.hpp"
+#include "gfx/GLExt.hpp"
+#include "gfx/ShaderCache.hpp"
 #include <filesystem>
 #include <cctype>
 
-void ModelViewerApp::lazyInitIfNeeded() 
+void ModelViewerApp::initSimulation()
 {
-    if (scene_) return;
+    initialized_ = true;
 
+    // Discover available models; the render side loads the selected one
+    scanModels();
+    if (!modelPaths_.empty()) view_.modelIndex = 0;
+}
+
+void ModelViewerApp::initRenderer(const FrameSnapshot& snap)
+{
+    Timer startup;
     Renderer::Init();
 
-    camera_ = std::make_unique<OrbitCamera>();
-    camera_->setPerspective(glm::radians(60.0f), 1280.0f/720.0f, 0.2f, 200.0f);
-    camera_->setTarget({0,0,0}); 
-    camera_->setRadius(4.0f); 
-    camera_->setYawPitch(0.7f, -0.5f);
+    const float aspect = snap.fbWidth > 0 && snap.fbHeight > 0 ? float(snap.fbWidth) / float(snap.fbHeight) : 1280.0f/720.0f;
+    camera_.setPerspective(glm::radians(60.0f), aspect, 0.2f, 200.0f);
+    camera_.setTarget({0,0,0}); 
+    camera_.setRadius(4.0f); 
+    camera_.setYawPitch(0.7f, -0.5f);
+
+    frame_.init();
 
     grid_ = std::make_unique<GridAxes>(); 
     grid_->init(20, 1.0f);
 
     overlay_.init();
+    oitTargets_.init();
+    sceneTarget_.init();
+    sceneTarget_.setAntialiasing(applied_.aa);
+    queue_.setSceneTarget(&sceneTarget_);
 
     scene_ = std::make_unique<CubeScene>(); 
     scene_->init();
 
-    // Prepare ModelScene and discover available models
-    if (!modelScene_) 
-    {
-        modelScene_ = std::make_unique<ModelScene>();
-        modelScene_->setLighting(true);
-    }
-    scanModels();
-    if (!modelPaths_.empty())
-    {
-        currentModelIndex_ = 0;
-        if (!modelScene_->init(modelPaths_[currentModelIndex_]))
-        {
-            printf("Model load error: %s\n", modelScene_->lastError().c_str());
-        }
-    }
-}
-
-void ModelViewerApp::handleCameraInput(float) 
-{
-    // Orbit drag = Right Mouse
-    static bool orbiting = false; 
-    static double ox = 0, oy = 0;
-
-    double x, y; 
-    Input::GetMousePos(x, y);
-
-    const bool rmb = Input::IsMousePressed(1); // GLFW_MOUSE_BUTT ON_RIGHT
-
-    if (rmb && !orbiting) 
-    { 
-        orbiting=true; 
-        ox=x; 
-        oy=y; 
-    }
-
-    if (!rmb && orbiting)  
-    { 
-        orbiting = false; 
-    }
-    if (orbiting && camera_) 
-    {
-        float dx = float(x - ox), 
-        dy = float(y - oy); 
-        ox = x; 
-        oy = y;
-        // Make horizontal (yaw) drag direction intuitive: left drag -> rotate left
-        camera_->addYawPitch(dx * 0.005f, -dy * 0.005f);
-    }
-
-    // Pan drag = Middle Mouse
-    static bool panning = false; 
-    static double px = 0, py = 0;
-
-    const bool mmb = Input::IsMousePressed(2); // GLFW_MOUSE_BUTTON_MIDDLE
-
-    if (mmb && !panning) 
-    { 
-        panning = true;
-        px = x;
-        py = y; 
-    }
-
-    if (!mmb && panning)  
-    { 
-        panning = false; 
-    }
-
-    if (panning && camera_) 
-    {
-        float dx = float(x - px); 
-        float dy = float(y - py); 
-        px=x; 
-        py=y;
-        camera_->pan(-dx, -dy);
-    }
-
-    // Scroll to zoom
-    double sx = 0, sy = 0; 
-    Input::ConsumeScroll(sx, sy);
-
-    if (camera_ && sy != 0.0) 
-    {
-        camera_->addRadius(float(-sy * 0.25f));
-    }
+    modelScene_ = std::make_unique<ModelScene>();
+    pointScene_ = std::make_unique<PointCloudScene>();
+    splatScene_ = std::make_unique<SplatScene>();
+    renderTime_ = snap.time;
+    // Loads the first model as part of startup
+    applyView(snap.view);
+
+    // Shown under the help text
+    const ShaderCache::Stats& shaders = ShaderCache::GetStats();
+    char status[96];
+    snprintf(status, sizeof(status), "Startup %.0f ms, %d cached / %d compiled", startup.Elapsed() * 1000.0,
+             shaders.loaded, shaders.compiled);
+    overlay_.setStatus(status);
 }
 
 void ModelViewerApp::handleToggles() 
@@ -115,8 +61,7 @@ void ModelViewerApp::handleToggles()
     bool fNow = Input::IsKeyPressed(/*GLFW_KEY_F*/ 70);
     if (fNow && !fPrev) 
     { 
-        wireframe_ = !wireframe_;
-        Renderer::SetWireframe(wireframe_); 
+        view_.wireframe = !view_.wireframe;
     }
     fPrev = fNow;
 
@@ -125,19 +70,16 @@ void ModelViewerApp::handleToggles()
     bool cNow = Input::IsKeyPressed(/*GLFW_KEY_C*/ 67);
     if (cNow && !cPrev) 
     { 
-        cull_ = !cull_; 
-        Renderer::SetCull(cull_); 
+        view_.cull = !view_.cull;
     }
     cPrev = cNow;
 
     // R = reset camera
     static bool rPrev = false; 
     bool rNow = Input::IsKeyPressed(/*GLFW_KEY_R*/ 82);
-    if (rNow && !rPrev && camera_) 
+    if (rNow && !rPrev) 
     {
-        camera_->setTarget({0, 0, 0}); 
-        camera_->setRadius(4.0f); 
-        camera_->setYawPitch(0.7f, 0.5f);
+        ++view_.cameraResets;
     } 
 
     // L = lighting toggle
@@ -145,9 +87,7 @@ void ModelViewerApp::handleToggles()
     bool lNow = Input::IsKeyPressed(/*GLFW_KEY_L*/ 76);
     if (lNow && !lPrev) 
     {
-        lighting_ = !lighting_;
-        if (scene_) { scene_->setLighting(lighting_); }
-        if (modelScene_) { modelScene_->setLighting(lighting_); }
+        view_.lighting = !view_.lighting;
     }
 
     // M = toggle ModelScene/CubeScene
@@ -155,35 +95,95 @@ void ModelViewerApp::handleToggles()
     bool mNow = Input::IsKeyPressed(/*GLFW_KEY_M*/ 77);
     if (mNow && !mPrev) 
     {
-        showModel_ = !showModel_;
-        if (camera_) 
-        {
-            camera_->setTarget({0, 0, 0});
-        }
+        view_.showModel = !view_.showModel;
+        ++view_.cameraRecenters;
     }
     rPrev = rNow;
 
     // H = help toggle
     static bool hPrev = false;
     bool hNow = Input::IsKeyPressed(/*GLFW_KEY_H*/ 72);
-    if (hNow && !hPrev) { showHelp_ = !showHelp_; }
+    if (hNow && !hPrev) { view_.showHelp = !view_.showHelp; }
     hPrev = hNow;
 
-    // A = MSAA toggle
+    // A = cycle antialiasing: off, MSAA 2/4/8x, FXAA, temporal
     static bool aPrev = false;
     bool aNow = Input::IsKeyPressed(/*GLFW_KEY_A*/ 65);
     if (aNow && !aPrev)
     {
-        msaa_ = !msaa_;
-        Renderer::SetMSAA(msaa_);
+        using AA = DynamicResolution::Antialiasing;
+        view_.aa = view_.aa == AA::Temporal ? AA::Off : AA(int(view_.aa) + 1);
     }
     aPrev = aNow;
 
+    // B = texture-array batching for meshes
+    static bool bPrev = false;
+    bool bNow = Input::IsKeyPressed(/*GLFW_KEY_B*/ 66);
+    if (bNow && !bPrev)
+    {
+        view_.batched = !view_.batched;
+    }
+    bPrev = bNow;
+
+    // G = GPU-driven culling and multi-draw indirect (GL 4.3+)
+    static bool gPrev = false;
+    bool gNow = Input::IsKeyPressed(/*GLFW_KEY_G*/ 71);
+    if (gNow && !gPrev)
+    {
+        view_.gpuDriven = !view_.gpuDriven;
+    }
+    gPrev = gNow;
+
+    // O = CPU occlusion culling for meshes
+    static bool oPrev = false;
+    bool oNow = Input::IsKeyPressed(/*GLFW_KEY_O*/ 79);
+    if (oNow && !oPrev)
+    {
+        view_.occlusion = !view_.occlusion;
+    }
+    oPrev = oNow;
+
+    // Q = hardware occlusion queries for meshes
+    static bool qPrev = false;
+    bool qNow = Input::IsKeyPressed(/*GLFW_KEY_Q*/ 81);
+    if (qNow && !qPrev)
+    {
+        view_.queries = !view_.queries;
+    }
+    qPrev = qNow;
+
+    // T = weighted blended order-independent transparency
+    static bool tPrev = false;
+    bool tNow = Input::IsKeyPressed(/*GLFW_KEY_T*/ 84);
+    if (tNow && !tPrev)
+    {
+        view_.oit = !view_.oit;
+    }
+    tPrev = tNow;
+
+    // E = event-driven (on-demand) rendering; continuous is for benchmarks
+    static bool ePrev = false;
+    bool eNow = Input::IsKeyPressed(/*GLFW_KEY_E*/ 69);
+    if (eNow && !ePrev)
+    {
+        SetRenderMode(GetRenderMode() == RenderMode::OnDemand ? RenderMode::Continuous : RenderMode::OnDemand);
+    }
+    ePrev = eNow;
+
+    // Z = depth pre-pass for the current mesh (compare the GPU time in the title)
+    static bool zPrev = false;
+    bool zNow = Input::IsKeyPressed(/*GLFW_KEY_Z*/ 90);
+    if (zNow && !zPrev)
+    {
+        ++view_.prepassToggles;
+    }
+    zPrev = zNow;
+
     // Arrow keys: Left/Right to cycle models when in Model mode
     static bool leftPrev = false, rightPrev = false;
     bool leftNow = Input::IsKeyPressed(263);  // GLFW_KEY_LEFT
     bool rightNow = Input::IsKeyPressed(262); // GLFW_KEY_RIGHT
-    if (showModel_ && !modelPaths_.empty() && modelScene_)
+    if (view_.showModel && !modelPaths_.empty())
     {
         if (leftNow && !leftPrev) { switchModel(-1); }
         if (rightNow && !rightPrev) { switchModel(+1); }
@@ -192,93 +192,352 @@ void ModelViewerApp::handleToggles()
     rightPrev = rightNow;
 }
 
-void ModelViewerApp::OnUpdate(double dt) 
+void ModelViewerApp::updateTitle(double dt, const RenderStats& stats)
 {
     accum_ += dt; 
-    frames_++;
+    if (accum_ < 0.3) return;
 
-    if (accum_ >= 0.3) 
+    char buf[256];
+    const double fps = double(stats.frames - titleFrames_) / accum_;
+    const char* mode = UsesRenderThread() ? "Thr " : "";
+    if (view_.showModel && view_.modelIndex >= 0 && view_.modelIndex < (int)modelPaths_.size())
     {
-        char buf[128]; const double fps = frames_ / accum_;
-
-        if (showModel_ && currentModelIndex_ >= 0 && currentModelIndex_ < (int)modelPaths_.size())
+        // Show current model file name
+        const char* file = modelPaths_[view_.modelIndex].c_str();
+        if (stats.kind == ModelKind::Splats && stats.hasModel)
         {
-            // Show current model file name
-            const char* file = modelPaths_[currentModelIndex_].c_str();
             snprintf(buf, sizeof(buf),
-                "OpenGL — Model | %.1f FPS [%s%s%s] — %s",
+                "OpenGL — Splats | %.1f FPS, lat %.1f ms [%.2fM splats, sort %.1f ms] — %s",
                 fps,
-                wireframe_ ? "WF " : "",
-                cull_      ? "Cull " : "",
-                lighting_  ? "Light" : "NoLight",
+                stats.latencyMs,
+                stats.splats / 1e6,
+                stats.splatSortMs,
+                file);
+        }
+        else if (stats.kind == ModelKind::Points && stats.hasModel)
+        {
+            snprintf(buf, sizeof(buf),
+                "OpenGL — Points | %.1f FPS, lat %.1f ms [%.1fM / %.1fM pts, %zu nodes] — %s",
+                fps,
+                stats.latencyMs,
+                stats.pointsDrawn / 1e6,
+                stats.totalPoints / 1e6,
+                stats.residentNodes,
                 file);
         }
         else
         {
             snprintf(buf, sizeof(buf),
-                "OpenGL — Cube (Orbit) | %.1f FPS  [%s%s%s]",
+                "OpenGL — Model | %.1f FPS, lat %.1f ms [%d/%d draws, %zu pkts sort %.2f ms, GPU %.2f ms, res %d%% %s %s%s%s%s%s%s%s%s%s%s%s] — %s",
                 fps,
-                wireframe_ ? "WF " : "",
-                cull_      ? "Cull " : "",
-                lighting_  ? "Light" : "NoLight");
+                stats.latencyMs,
+                stats.visibleDraws,
+                stats.drawCount,
+                stats.packets,
+                stats.sortMs,
+                stats.gpuMs,
+                (int)(stats.scale * 100.0f + 0.5f),
+                DynamicResolution::Name(view_.aa),
+                view_.wireframe ? "WF " : "",
+                view_.cull      ? "Cull " : "",
+                stats.batched   ? "Batch " : "",
+                stats.gpuDriven ? "GPU " : "",
+                stats.occlusion ? "Occl " : "",
+                stats.queries   ? "Query " : "",
+                view_.oit       ? "OIT " : "",
+                stats.prepass   ? "ZPre " : "",
+                GetRenderMode() == RenderMode::Continuous ? "Cont " : "",
+                mode,
+                view_.lighting  ? "Light" : "NoLight",
+                file);
         }
-
-        m_Window->SetTitle(buf); 
-        accum_ = 0.0; 
-        frames_ = 0;
     }
+    else
+    {
+        snprintf(buf, sizeof(buf),
+            "OpenGL — Cube (Orbit) | %.1f FPS, lat %.1f ms  [%s %s%s%s%s%s]",
+            fps,
+            stats.latencyMs,
+            DynamicResolution::Name(view_.aa),
+            GetRenderMode() == RenderMode::Continuous ? "Cont " : "",
+            mode,
+            view_.wireframe ? "WF " : "",
+            view_.cull      ? "Cull " : "",
+            view_.lighting  ? "Light" : "NoLight");
+    }
+
+    m_Window->SetTitle(buf); 
+    accum_ = 0.0; 
+    titleFrames_ = stats.frames;
+}
+
+void ModelViewerApp::OnUpdate(double dt) 
+{
+    if (!initialized_) initSimulation();
+    time_ += dt;
+
+    // Results of the newest rendered frame (one behind with the render thread)
+    stats_.Acquire();
+    const RenderStats& stats = stats_.Front();
+    updateTitle(dt, stats);
 
-    lazyInitIfNeeded();
-    handleCameraInput((float)dt);
     handleToggles();
+    if (view_.showModel && stats.kind == ModelKind::Mesh) checkForReload(stats);
+
+    // In on-demand mode, keep drawing while the picture changes without input, a drag
+    // is being refined or the temporal history converges
+    if (stats.redraw) RequestRedraw();
+
+    // Temporal AA averages jittered frames of an unchanged picture until it converges
+    if (stats.changing || m_Window->EventCount() != historyEvents_) ++view_.historyResets;
+    historyEvents_ = m_Window->EventCount();
+}
 
-    if (scene_) 
+void ModelViewerApp::OnPublish()
+{
+    FrameSnapshot& snap = snapshots_.Back();
+    snap.view = view_;
+    snap.time = time_;
+    m_Window->GetFramebufferSize(snap.fbWidth, snap.fbHeight);
+    snapshots_.Publish();
+}
+
+void ModelViewerApp::checkForReload(const RenderStats& stats)
+{
+    // Every (re)load reports its files; exporters may add or drop external ones
+    if (stats.sourcesSerial != watchedSerial_)
     {
-        scene_->update((float)dt);
+        watcher_.Watch(stats.sources);
+        watchedSerial_ = stats.sourcesSerial;
     }
+    if (watcher_.Poll().empty()) return;
+    ++view_.reloads;
+    RequestRedraw();
 }
 
-void ModelViewerApp::OnRender() 
+void ModelViewerApp::applyView(const ViewState& view)
 {
-    // Lighter background (soft gray)
-    Renderer::Clear(0.6196f, 0.5255f, 0.5255f, 1.0f);
-    if (grid_ && camera_) 
+    if (view.cull != applied_.cull) Renderer::SetCull(view.cull);
+    if (view.aa != applied_.aa) sceneTarget_.setAntialiasing(view.aa);
+    if (view.oit != applied_.oit) queue_.setOit(view.oit ? &oitTargets_ : nullptr);
+    if (view.modelIndex != applied_.modelIndex && view.modelIndex >= 0) loadModelAt(view.modelIndex);
+
+    if (view.batched != applied_.batched)
     {
-        grid_->render(*camera_);
+        modelScene_->setBatched(view.batched);
+        const Model* model = modelScene_->model();
+        if (view.batched && model && !model->canBatch())
+            printf("Batching unavailable for this model (more than %d texture sizes)\n", Model::kBatchArrays);
     }
+    if (view.gpuDriven != applied_.gpuDriven)
+    {
+        if (view.gpuDriven && !GLExt::HasComputeIndirect())
+            printf("GPU-driven path needs OpenGL 4.3 (context is %d.%d)\n", GLExt::Version() / 10, GLExt::Version() % 10);
+        modelScene_->setGpuDriven(view.gpuDriven);
+    }
+    if (view.occlusion != applied_.occlusion) modelScene_->setOcclusionCulling(view.occlusion);
+    if (view.queries != applied_.queries) modelScene_->setOcclusionQueries(view.queries);
+    // Z presses since the last frame; an even count cancels out
+    if (((view.prepassToggles - applied_.prepassToggles) & 1u) && modelScene_->model())
+        modelScene_->setDepthPrepass(!modelScene_->model()->depthPrepass());
 
-    if (showModel_) 
+    if (view.reloads != applied_.reloads && currentKind_ == ModelKind::Mesh && view.modelIndex >= 0)
     {
-        if (modelScene_ && camera_) 
+        Timer t;
+        if (!modelScene_->reload())
         {
-            modelScene_->render(*camera_);
+            printf("Reload failed (keeping previous model): %s\n", modelScene_->lastError().c_str());
         }
-    } 
-    else 
+        else
+        {
+            const Model::ReloadStats& st = modelScene_->model()->lastReload();
+            printf("Reloaded %s in %.1f ms (%s; %d/%d primitives, %d/%d textures uploaded)\n",
+                modelPaths_[view.modelIndex].c_str(), t.Elapsed() * 1000.0,
+                st.incremental ? "incremental" : "full",
+                st.drawsUploaded, st.drawsTotal, st.texturesUploaded, st.texturesTotal);
+            ++sourcesSerial_;
+        }
+    }
+    if (view.historyResets != applied_.historyResets) sceneTarget_.resetHistory();
+    if (view.cameraResets != applied_.cameraResets)
+    {
+        camera_.setTarget({0, 0, 0}); 
+        camera_.setRadius(4.0f); 
+        camera_.setYawPitch(0.7f, 0.5f);
+    }
+    if (view.cameraRecenters != applied_.cameraRecenters) camera_.setTarget({0, 0, 0});
+    applied_ = view;
+}
+
+double ModelViewerApp::latchCamera()
+{
+    // Every pointer event since the last frame, in order; the oldest one that moved the
+    // camera dates what this frame shows
+    double oldest = 0.0;
+    bool zoomed = false;
+    InputEvent e;
+    while (Input::Events().Pop(e))
     {
-        if (scene_ && camera_) 
+        bool moved = false;
+        if (e.type == InputEvent::Type::Button)
         {
-            scene_->render(*camera_);
+            if (e.button == 1) orbiting_ = e.pressed; // GLFW_MOUSE_BUTTON_RIGHT
+            if (e.button == 2) panning_ = e.pressed;  // GLFW_MOUSE_BUTTON_MIDDLE
         }
+        else if (e.type == InputEvent::Type::Move)
+        {
+            const float dx = float(e.x - mouseX_);
+            const float dy = float(e.y - mouseY_);
+            // Orbit drag = Right Mouse. Horizontal drag direction is intuitive: dragging
+            // left rotates left
+            if (orbiting_) camera_.addYawPitch(dx * 0.005f, -dy * 0.005f);
+            // Pan drag = Middle Mouse
+            if (panning_) camera_.pan(-dx, -dy);
+            moved = orbiting_ || panning_;
+        }
+        else if (e.y != 0.0)
+        {
+            // Scroll to zoom
+            camera_.addRadius(float(-e.y * 0.25f));
+            moved = zoomed = true;
+        }
+        if (e.type != InputEvent::Type::Scroll) { mouseX_ = e.x; mouseY_ = e.y; }
+        if (moved && oldest == 0.0) oldest = e.time;
     }
+    // Dragging trades resolution and MSAA for frame rate (see DynamicResolution)
+    interacting_ = orbiting_ || panning_ || zoomed;
+    return oldest;
+}
 
-    // Help overlay
-    if (showHelp_)
+void ModelViewerApp::publishStats(bool changing, bool redraw)
+{
+    RenderStats& st = stats_.Back();
+    st.frames = framesRendered_;
+    st.changing = changing;
+    st.redraw = redraw;
+    st.kind = currentKind_;
+
+    const Model* model = modelScene_->model();
+    const PointCloud* cloud = pointScene_->cloud();
+    const SplatCloud* splats = splatScene_->splats();
+    st.hasModel = currentKind_ == ModelKind::Splats ? splats != nullptr
+                : currentKind_ == ModelKind::Points ? cloud != nullptr : model != nullptr;
+    st.visibleDraws = model ? model->visibleDraws() : 0;
+    st.drawCount = model ? model->drawCount() : 0;
+    st.packets = queue_.size();
+    st.sortMs = queue_.lastSortMs();
+    st.gpuMs = queue_.lastGpuMs();
+    st.scale = sceneTarget_.scale();
+    st.batched = model && model->batched();
+    st.gpuDriven = model && model->gpuDriven();
+    st.occlusion = model && model->occlusionCulling();
+    st.queries = model && model->occlusionQueries();
+    st.prepass = model && model->depthPrepass();
+    st.splats = splats ? splats->count() : 0;
+    st.splatSortMs = splats ? splats->lastSortMs() : 0.0;
+    st.pointsDrawn = cloud ? cloud->pointsDrawn() : 0;
+    st.totalPoints = cloud ? cloud->totalPoints() : 0;
+    st.residentNodes = cloud ? cloud->residentNodes() : 0;
+    st.latencyMs = pacer_.latencyMs();
+    // Slots are recycled, so each keeps its own copy and refreshes it only after a load
+    if (st.sourcesSerial != sourcesSerial_)
     {
-        int fbw=0, fbh=0; m_Window->GetFramebufferSize(fbw, fbh);
-        overlay_.renderHelp(fbw, fbh, showModel_);
+        st.sources = currentKind_ == ModelKind::Mesh ? modelScene_->sourceFiles() : std::vector<std::string>();
+        st.sourcesSerial = sourcesSerial_;
     }
+    stats_.Publish();
 }
 
-void ModelViewerApp::OnResize(int w, int h) 
+void ModelViewerApp::OnRender() 
 {
-    if (w <= 0 || h <= 0) return;
-    
-    glViewport(0, 0, w, h);
-    if (camera_) 
+    // The newest snapshot; frames the render side fell behind on are skipped
+    snapshots_.Acquire();
+    const FrameSnapshot& snap = snapshots_.Front();
+    if (!scene_) initRenderer(snap);
+    const double dt = snap.time - renderTime_;
+    renderTime_ = snap.time;
+    applyView(snap.view);
+    const ViewState& view = applied_;
+
+    // Keep at most FramePacer::kMaxFramesInFlight frames queued, so the camera latched
+    // below is not shown behind a backlog the driver buffered
+    pacer_.begin();
+    scene_->update((float)dt);
+    if (view.showModel && currentKind_ == ModelKind::Mesh) modelScene_->update((float)dt);
+
+    const Model* model = modelScene_->model();
+    const PointCloud* cloud = pointScene_->cloud();
+    const SplatCloud* splats = splatScene_->splats();
+    bool changing = !view.showModel; // the cube spins
+    if (view.showModel && currentKind_ == ModelKind::Mesh) changing = model && model->animation() >= 0;
+    if (view.showModel && currentKind_ == ModelKind::Points) changing = cloud && cloud->streaming();
+    if (view.showModel && currentKind_ == ModelKind::Splats) changing = splats && splats->sortPending();
+
+    // Latch the camera as late as possible: everything below draws with it
+    PumpEvents();
+    const double inputTime = latchCamera();
+    // Refining after a drag needs more frames even though no input arrives
+    const bool refine = sceneTarget_.update(queue_.lastGpuMs(), interacting_, dt) || !sceneTarget_.refined();
+
+    // The scene renders into the scaled target; the overlay goes to the window
+    const int fbw = snap.fbWidth, fbh = snap.fbHeight;
+    sceneTarget_.begin(fbw, fbh);
+    if (fbw > 0 && fbh > 0) camera_.setAspect(float(fbw) / float(fbh));
+    renderCamera_ = camera_;
+    renderCamera_.setJitter(sceneTarget_.jitter());
+
+    // Lighter background (soft gray)
+    Renderer::Clear(0.6196f, 0.5255f, 0.5255f, 1.0f);
+
+    // Camera and lighting for every program, written once per frame
+    FrameUniforms::Lighting lighting;
+    lighting.useLighting = view.lighting;
+    // Environment lighting brightens and adds reflections to loaded meshes
+    lighting.useEnv = view.showModel && currentKind_ == ModelKind::Mesh;
+    lighting.envIntensity = view.lighting ? 0.75f : 0.50f;
+    // Edges keep their on-screen width while the scene renders scaled
+    lighting.wireWidth = 1.5f * sceneTarget_.scale();
+    frame_.update(renderCamera_, lighting);
+    // The same switches pick the phong variant, so unlit frames skip the lighting code
+    // and only wireframe frames run the geometry stage
+    uint32_t phongFeatures = 0;
+    if (lighting.useLighting) phongFeatures |= Phong::Lighting | (lighting.useEnv ? Phong::Environment : 0u);
+    if (view.wireframe) phongFeatures |= Phong::Wireframe;
+
+    // Every scene records packets; the queue sorts them by pass, state and depth
+    queue_.clear();
+    grid_->submit(queue_);
+
+    if (view.showModel) 
     {
-        camera_->setAspect(float(w) / float(h));
+        if (currentKind_ == ModelKind::Splats)
+        {
+            splatScene_->submit(queue_, renderCamera_, sceneTarget_.width(), sceneTarget_.height());
+        }
+        else if (currentKind_ == ModelKind::Points)
+        {
+            pointScene_->submit(queue_, renderCamera_, sceneTarget_.height());
+        }
+        else
+        {
+            modelScene_->submit(queue_, renderCamera_, phongFeatures);
+        }
     } 
+    else 
+    {
+        scene_->submit(queue_, renderCamera_, phongFeatures);
+    }
+
+    // Help overlay
+    if (view.showHelp)
+    {
+        overlay_.submitHelp(queue_, fbw, fbh, view.showModel);
+    }
+    queue_.execute();
+    pacer_.end(inputTime);
+    ++framesRendered_;
+
+    publishStats(changing, changing || refine || sceneTarget_.converging());
 }
 
 void ModelViewerApp::scanModels()
@@ -294,7 +553,8 @@ void ModelViewerApp::scanModels()
             path p = entry.path();
             auto ext = p.extension().string();
             for (auto& c : ext) c = (char)tolower((unsigned char)c);
-            if (ext == ".gltf" || ext == ".glb")
+            if (ext == ".gltf" || ext == ".glb" || ext == ".obj" || ext == ".stl" ||
+                ext == ".ply" || ext == ".las" || ext == ".splat")
             {
                 modelPaths_.push_back(p.string());
             }
@@ -305,14 +565,50 @@ void ModelViewerApp::scanModels()
 
 void ModelViewerApp::switchModel(int dir)
 {
-    if (modelPaths_.empty() || !modelScene_) return;
-    if (currentModelIndex_ < 0) currentModelIndex_ = 0;
+    if (modelPaths_.empty()) return;
     const int n = (int)modelPaths_.size();
-    currentModelIndex_ = (currentModelIndex_ + dir) % n;
-    if (currentModelIndex_ < 0) currentModelIndex_ += n;
-    const std::string& path = modelPaths_[currentModelIndex_];
+    int index = view_.modelIndex < 0 ? 0 : view_.modelIndex;
+    index = (index + dir) % n;
+    if (index < 0) index += n;
+    view_.modelIndex = index;
+}
+
+ModelViewerApp::ModelKind ModelViewerApp::kindOf(const std::string& path)
+{
+    auto ext = std::filesystem::path(path).extension().string();
+    for (auto& c : ext) c = (char)tolower((unsigned char)c);
+    if (ext == ".splat") return ModelKind::Splats;
+    if (ext == ".ply") return SplatCloud::IsSplatPly(path) ? ModelKind::Splats : ModelKind::Points;
+    return (ext == ".las") ? ModelKind::Points : ModelKind::Mesh;
+}
+
+bool ModelViewerApp::loadModelAt(int index)
+{
+    const std::string& path = modelPaths_[index];
+    currentKind_ = kindOf(path);
+    ++sourcesSerial_; // the watched files change with the model
+    if (currentKind_ == ModelKind::Splats)
+    {
+        if (!splatScene_->load(path))
+        {
+            printf("Splat load error: %s\n", splatScene_->lastError().c_str());
+            return false;
+        }
+        return true;
+    }
+    if (currentKind_ == ModelKind::Points)
+    {
+        if (!pointScene_->load(path))
+        {
+            printf("Point cloud load error: %s\n", pointScene_->lastError().c_str());
+            return false;
+        }
+        return true;
+    }
     if (!modelScene_->load(path))
     {
         printf("Model load error: %s\n", modelScene_->lastError().c_str());
+        return false;
     }
+    return true;
 }
@@ -3,11 +3,20 @@
 #include "core/Application.hpp"
 #include "gfx/Renderer.hpp"
 #include "gfx/GridAxes.hpp"
+#include "gfx/UniformBuffers.hpp"
+#include "gfx/RenderQueue.hpp"
+#include "gfx/WeightedOit.hpp"
+#include "gfx/DynamicResolution.hpp"
+#include "gfx/FramePacer.hpp"
 #include "core/Camera.hpp"
 #include "core/OrbitCamera.hpp"
 #include "core/Input.hpp"
+#include "core/FileWatcher.hpp"
+#include "core/TripleBuffer.hpp"
 #include "scenes/CubeScene.hpp"
 #include "scenes/ModelScene.hpp"
+#include "scenes/PointCloudScene.hpp"
+#include "scenes/SplatScene.hpp"
 
 #include <glm/gtc/constants.hpp>
 #include <glm/gtc/matrix_transform.hpp> 
@@ -29,33 +38,112 @@ public:
 
 protected:
     void OnUpdate(double dt) override;
+    void OnPublish() override;
     void OnRender() override;
-    void OnResize(int w, int h) override;
 
 private:
-    void lazyInitIfNeeded();
-    void handleCameraInput(float dt);
+    // Point clouds, splats and meshes live in different scenes; route by file type
+    enum class ModelKind { Mesh, Points, Splats };
+    static ModelKind kindOf(const std::string& path);
+
+    // What the user asked for; owned by the main thread and applied by the render side.
+    // One-shot requests are counters so none is lost when frames are skipped.
+    struct ViewState {
+        bool wireframe = false;
+        bool cull = false;
+        bool lighting = true;
+        bool showModel = false;
+        bool showHelp = true;
+        DynamicResolution::Antialiasing aa = DynamicResolution::Antialiasing::Msaa4;
+        bool batched = false;
+        bool gpuDriven = false;
+        bool occlusion = false;
+        bool queries = false;
+        bool oit = false;
+        int modelIndex = -1;          // into modelPaths_
+        uint32_t prepassToggles = 0;  // Z presses
+        uint32_t reloads = 0;         // settled changes of the current mesh's files
+        uint32_t historyResets = 0;   // temporal AA restarts
+        uint32_t cameraResets = 0;    // R presses
+        uint32_t cameraRecenters = 0; // scene switches re-target the origin
+    };
+    // Immutable input of one frame, main thread -> OnRender
+    struct FrameSnapshot {
+        ViewState view;
+        double time = 0.0;            // simulation clock; scenes animate by its steps
+        int fbWidth = 0, fbHeight = 0;
+    };
+    // Results of the last rendered frame, render side -> main thread (title, redraws)
+    struct RenderStats {
+        uint64_t frames = 0;          // rendered so far
+        bool changing = false;        // the picture changes without input
+        bool redraw = false;          // ... or needs more frames to refine/converge
+        ModelKind kind = ModelKind::Mesh;
+        bool hasModel = false;
+        int visibleDraws = 0, drawCount = 0;
+        size_t packets = 0;
+        double sortMs = 0.0, gpuMs = 0.0;
+        float scale = 1.0f;
+        bool batched = false, gpuDriven = false, occlusion = false, queries = false, prepass = false;
+        size_t splats = 0;
+        double splatSortMs = 0.0;
+        uint64_t pointsDrawn = 0, totalPoints = 0;
+        size_t residentNodes = 0;
+        double latencyMs = 0.0;       // input to photon, see FramePacer
+        uint32_t sourcesSerial = 0;   // bumped by every mesh (re)load
+        std::vector<std::string> sources; // files of the current mesh, for the watcher
+    };
+
+    // Main thread: toggles, model list and reloads. Pointer input goes straight to the
+    // render side's camera through Input::Events().
+    void initSimulation();
     void handleToggles();
     void scanModels();
     void switchModel(int dir);
+    void updateTitle(double dt, const RenderStats& stats);
+    void checkForReload(const RenderStats& stats);
+
+    bool initialized_ = false;
+    ViewState view_;
+    double time_ = 0.0;
+    double accum_ = 0.0;
+    uint64_t titleFrames_ = 0;    // stats.frames at the last title update
+    uint64_t historyEvents_ = 0;  // window events seen by the temporal AA history
+    std::vector<std::string> modelPaths_; // fixed after initSimulation()
+    // Hot reload of the current mesh when its files change on disk
+    FileWatcher watcher_;
+    uint32_t watchedSerial_ = 0;
+
+    TripleBuffer<FrameSnapshot> snapshots_;
+    TripleBuffer<RenderStats> stats_;
+
+    // Render side: owns every GL object
+    void initRenderer(const FrameSnapshot& snap);
+    void applyView(const ViewState& view);
+    double latchCamera();
+    bool loadModelAt(int index);
+    void publishStats(bool changing, bool redraw);
 
     std::unique_ptr<CubeScene> scene_;
     std::unique_ptr<GridAxes> grid_;
-    std::unique_ptr<OrbitCamera> camera_;
+    FrameUniforms frame_;
+    RenderQueue queue_;           // rebuilt every frame by the scenes
+    WeightedOit oitTargets_;      // used by the queue while oit is on
+    DynamicResolution sceneTarget_; // scaled scene render, upscaled before the overlay
+    FramePacer pacer_;            // frames in flight and input latency
+    OrbitCamera camera_;          // latched from pointer events right before drawing
+    OrbitCamera renderCamera_;    // camera_ plus this frame's jitter
+    bool orbiting_ = false, panning_ = false;
+    bool interacting_ = false;    // camera dragged or zoomed this frame
+    double mouseX_ = 0.0, mouseY_ = 0.0;
     std::unique_ptr<ModelScene> modelScene_;
-
-    double accum_ = 0.0; 
-    int frames_ = 0;
-
-    bool wireframe_ = false;
-    bool cull_ = false;
-    bool lighting_ = true;
-    bool showModel_ = false;
-    bool showHelp_ = true;
-    bool msaa_ = true;
+    std::unique_ptr<PointCloudScene> pointScene_;
+    std::unique_ptr<SplatScene> splatScene_;
+    ModelKind currentKind_ = ModelKind::Mesh;
+    ViewState applied_;           // state the GL side currently reflects
+    double renderTime_ = 0.0;
+    uint64_t framesRendered_ = 0;
+    uint32_t sourcesSerial_ = 0;
 
     TextOverlay overlay_;
-
-    std::vector<std::string> modelPaths_;
-    int currentModelIndex_ = -1;
 };
@@ -1,10 +1,17 @@
 #include "core/Application.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 Application::Application(std::unique_ptr<IWindow> window)
     : m_Window(std::move(window)) {}
 
 int Application::Run()
 {
+    if (m_RenderThread) return runThreaded();
+
     Timer timer;
 
     glEnable(GL_DEPTH_TEST);
@@ -12,6 +19,8 @@ int Application::Run()
     int fbw = 0, fbh = 0;
     m_Window->GetFramebufferSize(fbw, fbh);
     OnResize(fbw, fbh);
+    uint64_t eventsSeen = m_Window->EventCount();
+    m_PendingFrames = kSettleFrames;
 
     while (!m_Window->ShouldClose())
     {
@@ -27,13 +36,122 @@ int Application::Run()
             OnResize(fbw, fbh);
         }
 
+        if (m_Window->EventCount() != eventsSeen)
+        {
+            eventsSeen = m_Window->EventCount();
+            m_PendingFrames = kSettleFrames;
+        }
+
+        OnUpdate(dt);
+
+        const bool render = m_Mode == RenderMode::Continuous || m_PendingFrames > 0;
+        if (render)
+        {
+            if (m_PendingFrames > 0) --m_PendingFrames;
+            OnPublish();
+            OnRender();
+            m_Window->SwapBuffers();
+        }
+
+        // Nothing to draw: sleep until input or the next housekeeping tick
+        if (m_Mode == RenderMode::Continuous || m_PendingFrames > 0)
+            m_Window->PollEvents();
+        else
+            m_Window->WaitEvents(kIdleWait);
+    }
+
+    return 0;
+}
+
+int Application::runThreaded()
+{
+    Timer timer;
+
+    glEnable(GL_DEPTH_TEST);
+
+    int fbw = 0, fbh = 0;
+    m_Window->GetFramebufferSize(fbw, fbh);
+    OnResize(fbw, fbh);
+    uint64_t eventsSeen = m_Window->EventCount();
+    m_PendingFrames = kSettleFrames;
+
+    // Only scheduling goes through the lock; frame data travels in what OnPublish hands over
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<uint64_t> published{0}, taken{0};
+    bool quit = false;
+
+    m_Window->MakeContextCurrent(false);
+    std::thread renderThread([&]
+    {
+        m_Window->MakeContextCurrent(true);
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&] { return quit || taken != published; });
+                if (quit) break;
+                taken = published.load();
+            }
+            // Wake the main thread for the next update
+            m_Window->PostEmptyEvent();
+            OnRender();
+            m_Window->SwapBuffers();
+            // Results of this frame may ask for another one (see RequestRedraw)
+            m_Window->PostEmptyEvent();
+        }
+        m_Window->MakeContextCurrent(false);
+    });
+
+    while (!m_Window->ShouldClose())
+    {
+        double dt = timer.Tick();
+
+        int w = 0, h = 0;
+        m_Window->GetFramebufferSize(w, h);
+        if (w != fbw || h != fbh)
+        {
+            fbw = w; fbh = h;
+            OnResize(fbw, fbh);
+        }
+
+        if (m_Window->EventCount() != eventsSeen)
+        {
+            eventsSeen = m_Window->EventCount();
+            m_PendingFrames = kSettleFrames;
+        }
+
         OnUpdate(dt);
 
-        OnRender();
+        const bool render = m_Mode == RenderMode::Continuous || m_PendingFrames > 0;
+        if (render)
+        {
+            if (m_PendingFrames > 0) --m_PendingFrames;
+            OnPublish();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++published;
+            }
+            cv.notify_all();
+            // Stay at most one frame ahead: the next update overlaps this frame's submission.
+            // Keep pumping events meanwhile; the render thread latches them into the camera.
+            while (taken != published && !m_Window->ShouldClose())
+                m_Window->WaitEvents(kIdleWait);
+        }
 
-        m_Window->SwapBuffers();
-        m_Window->PollEvents();
+        if (m_Mode == RenderMode::Continuous || m_PendingFrames > 0)
+            m_Window->PollEvents();
+        else
+            m_Window->WaitEvents(kIdleWait);
     }
 
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    cv.notify_all();
+    renderThread.join();
+    // GL objects are released by destructors on this thread
+    m_Window->MakeContextCurrent(true);
     return 0;
 }
\ No newline at end of file
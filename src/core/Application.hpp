@@ -15,11 +15,50 @@ public:
 
     int Run();
 
+    // Continuous renders every frame (spinning scenes, benchmarks). OnDemand blocks
+    // waiting for events and only renders after input, a resize or RequestRedraw();
+    // OnUpdate still runs at least every kIdleWait seconds while idle.
+    enum class RenderMode { Continuous, OnDemand };
+    void SetRenderMode(RenderMode mode) { m_Mode = mode; }
+    RenderMode GetRenderMode() const { return m_Mode; }
+
+    // Render the next frame in OnDemand mode (animation, async loads or uploads in flight)
+    void RequestRedraw() { if (m_PendingFrames < 1) m_PendingFrames = 1; }
+
+    // Threaded mode: a render thread owns the GL context and runs OnRender (and the swap)
+    // while the main thread handles events, OnUpdate and OnPublish for the next frame,
+    // at most one frame ahead. Frame state must reach OnRender through what OnPublish
+    // hands over; OnUpdate may not touch GL. Choose before Run().
+    void SetRenderThread(bool on) { m_RenderThread = on; }
+    bool UsesRenderThread() const { return m_RenderThread; }
+
+    static constexpr double kIdleWait = 0.25;
+    // Frames rendered after each event, so results read a frame or two late
+    // (occlusion queries, GPU timers) catch up before the loop goes idle
+    static constexpr int kSettleFrames = 3;
+
 protected:
+    // Main thread, every loop iteration
     virtual void OnUpdate(double /*dt*/) {}
+    // Main thread, once per frame to render, right before OnRender is scheduled
+    virtual void OnPublish() {}
+    // Render thread in threaded mode, otherwise the main thread
     virtual void OnRender() {}
+    // Main thread
     virtual void OnResize(int /*w*/, int /*h*/) {}
 
+    // Called from OnRender right before input is latched: the serial loop polls window
+    // events here so input that arrived during the frame is not left for the next one.
+    // With the render thread the main thread already pumps events while it waits.
+    void PumpEvents() { if (!m_RenderThread) m_Window->PollEvents(); }
+
 protected:
     std::unique_ptr<IWindow> m_Window;
+
+private:
+    int runThreaded();
+
+    RenderMode m_Mode = RenderMode::OnDemand;
+    int m_PendingFrames = 0;
+    bool m_RenderThread = false;
 };
\ No newline at end of file
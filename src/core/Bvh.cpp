@@ -0,0 +1,102 @@
+#include "core/Bvh.hpp"
+
+#include <algorithm>
+#include <limits>
+
+void Bvh::Build(const std::vector<glm::vec3>& mins, const std::vector<glm::vec3>& maxs)
+{
+    Clear();
+    const int n = (int)mins.size();
+    if (n == 0) return;
+    items_.resize(n);
+    for (int i = 0; i < n; ++i) items_[i] = i;
+    nodes_.reserve(size_t(2 * n));
+
+    auto centroid = [&](int item, int axis) { return mins[item][axis] + maxs[item][axis]; };
+
+    struct Task { int node; };
+    nodes_.push_back(Node{});
+    nodes_[0].first = 0;
+    nodes_[0].count = n;
+    std::vector<Task> stack{{0}};
+    while (!stack.empty())
+    {
+        const int ni = stack.back().node;
+        stack.pop_back();
+        Node node = nodes_[ni];
+
+        glm::vec3 bmin(std::numeric_limits<float>::max()), bmax(std::numeric_limits<float>::lowest());
+        glm::vec3 cmin(std::numeric_limits<float>::max()), cmax(std::numeric_limits<float>::lowest());
+        for (int i = node.first; i < node.first + node.count; ++i)
+        {
+            const int it = items_[i];
+            for (int a = 0; a < 3; ++a)
+            {
+                bmin[a] = std::min(bmin[a], mins[it][a]);
+                bmax[a] = std::max(bmax[a], maxs[it][a]);
+                cmin[a] = std::min(cmin[a], centroid(it, a));
+                cmax[a] = std::max(cmax[a], centroid(it, a));
+            }
+        }
+        node.bmin = bmin;
+        node.bmax = bmax;
+
+        if (node.count > kLeafSize)
+        {
+            int axis = 0;
+            for (int a = 1; a < 3; ++a)
+                if (cmax[a] - cmin[a] > cmax[axis] - cmin[axis]) axis = a;
+            const int mid = node.first + node.count / 2;
+            std::nth_element(items_.begin() + node.first, items_.begin() + mid, items_.begin() + node.first + node.count,
+                             [&](int a, int b) { return centroid(a, axis) < centroid(b, axis); });
+
+            node.left = (int)nodes_.size();
+            Node l, r;
+            l.first = node.first;
+            l.count = mid - node.first;
+            r.first = mid;
+            r.count = node.first + node.count - mid;
+            nodes_.push_back(l);
+            nodes_.push_back(r);
+            stack.push_back({node.left});
+            stack.push_back({node.left + 1});
+        }
+        nodes_[ni] = node;
+    }
+
+    itemMin_.resize(n);
+    itemMax_.resize(n);
+    for (int i = 0; i < n; ++i)
+    {
+        itemMin_[i] = mins[items_[i]];
+        itemMax_[i] = maxs[items_[i]];
+    }
+}
+
+void Bvh::Cull(const Frustum& frustum, std::vector<uint8_t>& visible) const
+{
+    if (nodes_.empty()) return;
+    int stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const Node& node = nodes_[stack[--top]];
+        const Frustum::Result r = frustum.Classify(node.bmin, node.bmax);
+        if (r == Frustum::Result::Outside) continue;
+        if (r == Frustum::Result::Inside)
+        {
+            for (int i = node.first; i < node.first + node.count; ++i) visible[items_[i]] = 1;
+            continue;
+        }
+        if (node.left < 0)
+        {
+            // Partially visible leaf: test its items individually
+            for (int i = node.first; i < node.first + node.count; ++i)
+                if (frustum.Classify(itemMin_[i], itemMax_[i]) != Frustum::Result::Outside) visible[items_[i]] = 1;
+            continue;
+        }
+        stack[top++] = node.left;
+        stack[top++] = node.left + 1;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "core/Frustum.hpp"
+
+#include <cstdint>
+#include <vector>
+#include <glm/vec3.hpp>
+
+// Bounding-volume hierarchy over axis-aligned boxes, built top-down by median split
+// along the widest centroid axis. Nodes live in one flat array and every subtree owns
+// a contiguous range of the item permutation, so a node fully inside the frustum
+// accepts all of its items without visiting children.
+class Bvh {
+public:
+    void Build(const std::vector<glm::vec3>& mins, const std::vector<glm::vec3>& maxs);
+    void Clear() { nodes_.clear(); items_.clear(); itemMin_.clear(); itemMax_.clear(); }
+    bool Empty() const { return nodes_.empty(); }
+
+    // Sets visible[item] to 1 for every item whose box is not outside the frustum.
+    // visible must hold one entry per item; entries of culled items are left as is.
+    void Cull(const Frustum& frustum, std::vector<uint8_t>& visible) const;
+
+    struct Node {
+        glm::vec3 bmin, bmax;
+        int first = 0, count = 0; // range in Item()
+        int left = -1;            // children are left and left + 1; -1 for leaves
+    };
+    // Flat node access for callers that keep per-node state (occlusion queries). Node 0 is
+    // the root and children always come after their parent.
+    const std::vector<Node>& Nodes() const { return nodes_; }
+    int Item(int i) const { return items_[i]; }
+
+private:
+    static constexpr int kLeafSize = 4;
+
+    std::vector<Node> nodes_;
+    std::vector<int> items_;
+    std::vector<glm::vec3> itemMin_, itemMax_; // item boxes in items_ order, for leaf tests
+};
@@ -4,16 +4,32 @@
 void Camera::setPerspective(float fovyRad, float aspect, float zNear, float zFar) 
 {
     fovy_ = fovyRad; aspect_ = aspect; zNear_ = zNear; zFar_ = zFar;
-    proj_ = glm::perspective(fovy_, aspect_, zNear_, zFar_);
+    updateProjection();
 }
 
 void Camera::lookAt(const glm::vec3& eye, const glm::vec3& center, const glm::vec3& up) 
 {
+    eye_ = eye;
     view_ = glm::lookAt(eye, center, up);
 }
 
 void Camera::setAspect(float aspect) 
 {
     aspect_ = aspect;
+    updateProjection();
+}
+
+void Camera::setJitter(const glm::vec2& ndcOffset)
+{
+    if (ndcOffset == jitter_) return;
+    jitter_ = ndcOffset;
+    updateProjection();
+}
+
+void Camera::updateProjection()
+{
     proj_ = glm::perspective(fovy_, aspect_, zNear_, zFar_);
+    // Column 2 scales view z, and clip w = -z, so this shifts NDC by the jitter
+    proj_[2][0] -= jitter_.x;
+    proj_[2][1] -= jitter_.y;
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 #include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
+#include "core/Frustum.hpp"
+
 class Camera {
 public:
     void setPerspective(float fovyRad, float aspect, float zNear, float zFar);
@@ -9,13 +12,22 @@ public:
 
     const glm::mat4& view() const { return view_; }
     const glm::mat4& proj() const { return proj_; }
+    const glm::vec3& eye() const { return eye_; }
+    // World-space view frustum of the current view and projection
+    Frustum frustum() const { return Frustum::FromMatrix(proj_ * view_); }
     void setAspect(float aspect);
+    // Sub-pixel offset of the projection in NDC (temporal antialiasing); zero by default
+    void setJitter(const glm::vec2& ndcOffset);
 
 protected:
     glm::mat4 view_{1.0f};
     glm::mat4 proj_{1.0f};
+    glm::vec3 eye_{0.0f};
     float fovy_ = 1.0471975512f; // 60° in radians
     float aspect_ = 16.0f/9.0f;
     float zNear_ = 0.1f;
     float zFar_  = 100.0f;
+    glm::vec2 jitter_{0.0f};
+
+    void updateProjection();
 };
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include "core/FileWatcher.hpp"
+
+#include <filesystem>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr auto kSettleTime = std::chrono::milliseconds(150);
+}
+
+std::string FileWatcher::Normalize(const std::string& path)
+{
+    std::error_code ec;
+    auto abs = std::filesystem::absolute(path, ec);
+    return (ec ? std::filesystem::path(path) : abs).lexically_normal().string();
+}
+
+#ifdef __linux__
+
+FileWatcher::FileWatcher()
+{
+    fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+}
+
+FileWatcher::~FileWatcher()
+{
+    Clear();
+    if (fd_ >= 0) close(fd_);
+}
+
+void FileWatcher::Watch(const std::vector<std::string>& files)
+{
+    Clear();
+    if (fd_ < 0) return;
+    std::unordered_set<std::string> dirs;
+    for (const auto& f : files)
+    {
+        const std::string path = Normalize(f);
+        files_.insert(path);
+        dirs.insert(std::filesystem::path(path).parent_path().string());
+    }
+    for (const auto& dir : dirs)
+    {
+        const int wd = inotify_add_watch(fd_, dir.c_str(), IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE);
+        if (wd >= 0) dirs_[wd] = dir;
+    }
+}
+
+void FileWatcher::Clear()
+{
+    if (fd_ >= 0)
+        for (const auto& kv : dirs_) inotify_rm_watch(fd_, kv.first);
+    dirs_.clear();
+    files_.clear();
+    pending_.clear();
+}
+
+std::vector<std::string> FileWatcher::Poll()
+{
+    std::vector<std::string> changed;
+    if (fd_ < 0 || dirs_.empty()) return changed;
+
+    alignas(struct inotify_event) char buf[4096];
+    const auto now = Clock::now();
+    for (;;)
+    {
+        const ssize_t len = read(fd_, buf, sizeof(buf));
+        if (len <= 0) break;
+        for (ssize_t off = 0; off < len;)
+        {
+            const auto* ev = reinterpret_cast<const struct inotify_event*>(buf + off);
+            off += sizeof(struct inotify_event) + ev->len;
+            auto it = dirs_.find(ev->wd);
+            if (it == dirs_.end() || ev->len == 0) continue;
+            const std::string path = (std::filesystem::path(it->second) / ev->name).string();
+            if (files_.count(path)) pending_[path] = now;
+        }
+    }
+
+    for (auto it = pending_.begin(); it != pending_.end();)
+    {
+        if (now - it->second >= kSettleTime)
+        {
+            changed.push_back(it->first);
+            it = pending_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return changed;
+}
+
+#else
+
+namespace {
+long long stampOf(const std::string& path)
+{
+    std::error_code ec;
+    auto t = std::filesystem::last_write_time(path, ec);
+    return ec ? 0 : (long long)t.time_since_epoch().count();
+}
+}
+
+FileWatcher::FileWatcher() = default;
+
+FileWatcher::~FileWatcher()
+{
+    Clear();
+}
+
+void FileWatcher::Watch(const std::vector<std::string>& files)
+{
+    Clear();
+    for (const auto& f : files)
+    {
+        const std::string path = Normalize(f);
+        files_.insert(path);
+        stamps_[path] = stampOf(path);
+    }
+}
+
+void FileWatcher::Clear()
+{
+    files_.clear();
+    stamps_.clear();
+    pending_.clear();
+}
+
+std::vector<std::string> FileWatcher::Poll()
+{
+    std::vector<std::string> changed;
+    const auto now = Clock::now();
+    if (now - lastScan_ >= std::chrono::milliseconds(500))
+    {
+        lastScan_ = now;
+        for (auto& kv : stamps_)
+        {
+            const long long stamp = stampOf(kv.first);
+            if (stamp != kv.second) { kv.second = stamp; pending_[kv.first] = now; }
+        }
+    }
+    for (auto it = pending_.begin(); it != pending_.end();)
+    {
+        if (now - it->second >= kSettleTime)
+        {
+            changed.push_back(it->first);
+            it = pending_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return changed;
+}
+
+#endif
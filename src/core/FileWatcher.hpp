@@ -0,0 +1,45 @@
+#pragma once
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Watches a set of files for changes without blocking the frame loop.
+//
+// On Linux the parent directories are watched with inotify, so exporters that save
+// by writing a temp file and renaming it over the original are seen as well. Other
+// platforms fall back to polling modification times twice a second. Changes are
+// reported once a file has been quiet for a short settle time, so a multi-write
+// export triggers one reload instead of several.
+class FileWatcher {
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Replace the watched set
+    void Watch(const std::vector<std::string>& files);
+    void Clear();
+
+    // Watched files that changed and have settled since the last call
+    std::vector<std::string> Poll();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static std::string Normalize(const std::string& path);
+
+    std::unordered_set<std::string> files_;
+    std::unordered_map<std::string, Clock::time_point> pending_; // file -> last event
+
+#ifdef __linux__
+    int fd_ = -1;
+    std::unordered_map<int, std::string> dirs_; // watch descriptor -> directory
+#else
+    std::unordered_map<std::string, long long> stamps_;
+    Clock::time_point lastScan_{};
+#endif
+};
@@ -0,0 +1,85 @@
+#pragma once
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MV_FRUSTUM_SSE 1
+#include <emmintrin.h>
+#endif
+
+// View frustum as six planes (left, right, bottom, top, near, far) extracted from a
+// projection * view (* model) matrix; with a model matrix folded in the planes are in
+// that object's space. A point p is inside when dot(n, p) + w >= 0 for every plane.
+//
+// Planes are also kept as SoA rows padded to eight so a box is classified against
+// four planes per SSE instruction.
+class Frustum {
+public:
+    enum class Result { Outside, Intersects, Inside };
+
+    Frustum() = default;
+    static Frustum FromMatrix(const glm::mat4& m)
+    {
+        Frustum f;
+        const glm::vec4 r0(m[0][0], m[1][0], m[2][0], m[3][0]);
+        const glm::vec4 r1(m[0][1], m[1][1], m[2][1], m[3][1]);
+        const glm::vec4 r2(m[0][2], m[1][2], m[2][2], m[3][2]);
+        const glm::vec4 r3(m[0][3], m[1][3], m[2][3], m[3][3]);
+        f.planes_[0] = r3 + r0; f.planes_[1] = r3 - r0;
+        f.planes_[2] = r3 + r1; f.planes_[3] = r3 - r1;
+        f.planes_[4] = r3 + r2; f.planes_[5] = r3 - r2;
+        for (int i = 0; i < 8; ++i)
+        {
+            // padding planes always pass
+            const glm::vec4 p = (i < 6) ? f.planes_[i] : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+            f.nx_[i] = p.x; f.ny_[i] = p.y; f.nz_[i] = p.z; f.d_[i] = p.w;
+            f.ax_[i] = p.x < 0.0f ? -p.x : p.x;
+            f.ay_[i] = p.y < 0.0f ? -p.y : p.y;
+            f.az_[i] = p.z < 0.0f ? -p.z : p.z;
+        }
+        return f;
+    }
+
+    const glm::vec4* Planes() const { return planes_; }
+
+    // Classify an axis-aligned box against all planes
+    Result Classify(const glm::vec3& bmin, const glm::vec3& bmax) const
+    {
+        const glm::vec3 c = 0.5f * (bmin + bmax);
+        const glm::vec3 e = 0.5f * (bmax - bmin);
+#ifdef MV_FRUSTUM_SSE
+        const __m128 cx = _mm_set1_ps(c.x), cy = _mm_set1_ps(c.y), cz = _mm_set1_ps(c.z);
+        const __m128 ex = _mm_set1_ps(e.x), ey = _mm_set1_ps(e.y), ez = _mm_set1_ps(e.z);
+        const __m128 zero = _mm_setzero_ps();
+        int outside = 0, partial = 0;
+        for (int k = 0; k < 8; k += 4)
+        {
+            // distance of the center and projected half extent onto each plane normal
+            const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(nx_ + k), cx), _mm_mul_ps(_mm_loadu_ps(ny_ + k), cy)),
+                                        _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(nz_ + k), cz), _mm_loadu_ps(d_ + k)));
+            const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(ax_ + k), ex), _mm_mul_ps(_mm_loadu_ps(ay_ + k), ey)),
+                                        _mm_mul_ps(_mm_loadu_ps(az_ + k), ez));
+            outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(d, r), zero));
+            partial |= _mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(d, r), zero));
+        }
+        if (outside) return Result::Outside;
+        return partial ? Result::Intersects : Result::Inside;
+#else
+        bool partial = false;
+        for (int i = 0; i < 6; ++i)
+        {
+            const float d = nx_[i] * c.x + ny_[i] * c.y + nz_[i] * c.z + d_[i];
+            const float r = ax_[i] * e.x + ay_[i] * e.y + az_[i] * e.z;
+            if (d + r < 0.0f) return Result::Outside;
+            if (d - r < 0.0f) partial = true;
+        }
+        return partial ? Result::Intersects : Result::Inside;
+#endif
+    }
+
+private:
+    glm::vec4 planes_[6];
+    float nx_[8], ny_[8], nz_[8], d_[8];  // SoA plane rows
+    float ax_[8], ay_[8], az_[8];         // |normal| for box extents
+};
@@ -1,5 +1,13 @@
 #include "core/Input.hpp"
 
+#include <chrono>
+
+double Input::Now()
+{
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
 void Input::SetKeyState(int key, bool pressed) 
 { 
     s_Key[key] = pressed; 
@@ -14,6 +22,13 @@ bool Input::IsKeyPressed(int key)
 void Input::SetMouseButton(int button, bool pressed) 
 { 
     s_Mouse[button] = pressed; 
+    InputEvent e;
+    e.type = InputEvent::Type::Button;
+    e.button = button;
+    e.pressed = pressed;
+    e.x = s_MouseX; e.y = s_MouseY;
+    e.time = Now();
+    s_Events.Push(e);
 }
 
 bool Input::IsMousePressed(int button) 
@@ -25,6 +40,11 @@ bool Input::IsMousePressed(int button)
 void Input::SetMousePos(double x, double y) 
 { 
     s_MouseX = x; s_MouseY = y; 
+    InputEvent e;
+    e.type = InputEvent::Type::Move;
+    e.x = x; e.y = y;
+    e.time = Now();
+    s_Events.Push(e);
 }
 
 void Input::GetMousePos(double& x, double& y) 
@@ -35,6 +55,11 @@ void Input::GetMousePos(double& x, double& y)
 void Input::AddScroll(double dx, double dy) 
 { 
     s_ScrollX += dx; s_ScrollY += dy; 
+    InputEvent e;
+    e.type = InputEvent::Type::Scroll;
+    e.x = dx; e.y = dy;
+    e.time = Now();
+    s_Events.Push(e);
 }
 
 void Input::ConsumeScroll(double& dx, double& dy) 
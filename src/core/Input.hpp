@@ -1,6 +1,8 @@
 #pragma once
 #include <unordered_map>
 
+#include "core/InputQueue.hpp"
+
 class Input {
 public:
     // keyboard
@@ -19,9 +21,16 @@ public:
     static void AddScroll(double dx, double dy);
     static void ConsumeScroll(double& dx, double& dy); // returns and clears
 
+    // Every mouse move, button and scroll above is also queued with its arrival time, so
+    // the camera can be latched right before drawing instead of once per update
+    static InputQueue& Events() { return s_Events; }
+    // Seconds on the steady clock used for event timestamps
+    static double Now();
+
 private:
     static inline std::unordered_map<int, bool> s_Key{};
     static inline std::unordered_map<int, bool> s_Mouse{};
     static inline double s_MouseX = 0.0, s_MouseY = 0.0;
     static inline double s_ScrollX = 0.0, s_ScrollY = 0.0;
+    static inline InputQueue s_Events{};
 };
\ No newline at end of file
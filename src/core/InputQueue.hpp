@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// One pointer event, stamped on arrival with Input::Now()
+struct InputEvent {
+    enum class Type : uint8_t { Move, Button, Scroll };
+    Type type = Type::Move;
+    bool pressed = false;   // Button
+    int button = 0;         // Button
+    double x = 0.0, y = 0.0; // cursor position (Move, Button) or scroll delta
+    double time = 0.0;
+};
+
+// Lock-free single-producer/single-consumer ring of input events. The producer is the
+// thread polling window events, the consumer whoever latches the camera (the render
+// thread in threaded mode). A full ring drops new events rather than block the producer.
+class InputQueue {
+public:
+    static constexpr size_t kCapacity = 4096; // power of two; seconds of mouse motion
+
+    bool Push(const InputEvent& e)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == kCapacity)
+        {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        ring_[head & (kCapacity - 1)] = e;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Pop(InputEvent& e)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) return false;
+        e = ring_[tail & (kCapacity - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint64_t Dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    std::array<InputEvent, kCapacity> ring_{};
+    alignas(64) std::atomic<size_t> head_{0};  // producer
+    alignas(64) std::atomic<size_t> tail_{0};  // consumer
+    std::atomic<uint64_t> dropped_{0};
+};
@@ -0,0 +1,173 @@
+#include "core/MappedFile.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+    file_ = file;
+    size_ = (size_t)size.QuadPart;
+    open_ = true;
+    if (size_ == 0) return true;
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        Close();
+        return false;
+    }
+    mapping_ = mapping;
+    data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data_)
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::Create(const std::string& path, size_t size)
+{
+    Close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    file_ = file;
+    size_ = size;
+    open_ = true;
+    writable_ = true;
+    if (size_ == 0) return true;
+
+    LARGE_INTEGER li{};
+    li.QuadPart = (LONGLONG)size;
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, li.HighPart, li.LowPart, nullptr);
+    if (!mapping)
+    {
+        Close();
+        return false;
+    }
+    mapping_ = mapping;
+    data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, 0));
+    if (!data_)
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle((HANDLE)mapping_);
+    if (file_) CloseHandle((HANDLE)file_);
+    data_ = nullptr;
+    mapping_ = nullptr;
+    file_ = nullptr;
+    size_ = 0;
+    open_ = false;
+    writable_ = false;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    size_ = (size_t)st.st_size;
+    open_ = true;
+    if (size_ == 0)
+    {
+        ::close(fd);
+        return true;
+    }
+
+    void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps its own reference
+    if (p == MAP_FAILED)
+    {
+        size_ = 0;
+        open_ = false;
+        return false;
+    }
+    // Parsers walk the file front to back
+    madvise(p, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(p);
+    return true;
+}
+
+bool MappedFile::Create(const std::string& path, size_t size)
+{
+    Close();
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    if (size > 0 && ftruncate(fd, (off_t)size) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    size_ = size;
+    open_ = true;
+    writable_ = true;
+    if (size_ == 0)
+    {
+        ::close(fd);
+        return true;
+    }
+
+    void* p = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+    {
+        size_ = 0;
+        open_ = false;
+        writable_ = false;
+        return false;
+    }
+    data_ = static_cast<const char*>(p);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (data_) munmap(const_cast<char*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+    writable_ = false;
+}
+
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file. Large model files are parsed
+// straight out of the page cache instead of being copied into a buffer.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path);
+    // Create (or truncate) a file of the given size and map it writable
+    bool Create(const std::string& path, size_t size);
+    void Close();
+
+    const char* Data() const { return data_; }
+    char* MutableData() const { return writable_ ? const_cast<char*>(data_) : nullptr; }
+    size_t Size() const { return size_; }
+    bool IsOpen() const { return open_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool open_ = false;
+    bool writable_ = false;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
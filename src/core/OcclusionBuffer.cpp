@@ -0,0 +1,184 @@
+#include "core/OcclusionBuffer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MV_OCCLUSION_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr float kMinW = 1e-5f;
+
+glm::vec4 toClip(const glm::mat4& m, const glm::vec3& p)
+{
+    return m * glm::vec4(p, 1.0f);
+}
+
+} // namespace
+
+void OcclusionBuffer::Resize(int width, int height)
+{
+    w_ = std::max(kTile, (width + kTile - 1) / kTile * kTile);
+    h_ = std::max(kTile, (height + kTile - 1) / kTile * kTile);
+    tilesX_ = w_ / kTile;
+    tilesY_ = h_ / kTile;
+    depth_.assign(size_t(w_) * h_, 1.0f);
+    tileMax_.assign(size_t(tilesX_) * tilesY_, 1.0f);
+}
+
+void OcclusionBuffer::Render(const std::vector<glm::vec3>& triangles, const glm::mat4& mvp, ThreadPool* pool)
+{
+    if (w_ == 0) Resize(256, 128);
+
+    // Project every vertex once; bands then share the results
+    screen_.resize(triangles.size());
+    auto project = [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i)
+        {
+            const glm::vec4 c = toClip(mvp, triangles[i]);
+            // In front of the near plane (z < -w) the GPU clips the triangle away, so it
+            // must not occlude here either; w == 0 marks the vertex's triangle as skipped
+            if (c.w < kMinW || c.z < -c.w) { screen_[i] = glm::vec4(0.0f); continue; }
+            const float iw = 1.0f / c.w;
+            screen_[i] = glm::vec4((c.x * iw * 0.5f + 0.5f) * w_, (c.y * iw * 0.5f + 0.5f) * h_, c.z * iw * 0.5f + 0.5f, 1.0f);
+        }
+    };
+    auto bands = [&](size_t b, size_t e) { for (size_t i = b; i < e; ++i) rasterBand((int)i); };
+    if (pool)
+    {
+        pool->ParallelFor(triangles.size(), 4096, project);
+        pool->ParallelFor((size_t)tilesY_, 1, bands);
+    }
+    else
+    {
+        project(0, triangles.size());
+        bands(0, (size_t)tilesY_);
+    }
+}
+
+void OcclusionBuffer::rasterBand(int band)
+{
+    const int y0 = band * kTile, y1 = y0 + kTile; // rows [y0, y1)
+    std::fill(depth_.begin() + size_t(y0) * w_, depth_.begin() + size_t(y1) * w_, 1.0f);
+
+    for (size_t t = 0; t + 2 < screen_.size(); t += 3)
+    {
+        glm::vec4 v0 = screen_[t], v1 = screen_[t + 1], v2 = screen_[t + 2];
+        if (v0.w == 0.0f || v1.w == 0.0f || v2.w == 0.0f) continue;
+
+        // Pixel bounds inside this band; pixel centers are at +0.5
+        const float fminY = std::min(v0.y, std::min(v1.y, v2.y)), fmaxY = std::max(v0.y, std::max(v1.y, v2.y));
+        int ty0 = std::max(y0, (int)std::ceil(fminY - 0.5f));
+        int ty1 = std::min(y1 - 1, (int)std::floor(fmaxY - 0.5f));
+        if (ty0 > ty1) continue;
+        const float fminX = std::min(v0.x, std::min(v1.x, v2.x)), fmaxX = std::max(v0.x, std::max(v1.x, v2.x));
+        int tx0 = std::max(0, (int)std::ceil(fminX - 0.5f));
+        int tx1 = std::min(w_ - 1, (int)std::floor(fmaxX - 0.5f));
+        if (tx0 > tx1) continue;
+        const float minZ = std::min(v0.z, std::min(v1.z, v2.z));
+        if (minZ > 1.0f) continue;
+
+        float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+        if (std::fabs(area) < 1e-8f) continue;
+        if (area < 0.0f) { std::swap(v1, v2); area = -area; } // both windings are occluders
+
+        // Edge functions E(x, y) = A x + B y + C, positive inside
+        const float A0 = v1.y - v2.y, B0 = v2.x - v1.x, C0 = v1.x * v2.y - v2.x * v1.y;
+        const float A1 = v2.y - v0.y, B1 = v0.x - v2.x, C1 = v2.x * v0.y - v0.x * v2.y;
+        const float A2 = v0.y - v1.y, B2 = v1.x - v0.x, C2 = v0.x * v1.y - v1.x * v0.y;
+        // Depth plane from barycentrics
+        const float ia = 1.0f / area;
+        const float zA = (A0 * v0.z + A1 * v1.z + A2 * v2.z) * ia;
+        const float zB = (B0 * v0.z + B1 * v1.z + B2 * v2.z) * ia;
+        const float zC = (C0 * v0.z + C1 * v1.z + C2 * v2.z) * ia;
+
+        for (int y = ty0; y <= ty1; ++y)
+        {
+            const float py = y + 0.5f;
+            float* row = depth_.data() + size_t(y) * w_;
+            int x = tx0 & ~3;
+#ifdef MV_OCCLUSION_SSE
+            const __m128 step = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 a0 = _mm_set1_ps(A0), a1 = _mm_set1_ps(A1), a2 = _mm_set1_ps(A2), az = _mm_set1_ps(zA);
+            const __m128 r0 = _mm_set1_ps(B0 * py + C0), r1 = _mm_set1_ps(B1 * py + C1), r2 = _mm_set1_ps(B2 * py + C2);
+            const __m128 rz = _mm_set1_ps(zB * py + zC);
+            for (; x <= tx1; x += 4)
+            {
+                const __m128 px = _mm_add_ps(_mm_set1_ps((float)x), step);
+                const __m128 e0 = _mm_add_ps(_mm_mul_ps(a0, px), r0);
+                const __m128 e1 = _mm_add_ps(_mm_mul_ps(a1, px), r1);
+                const __m128 e2 = _mm_add_ps(_mm_mul_ps(a2, px), r2);
+                const __m128 inside = _mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_and_ps(_mm_cmpge_ps(e1, zero), _mm_cmpge_ps(e2, zero)));
+                if (!_mm_movemask_ps(inside)) continue;
+                const __m128 z = _mm_add_ps(_mm_mul_ps(az, px), rz);
+                const __m128 cur = _mm_loadu_ps(row + x);
+                const __m128 nearer = _mm_min_ps(cur, z);
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, cur)));
+            }
+#else
+            for (; x <= tx1; ++x)
+            {
+                const float px = x + 0.5f;
+                if (A0 * px + B0 * py + C0 < 0.0f || A1 * px + B1 * py + C1 < 0.0f || A2 * px + B2 * py + C2 < 0.0f) continue;
+                row[x] = std::min(row[x], zA * px + zB * py + zC);
+            }
+#endif
+        }
+    }
+
+    // Farthest depth per tile for the coarse test
+    for (int tx = 0; tx < tilesX_; ++tx)
+    {
+        float m = 0.0f;
+        for (int y = y0; y < y1; ++y)
+        {
+            const float* row = depth_.data() + size_t(y) * w_ + tx * kTile;
+            for (int x = 0; x < kTile; ++x) m = std::max(m, row[x]);
+        }
+        tileMax_[size_t(band) * tilesX_ + tx] = m;
+    }
+}
+
+bool OcclusionBuffer::IsOccluded(const glm::vec3& bmin, const glm::vec3& bmax, const glm::mat4& mvp) const
+{
+    if (w_ == 0) return false;
+
+    float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f, minZ = 1e30f;
+    for (int i = 0; i < 8; ++i)
+    {
+        const glm::vec3 p((i & 1) ? bmax.x : bmin.x, (i & 2) ? bmax.y : bmin.y, (i & 4) ? bmax.z : bmin.z);
+        const glm::vec4 c = toClip(mvp, p);
+        if (c.w < kMinW || c.z < -c.w) return false; // crosses the near plane
+        const float iw = 1.0f / c.w;
+        const float x = (c.x * iw * 0.5f + 0.5f) * w_, y = (c.y * iw * 0.5f + 0.5f) * h_;
+        minX = std::min(minX, x); maxX = std::max(maxX, x);
+        minY = std::min(minY, y); maxY = std::max(maxY, y);
+        minZ = std::min(minZ, c.z * iw * 0.5f + 0.5f);
+    }
+
+    // One pixel of slack covers pixels only partly covered by occluders
+    const int px0 = std::max(0, (int)std::floor(minX) - 1), px1 = std::min(w_ - 1, (int)std::floor(maxX) + 1);
+    const int py0 = std::max(0, (int)std::floor(minY) - 1), py1 = std::min(h_ - 1, (int)std::floor(maxY) + 1);
+    if (px0 > px1 || py0 > py1) return false; // off screen; leave it to frustum culling
+
+    for (int ty = py0 / kTile; ty <= py1 / kTile; ++ty)
+    {
+        for (int tx = px0 / kTile; tx <= px1 / kTile; ++tx)
+        {
+            if (tileMax_[size_t(ty) * tilesX_ + tx] < minZ) continue; // whole tile in front
+            const int x0 = std::max(px0, tx * kTile), x1 = std::min(px1, tx * kTile + kTile - 1);
+            const int y0 = std::max(py0, ty * kTile), y1 = std::min(py1, ty * kTile + kTile - 1);
+            for (int y = y0; y <= y1; ++y)
+            {
+                const float* row = depth_.data() + size_t(y) * w_;
+                for (int x = x0; x <= x1; ++x)
+                    if (row[x] >= minZ) return false;
+            }
+        }
+    }
+    return true;
+}
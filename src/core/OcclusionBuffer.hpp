@@ -0,0 +1,41 @@
+#pragma once
+#include "core/ThreadPool.hpp"
+
+#include <cstdint>
+#include <vector>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+// Low-resolution software depth buffer for occlusion culling.
+//
+// Occluder triangles are rasterized on the CPU into a small float depth buffer
+// (nearest depth per pixel), one band of 8 rows per task on the thread pool, four
+// pixels per SSE step. A second level keeps the farthest depth of every 8x8 tile, so a
+// box test usually touches only a few tiles and drops to pixels only where a tile is
+// inconclusive. Nothing here touches GL, so it can be driven headless.
+class OcclusionBuffer {
+public:
+    static constexpr int kTile = 8;
+
+    // Width and height are rounded up to multiples of kTile
+    void Resize(int width, int height);
+    int Width() const { return w_; }
+    int Height() const { return h_; }
+
+    // Rasterize occluder triangles (three object-space positions each) with the given
+    // object-to-clip matrix, replacing the previous contents. Triangles crossing the
+    // near plane are skipped, which only ever makes occlusion weaker.
+    void Render(const std::vector<glm::vec3>& triangles, const glm::mat4& mvp, ThreadPool* pool = &ThreadPool::Get());
+
+    // True if the box is certainly hidden behind the rendered occluders
+    bool IsOccluded(const glm::vec3& bmin, const glm::vec3& bmax, const glm::mat4& mvp) const;
+
+private:
+    void rasterBand(int band);
+
+    int w_ = 0, h_ = 0, tilesX_ = 0, tilesY_ = 0;
+    std::vector<float> depth_;      // per pixel, [0, 1], 1 = nothing drawn
+    std::vector<float> tileMax_;    // per tile, farthest pixel depth
+    std::vector<glm::vec4> screen_; // projected vertices: pixel x, pixel y, depth, valid
+};
@@ -0,0 +1,104 @@
+#pragma once
+#include "core/ThreadPool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// LSD radix sort of (key, value) pairs with 8-bit digits.
+//
+// Each pass builds per-block histograms, turns them into per-block output
+// offsets and scatters every block independently, so blocks can run on the
+// thread pool while the sort stays stable. 256 buckets keep the histogram in L1.
+// Passes whose digit is identical for every key are skipped, so small depth
+// ranges or short keys cost less than sizeof(Key) passes.
+//
+// keys/values hold the input and receive the sorted output; tmpKeys/tmpValues
+// are scratch buffers of the same length (callers reuse them across frames).
+template <class Key>
+void RadixSortPairs(Key* keys, uint32_t* values, Key* tmpKeys, uint32_t* tmpValues, size_t n,
+                    ThreadPool* pool = &ThreadPool::Get())
+{
+    static_assert(std::is_unsigned<Key>::value, "radix sort keys must be unsigned integers");
+    if (n < 2) return;
+
+    constexpr size_t kMinBlock = 1u << 15;
+    const size_t maxBlocks = pool ? size_t(pool->Size() + 1) * 2 : 1;
+    const size_t blocks = std::max<size_t>(1, std::min(maxBlocks, n / kMinBlock));
+    const size_t blockSize = (n + blocks - 1) / blocks;
+
+    std::vector<uint32_t> hist(blocks * 256);
+    auto forBlocks = [&](auto&& fn) {
+        if (pool && blocks > 1)
+            pool->ParallelFor(blocks, 1, [&](size_t b, size_t e) { for (size_t i = b; i < e; ++i) fn(i); });
+        else
+            for (size_t i = 0; i < blocks; ++i) fn(i);
+    };
+
+    Key* srcK = keys;     uint32_t* srcV = values;
+    Key* dstK = tmpKeys;  uint32_t* dstV = tmpValues;
+
+    for (unsigned shift = 0; shift < sizeof(Key) * 8; shift += 8)
+    {
+        std::fill(hist.begin(), hist.end(), 0u);
+        forBlocks([&](size_t blk) {
+            uint32_t* h = hist.data() + blk * 256;
+            const size_t b = blk * blockSize, e = std::min(n, b + blockSize);
+            for (size_t i = b; i < e; ++i) ++h[(srcK[i] >> shift) & 0xFF];
+        });
+
+        // Skip the pass if every key has the same digit here
+        bool trivial = false;
+        for (unsigned d = 0; d < 256 && !trivial; ++d)
+        {
+            size_t total = 0;
+            for (size_t blk = 0; blk < blocks; ++blk) total += hist[blk * 256 + d];
+            if (total == n) trivial = true;
+            else if (total != 0) break;
+        }
+        if (trivial) continue;
+
+        // Exclusive prefix in (digit, block) order keeps the sort stable
+        uint32_t running = 0;
+        for (unsigned d = 0; d < 256; ++d)
+        {
+            for (size_t blk = 0; blk < blocks; ++blk)
+            {
+                uint32_t& h = hist[blk * 256 + d];
+                const uint32_t c = h;
+                h = running;
+                running += c;
+            }
+        }
+
+        forBlocks([&](size_t blk) {
+            uint32_t* offs = hist.data() + blk * 256;
+            const size_t b = blk * blockSize, e = std::min(n, b + blockSize);
+            for (size_t i = b; i < e; ++i)
+            {
+                const uint32_t o = offs[(srcK[i] >> shift) & 0xFF]++;
+                dstK[o] = srcK[i];
+                dstV[o] = srcV[i];
+            }
+        });
+        std::swap(srcK, dstK);
+        std::swap(srcV, dstV);
+    }
+
+    if (srcK != keys)
+    {
+        std::memcpy(keys, srcK, n * sizeof(Key));
+        std::memcpy(values, srcV, n * sizeof(uint32_t));
+    }
+}
+
+// Order-preserving float -> uint32 mapping so radix sort can sort floats
+inline uint32_t FloatToSortableBits(float f)
+{
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+}
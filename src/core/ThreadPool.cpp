@@ -0,0 +1,118 @@
+#include "core/ThreadPool.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned threads)
+{
+    if (threads == 0)
+    {
+        const unsigned hw = std::thread::hardware_concurrency();
+        threads = hw > 1 ? hw - 1 : 1;
+    }
+    workers_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i)
+    {
+        workers_.emplace_back([this]() { WorkerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : workers_)
+    {
+        if (t.joinable()) t.join();
+    }
+}
+
+ThreadPool& ThreadPool::Get()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::Enqueue(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(std::move(job));
+    }
+    cv_.notify_one();
+}
+
+void ThreadPool::WorkerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+            if (stop_ && jobs_.empty()) return;
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        job();
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t minChunk, const std::function<void(size_t, size_t)>& fn)
+{
+    if (count == 0) return;
+    if (minChunk == 0) minChunk = 1;
+
+    // Aim for a few ranges per thread so uneven ranges still balance out
+    const size_t threads = (size_t)Size() + 1;
+    size_t chunks = std::min((count + minChunk - 1) / minChunk, threads * 4);
+    if (chunks <= 1)
+    {
+        fn(0, count);
+        return;
+    }
+    const size_t chunkSize = (count + chunks - 1) / chunks;
+    chunks = (count + chunkSize - 1) / chunkSize;
+
+    struct State {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+
+    auto drain = [state, chunks, chunkSize, count, &fn]()
+    {
+        for (;;)
+        {
+            const size_t c = state->next.fetch_add(1);
+            if (c >= chunks) return;
+            const size_t begin = c * chunkSize;
+            const size_t end = std::min(begin + chunkSize, count);
+            try { fn(begin, end); }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->error) state->error = std::current_exception();
+            }
+            if (state->done.fetch_add(1) + 1 == chunks)
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->cv.notify_all();
+            }
+        }
+    };
+
+    // Helpers only pull ranges; the caller drains too, so we never wait on a busy pool
+    const size_t helpers = std::min(chunks - 1, (size_t)Size());
+    for (size_t i = 0; i < helpers; ++i) Enqueue(drain);
+    drain();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [&]() { return state->done.load() == chunks; });
+    if (state->error) std::rethrow_exception(state->error);
+}
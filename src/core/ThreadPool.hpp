@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small fixed-size worker pool shared by loaders and per-frame CPU work.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Process-wide pool sized to the hardware concurrency (minus the calling thread)
+    static ThreadPool& Get();
+
+    unsigned Size() const { return (unsigned)workers_.size(); }
+
+    // Run a task on a worker; the returned future carries its result or exception.
+    template <class F>
+    auto Submit(F&& fn) -> std::future<decltype(fn())>
+    {
+        using R = decltype(fn());
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+        std::future<R> fut = task->get_future();
+        Enqueue([task]() { (*task)(); });
+        return fut;
+    }
+
+    // Split [0, count) into contiguous ranges of at least minChunk items and run
+    // fn(begin, end) on them. The calling thread participates, so this is safe to
+    // call from inside a worker task. Blocks until every range has finished.
+    void ParallelFor(size_t count, size_t minChunk, const std::function<void(size_t, size_t)>& fn);
+
+private:
+    void Enqueue(std::function<void()> job);
+    void WorkerLoop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> jobs_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-producer/single-consumer handoff of whole values. The writer fills
+// Back() and publishes it; the reader acquires the newest published value and keeps
+// reading Front() until it acquires again. Neither side ever waits for the other: a
+// slow reader skips straight to the latest value and a slow writer never stalls the
+// reader. Back() is a recycled slot, so the writer overwrites every field it uses.
+template <class T>
+class TripleBuffer {
+public:
+    T& Back() { return slots_[back_]; }
+    void Publish()
+    {
+        const uint8_t old = middle_.exchange(uint8_t(back_ | kFresh), std::memory_order_acq_rel);
+        back_ = old & kIndex;
+    }
+
+    // Take the newest published value if there is one; false keeps the current Front()
+    bool Acquire()
+    {
+        if (!(middle_.load(std::memory_order_relaxed) & kFresh)) return false;
+        const uint8_t old = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = old & kIndex;
+        return true;
+    }
+    const T& Front() const { return slots_[front_]; }
+
+private:
+    static constexpr uint8_t kIndex = 3, kFresh = 4;
+
+    T slots_[3]{};
+    std::atomic<uint8_t> middle_{1};  // slot index in the low bits, kFresh once published
+    uint8_t back_ = 0;                // writer only
+    uint8_t front_ = 2;               // reader only
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <string>
 
 struct WindowProps {
@@ -13,7 +14,15 @@ public:
     virtual ~IWindow() = default;
 
     virtual void PollEvents() = 0;
+    // Block until an event arrives or the timeout (seconds) passes
+    virtual void WaitEvents(double timeout) = 0;
+    // Bumped by every event that can change what is on screen (input, resize, expose)
+    virtual uint64_t EventCount() const = 0;
+    // Wake a WaitEvents() from any thread
+    virtual void PostEmptyEvent() = 0;
     virtual void SwapBuffers() = 0;
+    // Attach the GL context to the calling thread, or detach it (it is current on one thread at a time)
+    virtual void MakeContextCurrent(bool current) = 0;
     virtual bool ShouldClose() const = 0;
 
     virtual void SetTitle(const std::string& title) = 0;
@@ -0,0 +1,162 @@
+#include "gfx/Animation.hpp"
+#include "gfx/SceneGraph.hpp"
+#include "core/ThreadPool.hpp"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Index k such that times[k] <= t < times[k+1], clamped to [0, n-2]. Tries the
+// cached interval and its successor before falling back to a binary search.
+uint32_t findKey(const std::vector<float>& times, float t, uint32_t& cursor)
+{
+    const uint32_t n = (uint32_t)times.size();
+    if (n < 2 || t <= times[0]) return cursor = 0;
+    if (t >= times[n - 1]) return cursor = n - 2;
+    if (cursor + 1 < n && times[cursor] <= t)
+    {
+        if (t < times[cursor + 1]) return cursor;
+        if (cursor + 2 < n && t < times[cursor + 2]) return ++cursor;
+    }
+    const auto it = std::upper_bound(times.begin(), times.end(), t);
+    cursor = (uint32_t)std::min<ptrdiff_t>(std::max<ptrdiff_t>(it - times.begin() - 1, 0), n - 2);
+    return cursor;
+}
+
+glm::vec4 loadKey(const AnimationChannel& ch, uint32_t key, int slot)
+{
+    // slot: 0 = value for step/linear; 0/1/2 = in-tangent/value/out-tangent for cubic
+    const int stride = (ch.interp == AnimationChannel::Interp::CubicSpline) ? 3 : 1;
+    const float* v = ch.values.data() + (size_t(key) * stride + slot) * ch.components;
+    glm::vec4 r(0.0f);
+    for (int c = 0; c < ch.components; ++c) r[c] = v[c];
+    return r;
+}
+
+glm::vec4 sample(AnimationChannel& ch, float t)
+{
+    const bool cubic = ch.interp == AnimationChannel::Interp::CubicSpline;
+    const int valueSlot = cubic ? 1 : 0;
+    if (ch.times.size() < 2) return loadKey(ch, 0, valueSlot);
+
+    const uint32_t k = findKey(ch.times, t, ch.cursor);
+    const float t0 = ch.times[k], t1 = ch.times[k + 1];
+    const float dt = t1 - t0;
+    const float u = (dt > 0.0f) ? std::clamp((t - t0) / dt, 0.0f, 1.0f) : 0.0f;
+
+    glm::vec4 r;
+    if (ch.interp == AnimationChannel::Interp::Step)
+    {
+        r = loadKey(ch, (t >= t1) ? k + 1 : k, 0);
+    }
+    else if (cubic)
+    {
+        const float u2 = u * u, u3 = u2 * u;
+        const glm::vec4 p0 = loadKey(ch, k, 1), m0 = loadKey(ch, k, 2) * dt;
+        const glm::vec4 p1 = loadKey(ch, k + 1, 1), m1 = loadKey(ch, k + 1, 0) * dt;
+        r = (2.0f * u3 - 3.0f * u2 + 1.0f) * p0 + (u3 - 2.0f * u2 + u) * m0 +
+            (-2.0f * u3 + 3.0f * u2) * p1 + (u3 - u2) * m1;
+    }
+    else if (ch.path == AnimationChannel::Path::Rotation)
+    {
+        const glm::vec4 a = loadKey(ch, k, 0), b = loadKey(ch, k + 1, 0);
+        const glm::quat q = glm::slerp(glm::quat(a.w, a.x, a.y, a.z), glm::quat(b.w, b.x, b.y, b.z), u);
+        return glm::vec4(q.x, q.y, q.z, q.w);
+    }
+    else
+    {
+        r = glm::mix(loadKey(ch, k, 0), loadKey(ch, k + 1, 0), u);
+    }
+
+    if (ch.path == AnimationChannel::Path::Rotation)
+    {
+        const float len = glm::length(r);
+        r = (len > 0.0f) ? r / len : glm::vec4(0, 0, 0, 1);
+    }
+    return r;
+}
+
+// Same as sample() for an arbitrary number of components (morph weights)
+void sampleWeights(AnimationChannel& ch, float t, float* out)
+{
+    const int n = ch.components;
+    const bool cubic = ch.interp == AnimationChannel::Interp::CubicSpline;
+    const int stride = cubic ? 3 : 1;
+    auto key = [&](uint32_t k, int slot) { return ch.values.data() + (size_t(k) * stride + slot) * n; };
+    if (ch.times.size() < 2)
+    {
+        std::copy(key(0, cubic ? 1 : 0), key(0, cubic ? 1 : 0) + n, out);
+        return;
+    }
+
+    const uint32_t k = findKey(ch.times, t, ch.cursor);
+    const float t0 = ch.times[k], t1 = ch.times[k + 1];
+    const float dt = t1 - t0;
+    const float u = (dt > 0.0f) ? std::clamp((t - t0) / dt, 0.0f, 1.0f) : 0.0f;
+    if (ch.interp == AnimationChannel::Interp::Step)
+    {
+        const float* v = key((t >= t1) ? k + 1 : k, 0);
+        std::copy(v, v + n, out);
+    }
+    else if (cubic)
+    {
+        const float u2 = u * u, u3 = u2 * u;
+        const float h00 = 2.0f * u3 - 3.0f * u2 + 1.0f, h10 = (u3 - 2.0f * u2 + u) * dt;
+        const float h01 = -2.0f * u3 + 3.0f * u2, h11 = (u3 - u2) * dt;
+        const float *p0 = key(k, 1), *m0 = key(k, 2), *p1 = key(k + 1, 1), *m1 = key(k + 1, 0);
+        for (int c = 0; c < n; ++c) out[c] = h00 * p0[c] + h10 * m0[c] + h01 * p1[c] + h11 * m1[c];
+    }
+    else
+    {
+        const float *a = key(k, 0), *b = key(k + 1, 0);
+        for (int c = 0; c < n; ++c) out[c] = a[c] + (b[c] - a[c]) * u;
+    }
+}
+
+} // namespace
+
+void Animator::update(float dt, SceneGraph& graph, std::vector<float>& morphWeights)
+{
+    if (!clip_ || clip_->channels.empty()) return;
+
+    time_ += dt;
+    if (clip_->duration > 0.0f) time_ = std::fmod(time_, clip_->duration);
+
+    auto& channels = clip_->channels;
+    results_.resize(channels.size());
+    const float t = time_;
+    ThreadPool::Get().ParallelFor(channels.size(), 64, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i)
+        {
+            AnimationChannel& ch = channels[i];
+            // Weight channels own disjoint slot ranges, so they write in place
+            if (ch.path == AnimationChannel::Path::Weights)
+            {
+                if (ch.weightBase >= 0 && size_t(ch.weightBase + ch.components) <= morphWeights.size())
+                    sampleWeights(ch, t, morphWeights.data() + ch.weightBase);
+            }
+            else
+            {
+                results_[i] = sample(ch, t);
+            }
+        }
+    });
+
+    for (size_t i = 0; i < channels.size(); ++i)
+    {
+        const AnimationChannel& ch = channels[i];
+        const glm::vec4& r = results_[i];
+        switch (ch.path)
+        {
+            case AnimationChannel::Path::Translation: graph.setTranslation(ch.node, glm::vec3(r)); break;
+            case AnimationChannel::Path::Rotation:    graph.setRotation(ch.node, glm::quat(r.w, r.x, r.y, r.z)); break;
+            case AnimationChannel::Path::Scale:       graph.setScale(ch.node, glm::vec3(r)); break;
+            case AnimationChannel::Path::Weights:     break;
+        }
+    }
+}
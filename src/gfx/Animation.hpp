@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/vec4.hpp>
+
+class SceneGraph;
+
+// One animated property of one scene graph node. Keyframe values are stored flat
+// (key-major, `components` floats per key; cubic splines store in-tangent, value,
+// out-tangent per key as glTF does). Morph weight channels have one component per
+// target and write to a flat weight array instead of the graph.
+struct AnimationChannel {
+    enum class Path : uint8_t { Translation, Rotation, Scale, Weights };
+    enum class Interp : uint8_t { Step, Linear, CubicSpline };
+
+    int node = -1;             // SceneGraph index
+    int weightBase = -1;       // first morph weight slot (Weights path)
+    Path path = Path::Translation;
+    Interp interp = Interp::Linear;
+    int components = 3;
+    std::vector<float> times;
+    std::vector<float> values;
+    uint32_t cursor = 0;       // last keyframe interval, playback is mostly monotonic
+};
+
+struct AnimationClip {
+    std::string name;
+    float duration = 0.0f;
+    std::vector<AnimationChannel> channels;
+    bool hasWeights = false;   // any Weights channel
+};
+
+// Plays one clip onto a SceneGraph. Channels are sampled on the worker pool into a
+// flat result array and then written to the graph in one serial pass, so the graph
+// never sees concurrent writes.
+class Animator {
+public:
+    void setClip(AnimationClip* clip) { clip_ = clip; time_ = 0.0f; }
+    const AnimationClip* clip() const { return clip_; }
+
+    // Advance (looping) and apply to the graph and morph weights; call
+    // graph.updateWorld() afterwards
+    void update(float dt, SceneGraph& graph, std::vector<float>& morphWeights);
+    float time() const { return time_; }
+
+private:
+    AnimationClip* clip_ = nullptr;
+    float time_ = 0.0f;
+    std::vector<glm::vec4> results_;
+};
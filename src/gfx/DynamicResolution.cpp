@@ -0,0 +1,279 @@
+#include "gfx/DynamicResolution.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+
+static_assert(DynamicResolution::kDepthFormat == GL_DEPTH24_STENCIL8, "kDepthFormat must be GL_DEPTH24_STENCIL8");
+
+namespace
+{
+    int samplesFor(DynamicResolution::Antialiasing mode)
+    {
+        using AA = DynamicResolution::Antialiasing;
+        switch (mode)
+        {
+        case AA::Msaa2: return 2;
+        case AA::Msaa4: return 4;
+        case AA::Msaa8: return 8;
+        default: return 0;
+        }
+    }
+
+    // Radical inverse in the given base; (Halton(i, 2), Halton(i, 3)) covers the pixel evenly
+    float halton(int index, int base)
+    {
+        float f = 1.0f, r = 0.0f;
+        for (int i = index; i > 0; i /= base)
+        {
+            f /= float(base);
+            r += f * float(i % base);
+        }
+        return r;
+    }
+}
+
+const char* DynamicResolution::Name(Antialiasing mode)
+{
+    switch (mode)
+    {
+    case Antialiasing::Off: return "NoAA";
+    case Antialiasing::Msaa2: return "MSAA2x";
+    case Antialiasing::Msaa4: return "MSAA4x";
+    case Antialiasing::Msaa8: return "MSAA8x";
+    case Antialiasing::Fxaa: return "FXAA";
+    case Antialiasing::Temporal: return "TAA";
+    }
+    return "";
+}
+
+DynamicResolution::~DynamicResolution()
+{
+    shutdown();
+}
+
+void DynamicResolution::init()
+{
+    if (fxaa_) return;
+    fxaa_ = Shader::FromFiles("assets/shaders/fullscreen.vert", "assets/shaders/fxaa.frag");
+    accumulateShader_ = Shader::FromFiles("assets/shaders/fullscreen.vert", "assets/shaders/accumulate.frag");
+    glGenVertexArrays(1, &vao_);
+    glGetIntegerv(GL_MAX_SAMPLES, &maxSamples_);
+}
+
+bool DynamicResolution::update(double gpuMs, bool interacting, double dt)
+{
+    stillTime_ = interacting ? 0.0 : stillTime_ + dt;
+    const bool refined = stillTime_ >= kRefineDelay;
+    const bool changed = refined != refined_;
+    refined_ = refined;
+    // Times measured at the other quality level would mislead the controller
+    if (changed) staleFrames_ = kStaleFrames;
+    if (refined_) return changed;
+    if (staleFrames_ > 0)
+    {
+        --staleFrames_;
+        return changed;
+    }
+
+    if (gpuMs > 0.0)
+    {
+        // Cost follows the pixel count, so the side length goes with the square root.
+        // Drop quickly and recover slowly; the measurement lags a few frames.
+        const float want = scale_ * (float)std::sqrt(targetMs_ / gpuMs);
+        scale_ += std::clamp(want - scale_, -0.1f, 0.05f);
+        scale_ = std::clamp(scale_, kMinScale, 1.0f);
+    }
+    return changed;
+}
+
+void DynamicResolution::allocate(int width, int height, int samples, bool history)
+{
+    releaseTargets();
+    width_ = width;
+    height_ = height;
+    samples_ = samples;
+
+    auto makeRbo = [&](GLuint& rbo, GLenum format, int n) {
+        glGenRenderbuffers(1, &rbo);
+        glBindRenderbuffer(GL_RENDERBUFFER, rbo);
+        if (n > 0) glRenderbufferStorageMultisample(GL_RENDERBUFFER, n, format, width, height);
+        else glRenderbufferStorage(GL_RENDERBUFFER, format, width, height);
+    };
+    auto makeTex = [&](GLuint& tex, GLenum internalFormat, GLenum type) {
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, GL_RGBA, type, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    };
+    auto makeFbo = [](GLuint& fbo, GLuint color, bool colorIsTexture, GLuint depth) {
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        if (colorIsTexture) glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color, 0);
+        else glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+        if (depth) glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth);
+    };
+
+    // Depth matches the OIT copy so its blit is allowed
+    makeTex(colorTex_, GL_RGBA8, GL_UNSIGNED_BYTE);
+    makeRbo(depth_, kDepthFormat, 0);
+    makeFbo(fbo_, colorTex_, true, depth_);
+    if (samples > 0)
+    {
+        makeRbo(msaaColor_, GL_RGBA8, samples);
+        makeRbo(msaaDepth_, kDepthFormat, samples);
+        makeFbo(msaaFbo_, msaaColor_, false, msaaDepth_);
+    }
+    if (history)
+    {
+        makeTex(historyTex_, GL_RGBA16F, GL_HALF_FLOAT);
+        makeFbo(historyFbo_, historyTex_, true, 0);
+    }
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    historyFrames_ = 0;
+}
+
+void DynamicResolution::begin(int windowWidth, int windowHeight)
+{
+    if (windowWidth <= 0 || windowHeight <= 0) return;
+    const int samples = std::min(samplesFor(aa_), maxSamples_);
+    const bool history = aa_ == Antialiasing::Temporal;
+    if (windowWidth != width_ || windowHeight != height_ || samples != samples_ ||
+        history != (historyFbo_ != 0) || !fbo_)
+    {
+        allocate(windowWidth, windowHeight, samples, history);
+    }
+
+    const float s = scale();
+    renderWidth_ = std::clamp((int)std::lround(width_ * s), 1, width_);
+    renderHeight_ = std::clamp((int)std::lround(height_ * s), 1, height_);
+    multisampled_ = samples_ > 0 && refined_;
+    accumulate_ = history && refined_;
+    if (!accumulate_) historyFrames_ = 0;
+
+    // The first frame of a view is unjittered; later ones walk the pixel in a Halton pattern
+    jitter_ = glm::vec2(0.0f);
+    if (accumulate_ && historyFrames_ > 0)
+    {
+        const int i = historyFrames_ % 64 + 1;
+        jitter_ = glm::vec2((halton(i, 2) - 0.5f) * 2.0f / float(renderWidth_),
+                            (halton(i, 3) - 0.5f) * 2.0f / float(renderHeight_));
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, multisampled_ ? msaaFbo_ : fbo_);
+    glViewport(0, 0, renderWidth_, renderHeight_);
+    active_ = true;
+}
+
+void DynamicResolution::drawFullscreen(const Shader& shader) const
+{
+    // Face culling is a scene toggle; the post triangle ignores it
+    const GLboolean depthWasOn = glIsEnabled(GL_DEPTH_TEST);
+    const GLboolean cullWasOn = glIsEnabled(GL_CULL_FACE);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+
+    shader.use();
+    glUniform1i(shader.loc("uScene"), 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, colorTex_);
+    glBindVertexArray(vao_);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (depthWasOn) glEnable(GL_DEPTH_TEST);
+    if (cullWasOn) glEnable(GL_CULL_FACE);
+}
+
+void DynamicResolution::present()
+{
+    if (!active_) return;
+    active_ = false;
+
+    // Multisampled blits need equal rectangles, so resolve first and stretch second
+    if (multisampled_)
+    {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, msaaFbo_);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo_);
+        glBlitFramebuffer(0, 0, renderWidth_, renderHeight_, 0, 0, renderWidth_, renderHeight_,
+                          GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+
+    if (accumulate_)
+    {
+        // Running average: the n-th frame of a view gets weight 1 / n
+        const int n = std::min(historyFrames_, kTemporalFrames) + 1;
+        glBindFramebuffer(GL_FRAMEBUFFER, historyFbo_);
+        glViewport(0, 0, width_, height_);
+        const GLboolean blendWasOn = glIsEnabled(GL_BLEND);
+        glEnable(GL_BLEND);
+        glBlendColor(0.0f, 0.0f, 0.0f, 1.0f / float(n));
+        glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
+        drawFullscreen(*accumulateShader_);
+        if (!blendWasOn) glDisable(GL_BLEND);
+        ++historyFrames_;
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, historyFbo_);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, width_, height_, 0, 0, width_, height_, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+    else if (aa_ == Antialiasing::Fxaa)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, width_, height_);
+        fxaa_->use();
+        glUniform2f(fxaa_->loc("uTexel"), 1.0f / float(width_), 1.0f / float(height_));
+        glUniform2f(fxaa_->loc("uExtent"), float(renderWidth_) / float(width_), float(renderHeight_) / float(height_));
+        glUniform2f(fxaa_->loc("uWindow"), float(width_), float(height_));
+        drawFullscreen(*fxaa_);
+    }
+    else
+    {
+        const bool full = renderWidth_ == width_ && renderHeight_ == height_;
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo_);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, renderWidth_, renderHeight_, 0, 0, width_, height_,
+                          GL_COLOR_BUFFER_BIT, full ? GL_NEAREST : GL_LINEAR);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, width_, height_);
+}
+
+void DynamicResolution::releaseTargets()
+{
+    const GLuint fbos[3] = { msaaFbo_, fbo_, historyFbo_ };
+    for (GLuint fbo : fbos)
+    {
+        if (fbo) glDeleteFramebuffers(1, &fbo);
+    }
+    const GLuint rbos[3] = { msaaColor_, msaaDepth_, depth_ };
+    for (GLuint rbo : rbos)
+    {
+        if (rbo) glDeleteRenderbuffers(1, &rbo);
+    }
+    if (colorTex_) glDeleteTextures(1, &colorTex_);
+    if (historyTex_) glDeleteTextures(1, &historyTex_);
+    msaaFbo_ = fbo_ = historyFbo_ = 0;
+    msaaColor_ = msaaDepth_ = depth_ = colorTex_ = historyTex_ = 0;
+    width_ = height_ = samples_ = 0;
+}
+
+void DynamicResolution::shutdown()
+{
+    releaseTargets();
+    if (vao_)
+    {
+        glDeleteVertexArrays(1, &vao_);
+        vao_ = 0;
+    }
+    fxaa_.reset();
+    accumulateShader_.reset();
+    active_ = false;
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <glm/vec2.hpp>
+
+#include "gfx/Shader.hpp"
+
+// Offscreen scene target with selectable antialiasing and a resolution scale driven by
+// a frame-time controller.
+//
+// The scene renders into the lower-left scale * window pixels of targets allocated at
+// window size (so scale changes never reallocate). present() resolves and stretches the
+// image over the window; the overlay then draws on top at full resolution. Only the
+// targets the antialiasing mode needs are allocated:
+//   Off       color + depth
+//   MsaaN     plus N-sample color + depth, resolved explicitly before the upscale
+//   Fxaa      plain targets; the upscale runs the FXAA filter
+//   Temporal  plus a float history; a still camera renders jittered frames that are
+//             averaged into it (kTemporalFrames to converge)
+//
+// While the camera is being dragged the controller trades resolution for frame time
+// and MSAA/accumulation are dropped; once the camera has been still for kRefineDelay
+// frames render at full resolution with the selected mode.
+class DynamicResolution {
+public:
+    enum class Antialiasing : uint8_t { Off, Msaa2, Msaa4, Msaa8, Fxaa, Temporal };
+    static const char* Name(Antialiasing mode);
+
+    static constexpr float kMinScale = 0.5f;
+    static constexpr double kRefineDelay = 0.3;   // seconds of stillness before refining
+    static constexpr double kDefaultTargetMs = 14.0; // a little headroom under 60 Hz
+    static constexpr int kTemporalFrames = 16;
+    // GL_DEPTH24_STENCIL8; WeightedOit blits the scene depth into a copy of this format
+    static constexpr unsigned int kDepthFormat = 0x88F0;
+
+    DynamicResolution() = default;
+    ~DynamicResolution();
+    DynamicResolution(const DynamicResolution&) = delete;
+    DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+    void init();
+
+    // Feed the last measured GPU frame time; returns true when the quality level changed
+    // and a frame should be rendered even without input (refinement after a drag).
+    bool update(double gpuMs, bool interacting, double dt);
+
+    void setTargetMs(double ms) { targetMs_ = ms; }
+    double targetMs() const { return targetMs_; }
+    // Takes effect (and reallocates) at the next begin()
+    void setAntialiasing(Antialiasing mode) { aa_ = mode; }
+    Antialiasing antialiasing() const { return aa_; }
+    bool refined() const { return refined_; }
+    float scale() const { return refined_ ? 1.0f : scale_; }
+
+    // Temporal mode: the picture changed under a still camera, start averaging again
+    void resetHistory() { historyFrames_ = 0; }
+    // Temporal mode still needs frames of the current view to converge
+    bool converging() const { return aa_ == Antialiasing::Temporal && refined_ && historyFrames_ < kTemporalFrames; }
+    // Sub-pixel projection offset in NDC for the frame being rendered (Camera::setJitter)
+    const glm::vec2& jitter() const { return jitter_; }
+
+    // Bind the scene target at the current scale for a window of the given size
+    void begin(int windowWidth, int windowHeight);
+    // Resolve, accumulate or filter, and upscale into the default framebuffer; restores
+    // the full viewport (once per begin)
+    void present();
+    int width() const { return renderWidth_; }   // scene size of the current frame
+    int height() const { return renderHeight_; }
+
+    void shutdown();
+
+private:
+    static constexpr int kStaleFrames = 4; // GPU times arrive a few frames late
+
+    GLuint msaaFbo_ = 0, msaaColor_ = 0, msaaDepth_ = 0;  // MSAA modes only
+    GLuint fbo_ = 0, colorTex_ = 0, depth_ = 0;
+    GLuint historyFbo_ = 0, historyTex_ = 0;              // temporal mode only
+    GLuint vao_ = 0;   // empty; full-screen passes use gl_VertexID
+    int width_ = 0, height_ = 0, samples_ = 0;            // allocated
+    int maxSamples_ = 0;
+    int renderWidth_ = 0, renderHeight_ = 0;
+    bool multisampled_ = false;               // this frame renders into msaaFbo_
+    bool accumulate_ = false;                 // this frame is averaged into the history
+    bool active_ = false;                     // between begin() and present()
+    std::unique_ptr<Shader> fxaa_, accumulateShader_;
+
+    Antialiasing aa_ = Antialiasing::Msaa4;
+    double targetMs_ = kDefaultTargetMs;
+    float scale_ = 1.0f;
+    bool refined_ = true;
+    double stillTime_ = kRefineDelay;
+    int staleFrames_ = 0;
+    int historyFrames_ = 0;
+    glm::vec2 jitter_{0.0f};
+
+    void allocate(int width, int height, int samples, bool history);
+    void drawFullscreen(const Shader& shader) const;
+    void releaseTargets();
+};
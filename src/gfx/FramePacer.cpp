@@ -0,0 +1,50 @@
+#include "gfx/FramePacer.hpp"
+#include "core/Input.hpp"
+
+void FramePacer::begin()
+{
+    Frame& f = frames_[index_];
+    if (!f.fence) return;
+    // The flush bit keeps the wait from stalling on commands that never reach the GPU
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    for (;;)
+    {
+        const GLenum r = glClientWaitSync(f.fence, flags, 100000000); // 100 ms
+        if (r != GL_TIMEOUT_EXPIRED) break;
+        flags = 0;
+    }
+    retire(f);
+}
+
+void FramePacer::end(double inputTime)
+{
+    // Pick up frames that already finished, so their latency is not read a frame late
+    for (Frame& f : frames_)
+    {
+        if (f.fence && glClientWaitSync(f.fence, 0, 0) != GL_TIMEOUT_EXPIRED) retire(f);
+    }
+    Frame& f = frames_[index_];
+    f.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    f.inputTime = inputTime;
+    index_ = (index_ + 1) % kMaxFramesInFlight;
+}
+
+void FramePacer::retire(Frame& f)
+{
+    if (f.inputTime > 0.0)
+    {
+        const double ms = (Input::Now() - f.inputTime) * 1000.0;
+        latencyMs_ = latencyMs_ > 0.0 ? latencyMs_ * 0.8 + ms * 0.2 : ms;
+    }
+    glDeleteSync(f.fence);
+    f = Frame();
+}
+
+void FramePacer::shutdown()
+{
+    for (Frame& f : frames_)
+    {
+        if (f.fence) glDeleteSync(f.fence);
+        f = Frame();
+    }
+}
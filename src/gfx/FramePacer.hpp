@@ -0,0 +1,34 @@
+#pragma once
+#include <glad/glad.h>
+
+// Bounds how far the CPU may run ahead of the GPU. end() fences each frame's commands;
+// begin() waits for the fence of the frame kMaxFramesInFlight back, so a camera latched
+// after it reaches the screen within that many frames instead of however many the
+// driver would queue. Frames that carried camera input also yield an input-to-photon
+// estimate: event time to the moment the CPU sees the frame's fence signal (scanout
+// adds up to one more refresh).
+class FramePacer {
+public:
+    static constexpr int kMaxFramesInFlight = 2;
+
+    ~FramePacer() { shutdown(); }
+
+    void begin();
+    // inputTime: Input::Now() stamp of the oldest event this frame shows, 0 for none
+    void end(double inputTime);
+    void shutdown();
+
+    // Smoothed, 0 until a frame with input has completed
+    double latencyMs() const { return latencyMs_; }
+
+private:
+    struct Frame {
+        GLsync fence = nullptr;
+        double inputTime = 0.0;
+    };
+    void retire(Frame& f);
+
+    Frame frames_[kMaxFramesInFlight];
+    int index_ = 0;
+    double latencyMs_ = 0.0;
+};
@@ -0,0 +1,78 @@
+#include "gfx/GLExt.hpp"
+
+#include <GLFW/glfw3.h>
+
+#include <cstring>
+
+int GLExt::version_ = 0;
+GLExt::DispatchComputeFn GLExt::DispatchCompute = nullptr;
+GLExt::BarrierFn GLExt::Barrier = nullptr;
+GLExt::MultiDrawArraysIndirectFn GLExt::MultiDrawArraysIndirect = nullptr;
+GLExt::MultiDrawArraysIndirectCountFn GLExt::MultiDrawArraysIndirectCount = nullptr;
+GLExt::GetProgramBinaryFn GLExt::GetProgramBinary = nullptr;
+GLExt::ProgramBinaryFn GLExt::ProgramBinary = nullptr;
+GLExt::ProgramParameteriFn GLExt::ProgramParameteri = nullptr;
+bool GLExt::parallelCompile_ = false;
+
+static bool hasExtension(const char* name)
+{
+    GLint n = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &n);
+    for (GLint i = 0; i < n; ++i)
+    {
+        const char* ext = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, (GLuint)i));
+        if (ext && std::strcmp(ext, name) == 0) return true;
+    }
+    return false;
+}
+
+void GLExt::Init()
+{
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    version_ = major * 10 + minor;
+
+    DispatchCompute = nullptr;
+    Barrier = nullptr;
+    MultiDrawArraysIndirect = nullptr;
+    MultiDrawArraysIndirectCount = nullptr;
+    GetProgramBinary = nullptr;
+    ProgramBinary = nullptr;
+    ProgramParameteri = nullptr;
+    parallelCompile_ = false;
+
+    // Program binaries back the on-disk shader cache (see ShaderCache)
+    GLint binaryFormats = 0;
+    if (version_ >= 41 || hasExtension("GL_ARB_get_program_binary"))
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormats);
+    if (binaryFormats > 0)
+    {
+        GetProgramBinary = (GetProgramBinaryFn)glfwGetProcAddress("glGetProgramBinary");
+        ProgramBinary = (ProgramBinaryFn)glfwGetProcAddress("glProgramBinary");
+        ProgramParameteri = (ProgramParameteriFn)glfwGetProcAddress("glProgramParameteri");
+    }
+
+    // Let the driver pick the number of compiler threads
+    using MaxShaderCompilerThreadsFn = void (APIENTRYP)(GLuint count);
+    MaxShaderCompilerThreadsFn maxThreads = nullptr;
+    if (hasExtension("GL_KHR_parallel_shader_compile"))
+        maxThreads = (MaxShaderCompilerThreadsFn)glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+    else if (hasExtension("GL_ARB_parallel_shader_compile"))
+        maxThreads = (MaxShaderCompilerThreadsFn)glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+    if (maxThreads)
+    {
+        maxThreads(0xFFFFFFFFu);
+        parallelCompile_ = true;
+    }
+
+    if (version_ < 43) return;
+
+    DispatchCompute = (DispatchComputeFn)glfwGetProcAddress("glDispatchCompute");
+    Barrier = (BarrierFn)glfwGetProcAddress("glMemoryBarrier");
+    MultiDrawArraysIndirect = (MultiDrawArraysIndirectFn)glfwGetProcAddress("glMultiDrawArraysIndirect");
+    if (version_ >= 46)
+        MultiDrawArraysIndirectCount = (MultiDrawArraysIndirectCountFn)glfwGetProcAddress("glMultiDrawArraysIndirectCount");
+    else if (hasExtension("GL_ARB_indirect_parameters"))
+        MultiDrawArraysIndirectCount = (MultiDrawArraysIndirectCountFn)glfwGetProcAddress("glMultiDrawArraysIndirectCountARB");
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <glad/glad.h>
+
+// OpenGL 4.3+ entry points for optional render paths. glad is generated for 3.3 core,
+// so these are loaded separately once the context is current and stay null on older
+// contexts; callers check the Has* queries and keep their 3.3 path as the fallback.
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+#ifndef GL_PARAMETER_BUFFER
+#define GL_PARAMETER_BUFFER 0x80EE
+#endif
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+#ifndef GL_COMMAND_BARRIER_BIT
+#define GL_COMMAND_BARRIER_BIT 0x00000040
+#endif
+#ifndef GL_SHADER_STORAGE_BARRIER_BIT
+#define GL_SHADER_STORAGE_BARRIER_BIT 0x00002000
+#endif
+#ifndef GL_ANY_SAMPLES_PASSED_CONSERVATIVE
+#define GL_ANY_SAMPLES_PASSED_CONSERVATIVE 0x8D6A
+#endif
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+class GLExt {
+public:
+    // Call once after context creation (Renderer::Init does)
+    static void Init();
+
+    static int  Version() { return version_; } // major * 10 + minor
+    static bool HasComputeIndirect() { return DispatchCompute && Barrier && MultiDrawArraysIndirect; }
+    static bool HasIndirectCount() { return MultiDrawArraysIndirectCount != nullptr; }
+    // Occlusion query target: the conservative variant (4.3) where available
+    static GLenum AnySamplesTarget() { return version_ >= 43 ? GL_ANY_SAMPLES_PASSED_CONSERVATIVE : GL_ANY_SAMPLES_PASSED; }
+    // glGetProgramBinary/glProgramBinary (GL 4.1 or ARB_get_program_binary) with at least one format
+    static bool HasProgramBinary() { return GetProgramBinary && ProgramBinary && ProgramParameteri; }
+    // KHR/ARB_parallel_shader_compile: compiles and links return at once and
+    // GL_COMPLETION_STATUS_KHR can be polled without blocking
+    static bool HasParallelCompile() { return parallelCompile_; }
+
+    using DispatchComputeFn = void (APIENTRYP)(GLuint x, GLuint y, GLuint z);
+    using BarrierFn = void (APIENTRYP)(GLbitfield barriers);
+    using MultiDrawArraysIndirectFn = void (APIENTRYP)(GLenum mode, const void* indirect, GLsizei drawCount, GLsizei stride);
+    using MultiDrawArraysIndirectCountFn = void (APIENTRYP)(GLenum mode, const void* indirect, GLintptr drawCount,
+                                                            GLsizei maxDrawCount, GLsizei stride);
+
+    static DispatchComputeFn DispatchCompute;
+    static BarrierFn Barrier;          // glMemoryBarrier (name clashes with a Windows macro)
+    static MultiDrawArraysIndirectFn MultiDrawArraysIndirect;
+    static MultiDrawArraysIndirectCountFn MultiDrawArraysIndirectCount; // GL 4.6 or ARB_indirect_parameters
+
+    using GetProgramBinaryFn = void (APIENTRYP)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* format,
+                                                void* binary);
+    using ProgramBinaryFn = void (APIENTRYP)(GLuint program, GLenum format, const void* binary, GLsizei length);
+    using ProgramParameteriFn = void (APIENTRYP)(GLuint program, GLenum pname, GLint value);
+
+    static GetProgramBinaryFn GetProgramBinary;
+    static ProgramBinaryFn ProgramBinary;
+    static ProgramParameteriFn ProgramParameteri;
+
+private:
+    static int version_;
+    static bool parallelCompile_;
+};
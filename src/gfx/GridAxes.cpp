@@ -64,22 +64,23 @@ void GridAxes::init(int halfLines, float spacing)
     shader_ = Shader::FromFiles("assets/shaders/line.vert", "assets/shaders/line.frag");
 }
 
-void GridAxes::render(const Camera& cam) 
+void GridAxes::submit(RenderQueue& queue)
 {
     if (!vao_) return;
+    // Background pass: no depth writes, to reduce z-fighting with the scene
+    queue.submit(RenderQueue::MakeKey(RenderQueue::Pass::Background, shader_->id(), 0, 0.0f), this, 0);
+}
 
+void GridAxes::bind(RenderQueue::Pass) const
+{
+    // View and projection come from the per-frame uniform block
     shader_->use();
-    glUniformMatrix4fv(shader_->loc("uView"), 1, GL_FALSE, &cam.view()[0][0]);
-    glUniformMatrix4fv(shader_->loc("uProj"), 1, GL_FALSE, &cam.proj()[0][0]);
-
-    // Draw grid without writing depth to reduce z-fighting with the scene
-    GLboolean depthMask = GL_TRUE;
-    glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
-    glDepthMask(GL_FALSE);
     glBindVertexArray(vao_);
+}
+
+void GridAxes::draw(uint32_t) const
+{
     glDrawArrays(GL_LINES, 0, gridVertexCount_);
-    glBindVertexArray(0);
-    glDepthMask(depthMask);
 }
 
 void GridAxes::shutdown() 
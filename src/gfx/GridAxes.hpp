@@ -6,17 +6,23 @@
 
 #include "Shader.hpp"
 #include "core/Camera.hpp"
+#include "gfx/RenderQueue.hpp"
 
 
-class GridAxes {
+class GridAxes : public RenderQueue::Submitter {
 public:
     GridAxes() = default;
     ~GridAxes();
 
     void init(int halfLines = 10, float spacing = 1.0f);
-    void render(const Camera& cam);
+    // Drawn in the background pass (depth tested, no depth writes)
+    void submit(RenderQueue& queue);
     void shutdown();
 
+    // RenderQueue::Submitter
+    void bind(RenderQueue::Pass pass) const override;
+    void draw(uint32_t item) const override;
+
 private:
     GLuint vao_ = 0, vbo_ = 0;
     GLsizei gridVertexCount_ = 0;
@@ -1,13 +1,21 @@
 #include "gfx/Model.hpp"
 #include "gfx/Shader.hpp"
+#include "gfx/GLExt.hpp"
+#include "core/ThreadPool.hpp"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
 #include <glm/gtc/type_ptr.hpp>
 #include <limits>
+#include <cmath>
+#include <tuple>
+#include <type_traits>
 #include <cctype>
 #include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <unordered_map>
 
 // tinygltf: header-only glTF 2.0 loader (enable STB image for textures)
@@ -33,6 +41,16 @@ void Model::shutdown()
         glDeleteVertexArrays(1, &vao_); 
         vao_ = 0; 
     }
+    if (posVbo_)
+    {
+        glDeleteBuffers(1, &posVbo_);
+        posVbo_ = 0;
+    }
+    if (depthVao_)
+    {
+        glDeleteVertexArrays(1, &depthVao_);
+        depthVao_ = 0;
+    }
     if (!textures_.empty())
     {
         glDeleteTextures((GLsizei)textures_.size(), textures_.data());
@@ -40,6 +58,51 @@ void Model::shutdown()
     }
     vertexCount_ = 0;
     draws_.clear();
+    opaqueCount_ = 0;
+    locs_.clear();
+    bvh_.Clear();
+    bvhDraws_.clear();
+    occluderTris_.clear();
+    visibleDraws_ = 0;
+    materials_.shutdown();
+    releaseBatch();
+    releaseQueries();
+    drawHashes_.clear();
+    imageHashes_.clear();
+    gltfTextures_.clear();
+    sourceFiles_.clear();
+    releaseAnimation();
+}
+
+void Model::releaseAnimation()
+{
+    releaseAnimationBuffers();
+    morphWeights_.clear();
+    graph_.clear();
+    animator_.setClip(nullptr);
+    clips_.clear();
+    activeClip_ = -1;
+    jointNodes_.clear();
+    inverseBind_.clear();
+    jointMatrices_.clear();
+}
+
+void Model::releaseAnimationBuffers()
+{
+    if (vao_)
+    {
+        glBindVertexArray(vao_);
+        for (GLuint a = 5; a <= 7; ++a) glDisableVertexAttribArray(a);
+        glBindVertexArray(0);
+    }
+    if (skinVbo_) { glDeleteBuffers(1, &skinVbo_); skinVbo_ = 0; }
+    if (jointBuffer_) { glDeleteBuffers(1, &jointBuffer_); jointBuffer_ = 0; }
+    if (jointTex_) { glDeleteTextures(1, &jointTex_); jointTex_ = 0; }
+    if (morphVbo_) { glDeleteBuffers(1, &morphVbo_); morphVbo_ = 0; }
+    if (morphDeltaBuffer_) { glDeleteBuffers(1, &morphDeltaBuffer_); morphDeltaBuffer_ = 0; }
+    if (morphDeltaTex_) { glDeleteTextures(1, &morphDeltaTex_); morphDeltaTex_ = 0; }
+    if (morphWeightBuffer_) { glDeleteBuffers(1, &morphWeightBuffer_); morphWeightBuffer_ = 0; }
+    if (morphWeightTex_) { glDeleteTextures(1, &morphWeightTex_); morphWeightTex_ = 0; }
 }
 
 
@@ -55,57 +118,165 @@ static std::string toLowerExt(const std::string& path)
 bool Model::load(const std::string& path)
 {
     const std::string ext = toLowerExt(path);
+    bool ok = false;
     if (ext == ".gltf" || ext == ".glb")
-        return loadGLTF(path);
-    err_ = "Unsupported file extension: " + ext + "; only .gltf/.glb supported.";
-    return false;
+        ok = loadGLTF(path);
+    else if (ext == ".obj")
+        ok = loadOBJ(path);
+    else if (ext == ".stl")
+        ok = loadSTL(path);
+    else
+    {
+        err_ = "Unsupported file extension: " + ext + "; only .gltf/.glb/.obj/.stl supported.";
+        return false;
+    }
+    path_ = path;
+    if (ok && sourceFiles_.empty()) sourceFiles_.push_back(path);
+    if (ok && (batched_ || gpuDriven_)) buildBatch();
+    return ok;
+}
+
+bool Model::reloadsInPlace() const
+{
+    const std::string ext = toLowerExt(path_);
+    return (ext == ".gltf" || ext == ".glb") && vao_;
+}
+
+bool Model::reload()
+{
+    if (!reloadsInPlace())
+    {
+        err_ = "Reload in place needs a loaded glTF model; load other files into a new Model";
+        return false;
+    }
+    const bool ok = loadGLTFImpl(path_, true);
+    // Texture arrays copy the textures, so they are rebuilt after any change
+    if (ok && (batched_ || gpuDriven_)) buildBatch();
+    return ok;
+}
+
+static uint64_t hashBytes(const void* data, size_t size, uint64_t h = 1469598103934665603ull)
+{
+    // FNV-1a over 8-byte words; only used to detect changes between reloads
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t w;
+        std::memcpy(&w, p + i, 8);
+        h = (h ^ w) * 1099511628211ull;
+    }
+    for (; i < size; ++i) h = (h ^ p[i]) * 1099511628211ull;
+    return h;
 }
 
+namespace {
+
+// tinygltf image callback: images whose encoded bytes match the previous load are
+// not decoded again; their GL texture is kept as is. The encoded bytes are kept, so a
+// texture with no previous counterpart can still decode the image on demand.
+struct ImageLoadContext {
+    const std::vector<uint64_t>* previous = nullptr;
+    std::vector<uint64_t> hashes;
+    std::vector<uint8_t> reused;
+    std::vector<std::vector<unsigned char>> encoded; // skipped images only
+};
+
+bool loadImageIncremental(tinygltf::Image* image, const int index, std::string* err, std::string* warn,
+                          int reqWidth, int reqHeight, const unsigned char* bytes, int size, void* user)
+{
+    auto* ctx = static_cast<ImageLoadContext*>(user);
+    if (index >= (int)ctx->hashes.size())
+    {
+        ctx->hashes.resize(index + 1, 0);
+        ctx->reused.resize(index + 1, 0);
+        ctx->encoded.resize(index + 1);
+    }
+    const uint64_t h = hashBytes(bytes, (size_t)size);
+    ctx->hashes[index] = h;
+    if (ctx->previous && index < (int)ctx->previous->size() && (*ctx->previous)[index] == h)
+    {
+        ctx->reused[index] = 1;
+        ctx->encoded[index].assign(bytes, bytes + size);
+        return true;
+    }
+    return tinygltf::LoadImageData(image, index, err, warn, reqWidth, reqHeight, bytes, size, nullptr);
+}
+
+} // namespace
+
+// Decode N components of one element; normalized integers map to [0,1] / [-1,1]
+static bool readComponents(const unsigned char* src, int componentType, bool normalized, int N, float* out)
+{
+    for (int k = 0; k < N; ++k)
+    {
+        switch (componentType)
+        {
+            case TINYGLTF_COMPONENT_TYPE_FLOAT: { float v; std::memcpy(&v, src + 4 * k, 4); out[k] = v; break; }
+            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: { uint16_t v; std::memcpy(&v, src + 2 * k, 2); out[k] = normalized ? v / 65535.0f : float(v); break; }
+            case TINYGLTF_COMPONENT_TYPE_SHORT: { int16_t v; std::memcpy(&v, src + 2 * k, 2); out[k] = normalized ? std::max(v / 32767.0f, -1.0f) : float(v); break; }
+            case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: { uint8_t v = src[k]; out[k] = normalized ? v / 255.0f : float(v); break; }
+            case TINYGLTF_COMPONENT_TYPE_BYTE: { int8_t v = (int8_t)src[k]; out[k] = normalized ? std::max(v / 127.0f, -1.0f) : float(v); break; }
+            default: return false;
+        }
+    }
+    return true;
+}
+
+static size_t componentBytes(int componentType)
+{
+    switch (componentType)
+    {
+        case TINYGLTF_COMPONENT_TYPE_FLOAT:
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: return 4;
+        case TINYGLTF_COMPONENT_TYPE_SHORT:
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: return 2;
+        case TINYGLTF_COMPONENT_TYPE_BYTE:
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: return 1;
+        default: return 0;
+    }
+}
+
+// Read an accessor as floats, including accessors without a buffer view (all zero)
+// and sparse accessors, whose listed elements replace the dense ones.
 static bool readAccessorFloatVecN(const tinygltf::Model& m,
                                   const tinygltf::Accessor& acc,
                                   int N,
                                   std::vector<float>& out)
 {
-    const tinygltf::BufferView& bv = m.bufferViews[acc.bufferView];
-    const tinygltf::Buffer& buf = m.buffers[bv.buffer];
     const size_t count = acc.count;
+    const size_t componentSize = componentBytes(acc.componentType);
+    if (componentSize == 0 || acc.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT) return false;
 
-    size_t componentSize = 0;
-    bool isFloat = false;
-    float normScale = 1.0f;
-    const bool normalized = acc.normalized;
-    switch (acc.componentType)
+    out.assign(count * N, 0.0f);
+    if (acc.bufferView >= 0)
     {
-        case TINYGLTF_COMPONENT_TYPE_FLOAT: componentSize = sizeof(float); isFloat = true; break;
-        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: componentSize = sizeof(uint16_t); normScale = normalized ? (1.0f / 65535.0f) : 1.0f; break;
-        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: componentSize = sizeof(uint8_t); normScale = normalized ? (1.0f / 255.0f) : 1.0f; break;
-        default: return false;
+        const tinygltf::BufferView& bv = m.bufferViews[acc.bufferView];
+        const tinygltf::Buffer& buf = m.buffers[bv.buffer];
+        size_t stride = N * componentSize;
+        if (bv.byteStride) stride = bv.byteStride;
+        const unsigned char* base = buf.data.data() + bv.byteOffset + acc.byteOffset;
+        for (size_t i = 0; i < count; ++i)
+            readComponents(base + i * stride, acc.componentType, acc.normalized, N, &out[i * N]);
     }
 
-    size_t stride = N * componentSize;
-    if (bv.byteStride) stride = bv.byteStride;
-
-    const size_t start = bv.byteOffset + acc.byteOffset;
-    const unsigned char* base = buf.data.data() + start;
-
-    out.resize(count * N);
-    for (size_t i = 0; i < count; ++i)
+    if (acc.sparse.isSparse && acc.sparse.count > 0)
     {
-        const unsigned char* src = base + i * stride;
-        if (isFloat)
-        {
-            const float* fsrc = reinterpret_cast<const float*>(src);
-            for (int k = 0; k < N; ++k) out[i * N + k] = fsrc[k];
-        }
-        else if (acc.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT)
+        const auto& sp = acc.sparse;
+        if (sp.indices.bufferView < 0 || sp.values.bufferView < 0) return false;
+        const tinygltf::BufferView& ibv = m.bufferViews[sp.indices.bufferView];
+        const tinygltf::BufferView& vbv = m.bufferViews[sp.values.bufferView];
+        const unsigned char* ip = m.buffers[ibv.buffer].data.data() + ibv.byteOffset + sp.indices.byteOffset;
+        const unsigned char* vp = m.buffers[vbv.buffer].data.data() + vbv.byteOffset + sp.values.byteOffset;
+        const size_t isize = componentBytes(sp.indices.componentType);
+        for (int i = 0; i < sp.count; ++i)
         {
-            const uint16_t* p = reinterpret_cast<const uint16_t*>(src);
-            for (int k = 0; k < N; ++k) out[i * N + k] = normalized ? (p[k] * normScale) : float(p[k]);
-        }
-        else // UNSIGNED_BYTE
-        {
-            const uint8_t* p = reinterpret_cast<const uint8_t*>(src);
-            for (int k = 0; k < N; ++k) out[i * N + k] = normalized ? (p[k] * normScale) : float(p[k]);
+            uint32_t index = 0;
+            if (isize == 1) index = ip[i];
+            else if (isize == 2) { uint16_t v; std::memcpy(&v, ip + 2 * i, 2); index = v; }
+            else { std::memcpy(&index, ip + 4 * i, 4); }
+            if (index >= count) continue;
+            readComponents(vp + size_t(i) * N * componentSize, acc.componentType, acc.normalized, N, &out[size_t(index) * N]);
         }
     }
     return true;
@@ -141,6 +312,168 @@ static bool readIndices(const tinygltf::Model& m, const tinygltf::Accessor& acc,
     }
 }
 
+// Per-vertex tangents for an indexed triangle list (Lengyel's method, as MikkTSpace
+// without vertex splitting). Passes are laid out as flat SoA loops so the per-triangle
+// and per-vertex math vectorizes; only the scatter into shared vertices is serial.
+static void generateTangents(const std::vector<float>& pos, const std::vector<float>& nrm,
+                             const std::vector<float>& uv, const std::vector<uint32_t>& indices,
+                             std::vector<glm::vec4>& out)
+{
+    const size_t vcount = pos.size() / 3;
+    const size_t tcount = indices.size() / 3;
+    constexpr size_t kMinChunk = 1u << 14;
+
+    // Pass 1: unnormalized tangent (s) and bitangent (t) directions per triangle
+    std::vector<float> sx(tcount), sy(tcount), sz(tcount), tx(tcount), ty(tcount), tz(tcount);
+    ThreadPool::Get().ParallelFor(tcount, kMinChunk, [&](size_t b, size_t e) {
+        const uint32_t* idx = indices.data();
+        const float* P = pos.data();
+        const float* T = uv.data();
+        for (size_t t = b; t < e; ++t)
+        {
+            const uint32_t i0 = idx[3*t+0], i1 = idx[3*t+1], i2 = idx[3*t+2];
+            const float e1x = P[3*i1+0] - P[3*i0+0], e1y = P[3*i1+1] - P[3*i0+1], e1z = P[3*i1+2] - P[3*i0+2];
+            const float e2x = P[3*i2+0] - P[3*i0+0], e2y = P[3*i2+1] - P[3*i0+1], e2z = P[3*i2+2] - P[3*i0+2];
+            const float du1 = T[2*i1+0] - T[2*i0+0], dv1 = T[2*i1+1] - T[2*i0+1];
+            const float du2 = T[2*i2+0] - T[2*i0+0], dv2 = T[2*i2+1] - T[2*i0+1];
+            const float det = du1 * dv2 - du2 * dv1;
+            const float r = (std::fabs(det) > 1e-20f) ? 1.0f / det : 0.0f;
+            sx[t] = (e1x * dv2 - e2x * dv1) * r; sy[t] = (e1y * dv2 - e2y * dv1) * r; sz[t] = (e1z * dv2 - e2z * dv1) * r;
+            tx[t] = (e2x * du1 - e1x * du2) * r; ty[t] = (e2y * du1 - e1y * du2) * r; tz[t] = (e2z * du1 - e1z * du2) * r;
+        }
+    });
+
+    // Pass 2: accumulate onto shared vertices
+    std::vector<float> as(vcount * 3, 0.0f), at(vcount * 3, 0.0f);
+    for (size_t t = 0; t < tcount; ++t)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            const uint32_t v = indices[3*t+k];
+            as[3*v+0] += sx[t]; as[3*v+1] += sy[t]; as[3*v+2] += sz[t];
+            at[3*v+0] += tx[t]; at[3*v+1] += ty[t]; at[3*v+2] += tz[t];
+        }
+    }
+
+    // Pass 3: Gram-Schmidt against the normal, handedness from the bitangent
+    out.resize(vcount);
+    ThreadPool::Get().ParallelFor(vcount, kMinChunk, [&](size_t b, size_t e) {
+        for (size_t v = b; v < e; ++v)
+        {
+            const glm::vec3 n = nrm.empty() ? glm::vec3(0.0f) : glm::vec3(nrm[3*v+0], nrm[3*v+1], nrm[3*v+2]);
+            const glm::vec3 s(as[3*v+0], as[3*v+1], as[3*v+2]);
+            const glm::vec3 t(at[3*v+0], at[3*v+1], at[3*v+2]);
+            glm::vec3 tan = s - n * glm::dot(n, s);
+            const float len = glm::length(tan);
+            tan = (len > 1e-20f) ? tan / len : glm::vec3(1, 0, 0);
+            const float w = (glm::dot(glm::cross(n, tan), t) < 0.0f) ? -1.0f : 1.0f;
+            out[v] = glm::vec4(tan, w);
+        }
+    });
+}
+
+// Generated tangents are cooked into "<file>.tangents", keyed by (mesh, primitive).
+// Each entry carries a hash of the data it was generated from (positions, normals,
+// UVs, indices), so re-exported buffers miss even when only an external .bin changed.
+namespace {
+
+constexpr char kTangentMagic[8] = { 'M','V','T','A','N','G','0','2' };
+
+struct TangentCacheHeader {
+    char magic[8];
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+struct TangentCacheEntry {
+    int32_t mesh;
+    int32_t primitive;
+    uint64_t vertexCount;
+    uint64_t sourceHash;
+};
+
+struct CachedTangents {
+    uint64_t sourceHash = 0;
+    std::vector<glm::vec4> tangents;
+};
+using TangentMap = std::unordered_map<uint64_t, CachedTangents>;
+
+uint64_t tangentKey(int mesh, int primitive)
+{
+    return (uint64_t(uint32_t(mesh)) << 32) | uint32_t(primitive);
+}
+
+// Layout and bytes of one accessor (sparse substitutions are not included)
+uint64_t hashAccessor(const tinygltf::Model& gltf, int index, uint64_t h)
+{
+    if (index < 0 || index >= (int)gltf.accessors.size()) return hashBytes(&index, sizeof(index), h);
+    const tinygltf::Accessor& a = gltf.accessors[index];
+    const uint64_t shape[4] = { (uint64_t)a.count, (uint64_t)a.componentType, (uint64_t)a.type, (uint64_t)a.normalized };
+    h = hashBytes(shape, sizeof(shape), h);
+    if (a.bufferView < 0 || a.bufferView >= (int)gltf.bufferViews.size()) return h;
+    const tinygltf::BufferView& v = gltf.bufferViews[a.bufferView];
+    if (v.buffer < 0 || v.buffer >= (int)gltf.buffers.size()) return h;
+    const std::vector<unsigned char>& data = gltf.buffers[v.buffer].data;
+    const size_t begin = v.byteOffset + a.byteOffset;
+    const size_t end = std::min(data.size(), v.byteOffset + v.byteLength);
+    return begin < end ? hashBytes(data.data() + begin, end - begin, h) : h;
+}
+
+uint64_t tangentSourceHash(const tinygltf::Model& gltf, const tinygltf::Primitive& prim, int texCoord)
+{
+    auto attribute = [&](const std::string& name) {
+        auto it = prim.attributes.find(name);
+        return it != prim.attributes.end() ? it->second : -1;
+    };
+    uint64_t h = hashAccessor(gltf, attribute("POSITION"), 1469598103934665603ull);
+    h = hashAccessor(gltf, attribute("NORMAL"), h);
+    h = hashAccessor(gltf, attribute("TEXCOORD_" + std::to_string(texCoord)), h);
+    return hashAccessor(gltf, prim.indices, h);
+}
+
+void loadTangentCache(const std::string& path, TangentMap& out)
+{
+    std::ifstream in(path + ".tangents", std::ios::binary | std::ios::ate);
+    if (!in) return;
+    uint64_t remaining = (uint64_t)in.tellg();
+    in.seekg(0);
+    TangentCacheHeader h{};
+    if (!in.read(reinterpret_cast<char*>(&h), sizeof(h)) || std::memcmp(h.magic, kTangentMagic, sizeof(h.magic)) != 0)
+        return;
+    remaining -= sizeof(h);
+    for (uint32_t i = 0; i < h.entryCount; ++i)
+    {
+        TangentCacheEntry e{};
+        if (remaining < sizeof(e) || !in.read(reinterpret_cast<char*>(&e), sizeof(e))) { out.clear(); return; }
+        remaining -= sizeof(e);
+        // A corrupt count must not turn into an allocation the file cannot back
+        if (e.vertexCount > remaining / sizeof(glm::vec4)) { out.clear(); return; }
+        CachedTangents& c = out[tangentKey(e.mesh, e.primitive)];
+        c.sourceHash = e.sourceHash;
+        c.tangents.resize(e.vertexCount);
+        if (!in.read(reinterpret_cast<char*>(c.tangents.data()), std::streamsize(e.vertexCount * sizeof(glm::vec4)))) { out.clear(); return; }
+        remaining -= e.vertexCount * sizeof(glm::vec4);
+    }
+}
+
+void saveTangentCache(const std::string& path, const TangentMap& tangents)
+{
+    std::ofstream out(path + ".tangents", std::ios::binary | std::ios::trunc);
+    if (!out) return; // read-only asset folders just skip the cache
+    TangentCacheHeader h{};
+    std::memcpy(h.magic, kTangentMagic, sizeof(h.magic));
+    h.entryCount = (uint32_t)tangents.size();
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    for (const auto& kv : tangents)
+    {
+        const TangentCacheEntry e{ int32_t(kv.first >> 32), int32_t(kv.first & 0xFFFFFFFFu), kv.second.tangents.size(), kv.second.sourceHash };
+        out.write(reinterpret_cast<const char*>(&e), sizeof(e));
+        out.write(reinterpret_cast<const char*>(kv.second.tangents.data()), std::streamsize(kv.second.tangents.size() * sizeof(glm::vec4)));
+    }
+}
+
+} // namespace
+
 static glm::mat4 nodeLocalMatrix(const tinygltf::Node& nd)
 {
     glm::mat4 M(1.0f);
@@ -168,13 +501,22 @@ static glm::mat4 nodeLocalMatrix(const tinygltf::Node& nd)
 
 bool Model::loadGLTF(const std::string& path)
 {
-    shutdown();
+    return loadGLTFImpl(path, false);
+}
+
+bool Model::loadGLTFImpl(const std::string& path, bool incremental)
+{
+    if (!incremental) shutdown();
     err_.clear();
 
     tinygltf::Model gltf;
     tinygltf::TinyGLTF loader;
     std::string warn, err;
 
+    ImageLoadContext images;
+    if (incremental) images.previous = &imageHashes_;
+    loader.SetImageLoader(&loadImageIncremental, &images);
+
     const std::string ext = toLowerExt(path);
     bool ok = false;
     if (ext == ".glb") ok = loader.LoadBinaryFromFile(&gltf, &err, &warn, path);
@@ -183,25 +525,89 @@ bool Model::loadGLTF(const std::string& path)
         // ignore warnings silently
     }
     if (!ok) {
+        // a half-written export fails here; the previous model stays on screen
         err_ = err.empty() ? "Failed to load glTF" : err;
         return false;
     }
 
+    // Incremental reload: keep the VAO/VBO and unchanged textures, rebuild everything
+    // else. The previous state is set aside, not released, until the new content turns
+    // out usable, so a failed reload puts it back and the model stays as it was.
+    std::unordered_map<int, TextureRecord> oldTextures;
+    std::vector<unsigned int> oldTextureIds;
+    std::vector<Draw> oldDraws;
+    std::vector<uint64_t> oldDrawHashes, oldImageHashes;
+    std::vector<std::string> oldSourceFiles;
+    SceneGraph oldGraph;
+    std::vector<AnimationClip> oldClips;
+    std::vector<int> oldJointNodes;
+    std::vector<glm::mat4> oldInverseBind;
+    std::vector<float> oldMorphWeights;
+    auto swapPreviousState = [&] {
+        oldTextures.swap(gltfTextures_);
+        oldTextureIds.swap(textures_);
+        oldDraws.swap(draws_);
+        oldDrawHashes.swap(drawHashes_);
+        oldImageHashes.swap(imageHashes_);
+        oldSourceFiles.swap(sourceFiles_);
+        std::swap(oldGraph, graph_);
+        oldClips.swap(clips_);
+        oldJointNodes.swap(jointNodes_);
+        oldInverseBind.swap(inverseBind_);
+        oldMorphWeights.swap(morphWeights_);
+    };
+    if (incremental) swapPreviousState();
+    reloadStats_ = {};
+    reloadStats_.incremental = incremental;
+    imageHashes_ = images.hashes;
+
+    sourceFiles_.assign(1, path);
+    const std::string baseDir = std::filesystem::path(path).parent_path().string();
+    for (const auto& b : gltf.buffers)
+        if (!b.uri.empty() && b.uri.compare(0, 5, "data:") != 0) sourceFiles_.push_back((std::filesystem::path(baseDir) / b.uri).string());
+    for (const auto& im : gltf.images)
+        if (!im.uri.empty() && im.uri.compare(0, 5, "data:") != 0) sourceFiles_.push_back((std::filesystem::path(baseDir) / im.uri).string());
+
     std::vector<Vertex> verts;
     verts.reserve(50000);
 
     glm::vec3 bmin{ std::numeric_limits<float>::max() };
     glm::vec3 bmax{ std::numeric_limits<float>::lowest() };
 
-    std::unordered_map<int, unsigned int> texCache; // gltf texture index -> GL id
+    std::unordered_map<int, unsigned int> texCache; // (gltf texture index, srgb) -> GL id
 
-    auto getOrCreateTexture = [&](int texIndex) -> unsigned int {
+    // Color textures are sRGB; data textures such as normal maps must stay linear
+    auto getOrCreateTexture = [&](int texIndex, bool srgb) -> unsigned int {
         if (texIndex < 0) return 0U;
-        auto it = texCache.find(texIndex);
+        const int cacheKey = texIndex * 2 + (srgb ? 1 : 0);
+        auto it = texCache.find(cacheKey);
         if (it != texCache.end()) return it->second;
         const tinygltf::Texture& tex = gltf.textures[texIndex];
-        if (tex.source < 0) { texCache[texIndex] = 0U; return 0U; }
-        const tinygltf::Image& img = gltf.images[tex.source];
+        if (tex.source < 0) { texCache[cacheKey] = 0U; return 0U; }
+        tinygltf::Image& img = gltf.images[tex.source];
+        ++reloadStats_.texturesTotal;
+
+        // Reuse the previous GL texture while its image and sampler are unchanged. Any
+        // other change gets a new texture; the old one is deleted once the reload succeeds.
+        const uint64_t texHash = hashBytes(&tex.sampler, sizeof(tex.sampler), tex.source < (int)imageHashes_.size() ? imageHashes_[tex.source] : 0);
+        auto old = oldTextures.find(cacheKey);
+        if (old != oldTextures.end() && old->second.hash == texHash)
+        {
+            const unsigned int gltex = old->second.id;
+            texCache[cacheKey] = gltex;
+            textures_.push_back(gltex);
+            gltfTextures_[cacheKey] = {gltex, texHash};
+            return gltex;
+        }
+        // An unchanged image was not decoded; do it now that no old texture stands in
+        if (img.image.empty() && tex.source < (int)images.encoded.size() && !images.encoded[tex.source].empty())
+        {
+            const std::vector<unsigned char>& bytes = images.encoded[tex.source];
+            std::string imageErr, imageWarn;
+            tinygltf::LoadImageData(&img, tex.source, &imageErr, &imageWarn, 0, 0, bytes.data(), (int)bytes.size(), nullptr);
+        }
+        if (img.image.empty()) { texCache[cacheKey] = 0U; return 0U; }
+        ++reloadStats_.texturesUploaded;
         GLenum fmt = GL_RGBA; int comp = img.component;
         if (comp == 3) fmt = GL_RGB; else fmt = GL_RGBA;
         unsigned int gltex = 0;
@@ -222,17 +628,173 @@ bool Model::loadGLTF(const std::string& path)
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magF);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapS);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapT);
-        GLint internal = (fmt == GL_RGB) ? GL_SRGB8 : GL_SRGB8_ALPHA8;
+        GLint internal = srgb ? ((fmt == GL_RGB) ? GL_SRGB8 : GL_SRGB8_ALPHA8) : ((fmt == GL_RGB) ? GL_RGB8 : GL_RGBA8);
         glTexImage2D(GL_TEXTURE_2D, 0, internal, img.width, img.height, 0, fmt, GL_UNSIGNED_BYTE, img.image.data());
         glGenerateMipmap(GL_TEXTURE_2D);
         glBindTexture(GL_TEXTURE_2D, 0);
-        texCache[texIndex] = gltex;
+        texCache[cacheKey] = gltex;
         textures_.push_back(gltex);
+        gltfTextures_[cacheKey] = {gltex, texHash};
         return gltex;
     };
 
-    auto appendPrimitive = [&](const tinygltf::Primitive& prim, const glm::mat4& M)
+    // Nodes driven by an animation channel; they and their subtrees stay dynamic
+    std::vector<uint8_t> animatedNode(gltf.nodes.size(), 0);
+    for (const auto& anim : gltf.animations)
+        for (const auto& ch : anim.channels)
+            if (ch.target_node >= 0 && ch.target_node < (int)gltf.nodes.size() && ch.target_path != "weights")
+                animatedNode[ch.target_node] = 1;
+
+    // Flatten the scene into (mesh, primitive, transform) jobs first so per-primitive
+    // work that does not depend on the instance can run once, in parallel.
+    // Dynamic jobs keep mesh-local vertices and are positioned by their graph node.
+    struct PrimJob { int mesh; int prim; glm::mat4 M; int node; bool dynamic; int skin; int weightBase; };
+    std::vector<PrimJob> jobs;
+    std::vector<int> nodeMap(gltf.nodes.size(), -1); // gltf node -> graph node
+    std::vector<int> nodeWeightBase(gltf.nodes.size(), -1), nodeWeightCount(gltf.nodes.size(), 0);
+    auto traverse = [&](auto&& self, int nodeIndex, const glm::mat4& parentM, int parentNode, bool parentDynamic) -> void {
+        const tinygltf::Node& nd = gltf.nodes[nodeIndex];
+        glm::mat4 local = nodeLocalMatrix(nd);
+        glm::mat4 M = parentM * local;
+        int node;
+        if (nd.matrix.size() == 16)
+        {
+            node = graph_.addNode(parentNode, local);
+        }
+        else
+        {
+            glm::vec3 t(0.0f), sc(1.0f);
+            glm::quat r(1.0f, 0.0f, 0.0f, 0.0f);
+            if (nd.translation.size() == 3) t = glm::vec3(nd.translation[0], nd.translation[1], nd.translation[2]);
+            if (nd.scale.size() == 3) sc = glm::vec3(nd.scale[0], nd.scale[1], nd.scale[2]);
+            if (nd.rotation.size() == 4) r = glm::quat((float)nd.rotation[3], (float)nd.rotation[0], (float)nd.rotation[1], (float)nd.rotation[2]);
+            node = graph_.addNode(parentNode, t, r, sc);
+        }
+        nodeMap[nodeIndex] = node;
+        const bool dynamic = parentDynamic || animatedNode[nodeIndex];
+        if (nd.mesh >= 0)
+        {
+            const tinygltf::Mesh& mesh = gltf.meshes[nd.mesh];
+            const int skin = (nd.skin >= 0 && nd.skin < (int)gltf.skins.size()) ? nd.skin : -1;
+
+            // Morph weights are per node instance; initial values from node, else mesh
+            size_t targets = 0;
+            for (const auto& prim : mesh.primitives) targets = std::max(targets, prim.targets.size());
+            int weightBase = -1;
+            if (targets > 0)
+            {
+                weightBase = (int)morphWeights_.size();
+                const std::vector<double>& w = !nd.weights.empty() ? nd.weights : mesh.weights;
+                for (size_t t = 0; t < targets; ++t) morphWeights_.push_back(t < w.size() ? (float)w[t] : 0.0f);
+                nodeWeightBase[nodeIndex] = weightBase;
+                nodeWeightCount[nodeIndex] = (int)targets;
+            }
+            for (int p = 0; p < (int)mesh.primitives.size(); ++p)
+                jobs.push_back({nd.mesh, p, M, node, dynamic || skin >= 0 || weightBase >= 0, skin, weightBase});
+        }
+        for (int c : nd.children) self(self, c, M, node, dynamic);
+    };
+
+    if (gltf.scenes.empty())
+    {
+        // Fallback: iterate all meshes without transforms
+        for (int m = 0; m < (int)gltf.meshes.size(); ++m)
+            for (int p = 0; p < (int)gltf.meshes[m].primitives.size(); ++p) jobs.push_back({m, p, glm::mat4(1.0f), -1, false, -1, -1});
+    }
+    else
+    {
+        int sceneIndex = gltf.defaultScene >= 0 ? gltf.defaultScene : 0;
+        const tinygltf::Scene& sc = gltf.scenes[sceneIndex];
+        for (int nodeIndex : sc.nodes)
+            traverse(traverse, nodeIndex, glm::mat4(1.0f), -1, false);
+    }
+
+    // Skins: each gets a contiguous range of the global joint palette
+    std::vector<int> skinBase(gltf.skins.size(), -1);
+    for (size_t si = 0; si < gltf.skins.size(); ++si)
+    {
+        const tinygltf::Skin& skin = gltf.skins[si];
+        std::vector<float> ibm;
+        if (skin.inverseBindMatrices >= 0)
+        {
+            const tinygltf::Accessor& acc = gltf.accessors[skin.inverseBindMatrices];
+            if (acc.type == TINYGLTF_TYPE_MAT4) readAccessorFloatVecN(gltf, acc, 16, ibm);
+        }
+        bool valid = !skin.joints.empty();
+        for (int j : skin.joints) valid = valid && j >= 0 && j < (int)nodeMap.size() && nodeMap[j] >= 0;
+        if (!valid) continue; // joints outside the displayed scene: leave the mesh unskinned
+        skinBase[si] = (int)jointNodes_.size();
+        for (size_t j = 0; j < skin.joints.size(); ++j)
+        {
+            jointNodes_.push_back(nodeMap[skin.joints[j]]);
+            inverseBind_.push_back(ibm.size() >= (j + 1) * 16 ? glm::make_mat4(ibm.data() + j * 16) : glm::mat4(1.0f));
+        }
+    }
+    const bool hasSkins = !jointNodes_.empty();
+    std::vector<SkinVertex> skinVerts;
+    const bool hasMorphs = !morphWeights_.empty();
+    std::vector<MorphVertex> morphVerts;
+    std::vector<glm::vec4> morphDeltas;
+
+    // Normal-mapped primitives without a TANGENT attribute get generated tangents,
+    // taken from the cooked cache when it is current
+    auto normalTexCoord = [&](const tinygltf::Primitive& prim) -> int {
+        if (prim.material < 0 || prim.material >= (int)gltf.materials.size()) return -1;
+        const tinygltf::NormalTextureInfo& nt = gltf.materials[prim.material].normalTexture;
+        return nt.index >= 0 ? nt.texCoord : -1;
+    };
+    TangentMap cached, tangents;
+    loadTangentCache(path, cached);
+    std::vector<uint64_t> pending;
+    for (const PrimJob& job : jobs)
+    {
+        const tinygltf::Primitive& prim = gltf.meshes[job.mesh].primitives[job.prim];
+        const int set = normalTexCoord(prim);
+        if (prim.mode != TINYGLTF_MODE_TRIANGLES || set < 0 || prim.attributes.count("TANGENT") ||
+            !prim.attributes.count("POSITION") || !prim.attributes.count("TEXCOORD_" + std::to_string(set)))
+            continue;
+        const uint64_t key = tangentKey(job.mesh, job.prim);
+        if (tangents.count(key)) continue;
+        const uint64_t sourceHash = tangentSourceHash(gltf, prim, set);
+        auto c = cached.find(key);
+        if (c != cached.end() && c->second.sourceHash == sourceHash)
+        {
+            tangents[key] = std::move(c->second);
+            continue;
+        }
+        tangents[key].sourceHash = sourceHash;
+        pending.push_back(key);
+    }
+    ThreadPool::Get().ParallelFor(pending.size(), 1, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i)
+        {
+            const tinygltf::Primitive& prim = gltf.meshes[int(pending[i] >> 32)].primitives[int(pending[i] & 0xFFFFFFFFu)];
+            std::vector<float> pos, nrm, uv;
+            std::vector<uint32_t> indices;
+            const tinygltf::Accessor& accPos = gltf.accessors[prim.attributes.at("POSITION")];
+            const tinygltf::Accessor& accUV = gltf.accessors[prim.attributes.at("TEXCOORD_" + std::to_string(normalTexCoord(prim)))];
+            if (accPos.type != TINYGLTF_TYPE_VEC3 || !readAccessorFloatVecN(gltf, accPos, 3, pos)) continue;
+            if (accUV.type != TINYGLTF_TYPE_VEC2 || !readAccessorFloatVecN(gltf, accUV, 2, uv)) continue;
+            auto itN = prim.attributes.find("NORMAL");
+            if (itN != prim.attributes.end() && gltf.accessors[itN->second].type == TINYGLTF_TYPE_VEC3)
+                readAccessorFloatVecN(gltf, gltf.accessors[itN->second], 3, nrm);
+            if (prim.indices >= 0) readIndices(gltf, gltf.accessors[prim.indices], indices);
+            else
+            {
+                indices.resize(pos.size() / 3 / 3 * 3);
+                for (size_t k = 0; k < indices.size(); ++k) indices[k] = (uint32_t)k;
+            }
+            generateTangents(pos, nrm, uv, indices, tangents.find(pending[i])->second.tangents);
+        }
+    });
+    if (!pending.empty()) saveTangentCache(path, tangents);
+
+    auto appendPrimitive = [&](const tinygltf::Primitive& prim, const PrimJob& job, uint64_t key)
     {
+        // Static geometry is baked into world space; dynamic geometry stays mesh-local.
+        // Skinned vertices are in bind pose, which the joint palette maps to world space.
+        const glm::mat4 M = job.dynamic ? glm::mat4(1.0f) : job.M;
+        const glm::mat4 boundsM = (job.skin >= 0) ? glm::mat4(1.0f) : job.M;
         if (prim.mode != TINYGLTF_MODE_TRIANGLES) return; // skip non-triangles
         auto itPos = prim.attributes.find("POSITION");
         if (itPos == prim.attributes.end()) return;
@@ -279,6 +841,92 @@ bool Model::loadGLTF(const std::string& path)
                 readAccessorFloatVecN(gltf, accUV1, 2, uv1);
         }
 
+        // tangents: shipped TANGENT attribute, else generated above
+        std::vector<float> tanAttr;
+        const std::vector<glm::vec4>* genTan = nullptr;
+        auto itT = prim.attributes.find("TANGENT");
+        if (itT != prim.attributes.end())
+        {
+            const tinygltf::Accessor& accT = gltf.accessors[itT->second];
+            if (accT.type == TINYGLTF_TYPE_VEC4)
+                readAccessorFloatVecN(gltf, accT, 4, tanAttr);
+        }
+        else
+        {
+            auto itG = tangents.find(key);
+            if (itG != tangents.end() && itG->second.tangents.size() == pos.size() / 3) genTan = &itG->second.tangents;
+        }
+
+        // joints/weights for skinned primitives
+        std::vector<float> joints, weights;
+        const int jointBase = (job.skin >= 0) ? skinBase[job.skin] : -1;
+        if (jointBase >= 0)
+        {
+            auto itJ = prim.attributes.find("JOINTS_0");
+            auto itW = prim.attributes.find("WEIGHTS_0");
+            if (itJ != prim.attributes.end() && itW != prim.attributes.end() &&
+                gltf.accessors[itJ->second].type == TINYGLTF_TYPE_VEC4 && gltf.accessors[itW->second].type == TINYGLTF_TYPE_VEC4)
+            {
+                readAccessorFloatVecN(gltf, gltf.accessors[itJ->second], 4, joints);
+                readAccessorFloatVecN(gltf, gltf.accessors[itW->second], 4, weights);
+            }
+            if (joints.size() != pos.size() / 3 * 4 || weights.size() != joints.size()) { joints.clear(); weights.clear(); }
+        }
+        const bool skinned = !joints.empty();
+
+        // morph target deltas, decoded once per source vertex into compact records
+        std::vector<std::vector<float>> morphPos, morphNrm;
+        if (job.weightBase >= 0)
+        {
+            for (const auto& target : prim.targets)
+            {
+                std::vector<float> dp, dn;
+                auto itP = target.find("POSITION");
+                auto itN2 = target.find("NORMAL");
+                if (itP != target.end() && gltf.accessors[itP->second].type == TINYGLTF_TYPE_VEC3)
+                    readAccessorFloatVecN(gltf, gltf.accessors[itP->second], 3, dp);
+                if (itN2 != target.end() && gltf.accessors[itN2->second].type == TINYGLTF_TYPE_VEC3)
+                    readAccessorFloatVecN(gltf, gltf.accessors[itN2->second], 3, dn);
+                if (dp.size() != pos.size()) dp.clear();
+                if (dn.size() != pos.size()) dn.clear();
+                morphPos.push_back(std::move(dp));
+                morphNrm.push_back(std::move(dn));
+            }
+        }
+        const bool morphed = !morphPos.empty();
+        std::vector<MorphVertex> srcMorph(morphed ? pos.size() / 3 : 0);
+        std::vector<uint8_t> srcMorphDone(srcMorph.size(), 0);
+        auto getMorph = [&](size_t i){
+            if (!morphed) return MorphVertex{};
+            if (srcMorphDone[i]) return srcMorph[i];
+            MorphVertex mv;
+            mv.first = (uint32_t)(morphDeltas.size() / 2);
+            for (size_t t = 0; t < morphPos.size(); ++t)
+            {
+                const glm::vec3 dp = morphPos[t].empty() ? glm::vec3(0.0f) : glm::vec3(morphPos[t][3*i+0], morphPos[t][3*i+1], morphPos[t][3*i+2]);
+                const glm::vec3 dn = morphNrm[t].empty() ? glm::vec3(0.0f) : glm::vec3(morphNrm[t][3*i+0], morphNrm[t][3*i+1], morphNrm[t][3*i+2]);
+                if (dp == glm::vec3(0.0f) && dn == glm::vec3(0.0f)) continue;
+                morphDeltas.push_back(glm::vec4(dp, float(job.weightBase + (int)t)));
+                morphDeltas.push_back(glm::vec4(dn, 0.0f));
+                ++mv.count;
+            }
+            srcMorph[i] = mv;
+            srcMorphDone[i] = 1;
+            return mv;
+        };
+        auto getSkin = [&](size_t i){
+            SkinVertex sv{};
+            if (!skinned) return sv;
+            float sum = weights[4*i+0] + weights[4*i+1] + weights[4*i+2] + weights[4*i+3];
+            const float inv = (sum > 1e-8f) ? 1.0f / sum : 0.0f;
+            for (int k = 0; k < 4; ++k)
+            {
+                sv.joints[k] = uint16_t(jointBase + (int)joints[4*i+k]);
+                sv.weights[k] = weights[4*i+k] * inv;
+            }
+            return sv;
+        };
+
         // indices optional
         std::vector<uint32_t> indices;
         bool hasIndices = prim.indices >= 0;
@@ -314,6 +962,8 @@ bool Model::loadGLTF(const std::string& path)
         float uvRotate = 0.0f;
         bool doBlend = false;
         glm::vec4 baseColorFactor(1.0f);
+        unsigned int normalTex = 0;
+        float normalScale = 1.0f;
         if (prim.material >= 0 && prim.material < (int)gltf.materials.size())
         {
             const tinygltf::Material& mat = gltf.materials[prim.material];
@@ -337,31 +987,51 @@ bool Model::loadGLTF(const std::string& path)
             auto extIt = bct.extensions.find("KHR_texture_transform");
             if (extIt != bct.extensions.end())
             {
-                const tinygltf::Value& ext = extIt->second;
-                if (ext.Has("scale"))
+                const tinygltf::Value& xform = extIt->second;
+                if (xform.Has("scale"))
                 {
-                    const auto& a = ext.Get("scale");
+                    const auto& a = xform.Get("scale");
                     if (a.IsArray() && a.ArrayLen() >= 2)
                         uvScale = glm::vec2((float)a.Get(0).GetNumberAsDouble(), (float)a.Get(1).GetNumberAsDouble());
                 }
-                if (ext.Has("offset"))
+                if (xform.Has("offset"))
                 {
-                    const auto& a = ext.Get("offset");
+                    const auto& a = xform.Get("offset");
                     if (a.IsArray() && a.ArrayLen() >= 2)
                         uvOffset = glm::vec2((float)a.Get(0).GetNumberAsDouble(), (float)a.Get(1).GetNumberAsDouble());
                 }
-                if (ext.Has("rotation"))
+                if (xform.Has("rotation"))
                 {
-                    uvRotate = (float)ext.Get("rotation").GetNumberAsDouble();
+                    uvRotate = (float)xform.Get("rotation").GetNumberAsDouble();
                 }
-                if (ext.Has("texCoord"))
+                if (xform.Has("texCoord"))
                 {
-                    uvSet = (int)ext.Get("texCoord").GetNumberAsInt();
+                    uvSet = (int)xform.Get("texCoord").GetNumberAsInt();
                 }
             }
-            gltex = getOrCreateTexture(tindex);
+            gltex = getOrCreateTexture(tindex, true);
+
+            // Normal map shares the vertex UV, so it must use the same TEXCOORD set
+            const tinygltf::NormalTextureInfo& nt = mat.normalTexture;
+            if (tindex < 0) uvSet = nt.texCoord;
+            if (nt.index >= 0 && nt.texCoord == uvSet && (!tanAttr.empty() || genTan))
+            {
+                normalTex = getOrCreateTexture(nt.index, false);
+                normalScale = (float)nt.scale;
+            }
         }
 
+        // Mirrored instances flip the bitangent
+        const glm::mat3 tanMat(M);
+        const float tanSign = (glm::determinant(tanMat) < 0.0f) ? -1.0f : 1.0f;
+        auto getT = [&](size_t i){
+            if (!normalTex) return glm::vec4(0.0f);
+            glm::vec4 t = genTan ? (*genTan)[i] : glm::vec4(tanAttr[4*i+0], tanAttr[4*i+1], tanAttr[4*i+2], tanAttr[4*i+3]);
+            const glm::vec3 d = tanMat * glm::vec3(t);
+            const float len = glm::length(d);
+            return glm::vec4((len > 1e-20f) ? d / len : glm::vec3(1, 0, 0), (t.w < 0.0f ? -1.0f : 1.0f) * tanSign);
+        };
+
         auto applyUVXform = [&](glm::vec2 uv){
             uv *= uvScale;
             if (uvRotate != 0.0f)
@@ -394,11 +1064,26 @@ bool Model::loadGLTF(const std::string& path)
             glm::vec2 t0 = applyUVXform(getUV(i0));
             glm::vec2 t1 = applyUVXform(getUV(i1));
             glm::vec2 t2 = applyUVXform(getUV(i2));
-            verts.push_back({p0,n0,c0,t0});
-            verts.push_back({p1,n1,c1,t1});
-            verts.push_back({p2,n2,c2,t2});
+            verts.push_back({p0,n0,c0,t0,getT(i0)});
+            verts.push_back({p1,n1,c1,t1,getT(i1)});
+            verts.push_back({p2,n2,c2,t2,getT(i2)});
+            if (hasMorphs)
+            {
+                morphVerts.push_back(getMorph(i0));
+                morphVerts.push_back(getMorph(i1));
+                morphVerts.push_back(getMorph(i2));
+            }
+            if (hasSkins)
+            {
+                skinVerts.push_back(getSkin(i0));
+                skinVerts.push_back(getSkin(i1));
+                skinVerts.push_back(getSkin(i2));
+            }
             // bounds
-            const glm::vec3 pp[3] = {p0,p1,p2};
+            const glm::vec3 pp[3] = {
+                glm::vec3(boundsM * glm::vec4(lp0, 1.0f)),
+                glm::vec3(boundsM * glm::vec4(lp1, 1.0f)),
+                glm::vec3(boundsM * glm::vec4(lp2, 1.0f)) };
             for (int j=0;j<3;++j) {
                 bmin.x = std::min(bmin.x, pp[j].x); bmax.x = std::max(bmax.x, pp[j].x);
                 bmin.y = std::min(bmin.y, pp[j].y); bmax.y = std::max(bmax.y, pp[j].y);
@@ -421,39 +1106,225 @@ bool Model::loadGLTF(const std::string& path)
 
         int added = (int)verts.size() - vertStart;
         if (added > 0)
-            draws_.push_back({vertStart, added, gltex, doBlend, baseColorFactor});
+            draws_.push_back({vertStart, added, gltex, doBlend, baseColorFactor, normalTex, normalScale,
+                              (job.dynamic && !skinned) ? job.node : -1, skinned, morphed});
     };
 
-    // Iterate default scene nodes and gather all primitives
-    auto traverse = [&](auto&& self, int nodeIndex, const glm::mat4& parentM) -> void {
-        const tinygltf::Node& nd = gltf.nodes[nodeIndex];
-        glm::mat4 local = nodeLocalMatrix(nd);
-        glm::mat4 M = parentM * local;
-        if (nd.mesh >= 0)
+    for (const PrimJob& job : jobs)
+        appendPrimitive(gltf.meshes[job.mesh].primitives[job.prim], job, tangentKey(job.mesh, job.prim));
+
+    // Animation clips (node TRS and morph weights)
+    for (const auto& anim : gltf.animations)
+    {
+        AnimationClip clip;
+        clip.name = anim.name;
+        for (const auto& ch : anim.channels)
         {
-            const tinygltf::Mesh& mesh = gltf.meshes[nd.mesh];
-            for (const auto& prim : mesh.primitives) appendPrimitive(prim, M);
+            if (ch.target_node < 0 || ch.target_node >= (int)nodeMap.size() || nodeMap[ch.target_node] < 0) continue;
+            if (ch.sampler < 0 || ch.sampler >= (int)anim.samplers.size()) continue;
+            const tinygltf::AnimationSampler& smp = anim.samplers[ch.sampler];
+
+            AnimationChannel out;
+            out.node = nodeMap[ch.target_node];
+            if (ch.target_path == "translation") { out.path = AnimationChannel::Path::Translation; out.components = 3; }
+            else if (ch.target_path == "rotation") { out.path = AnimationChannel::Path::Rotation; out.components = 4; }
+            else if (ch.target_path == "scale") { out.path = AnimationChannel::Path::Scale; out.components = 3; }
+            else if (ch.target_path == "weights" && nodeWeightBase[ch.target_node] >= 0)
+            {
+                out.path = AnimationChannel::Path::Weights;
+                out.components = nodeWeightCount[ch.target_node];
+                out.weightBase = nodeWeightBase[ch.target_node];
+            }
+            else continue;
+            if (smp.interpolation == "STEP") out.interp = AnimationChannel::Interp::Step;
+            else if (smp.interpolation == "CUBICSPLINE") out.interp = AnimationChannel::Interp::CubicSpline;
+
+            if (!readAccessorFloatVecN(gltf, gltf.accessors[smp.input], 1, out.times)) continue;
+            // Weight outputs are scalar accessors holding all targets of a key in sequence
+            const int outN = (out.path == AnimationChannel::Path::Weights) ? 1 : out.components;
+            if (!readAccessorFloatVecN(gltf, gltf.accessors[smp.output], outN, out.values)) continue;
+            const size_t keys = out.values.size() / out.components / (out.interp == AnimationChannel::Interp::CubicSpline ? 3 : 1);
+            if (out.times.empty() || keys != out.times.size()) continue;
+            clip.duration = std::max(clip.duration, out.times.back());
+            clip.hasWeights = clip.hasWeights || out.path == AnimationChannel::Path::Weights;
+            clip.channels.push_back(std::move(out));
         }
-        for (int c : nd.children) self(self, c, M);
-    };
+        if (!clip.channels.empty()) clips_.push_back(std::move(clip));
+    }
 
-    if (gltf.scenes.empty())
+    if (verts.empty())
     {
-        // Fallback: iterate all meshes without transforms
-        for (const auto& mesh : gltf.meshes)
-            for (const auto& prim : mesh.primitives) appendPrimitive(prim, glm::mat4(1.0f));
+        err_ = "No triangles found in glTF.";
+        if (incremental)
+        {
+            // Drop the textures this attempt created and put the previous model back
+            for (unsigned int id : textures_)
+                if (std::find(oldTextureIds.begin(), oldTextureIds.end(), id) == oldTextureIds.end())
+                    glDeleteTextures(1, &id);
+            swapPreviousState();
+        }
+        return false;
+    }
+
+    if (incremental)
+    {
+        // The new content is usable: release what it replaces. Textures that changed or
+        // disappeared from the file go; reused ones are in textures_ again.
+        for (unsigned int id : oldTextureIds)
+            if (std::find(textures_.begin(), textures_.end(), id) == textures_.end())
+                glDeleteTextures(1, &id);
+        releaseAnimationBuffers();
+        animator_.setClip(nullptr); // pointed into the previous clips
+        activeClip_ = -1;
+        jointMatrices_.clear();
+    }
+
+    sortAndMergeDraws(verts, hasSkins ? &skinVerts : nullptr, hasMorphs ? &morphVerts : nullptr);
+
+    drawHashes_.resize(draws_.size());
+    ThreadPool::Get().ParallelFor(draws_.size(), 1, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i)
+            drawHashes_[i] = hashBytes(verts.data() + draws_[i].first, size_t(draws_[i].count) * sizeof(Vertex));
+    });
+    reloadStats_.drawsTotal = (int)draws_.size();
+
+    // Same layout: patch only the primitives whose vertices changed
+    bool sameLayout = incremental && vao_ && (int)verts.size() == vertexCount_ && oldDraws.size() == draws_.size();
+    for (size_t i = 0; sameLayout && i < draws_.size(); ++i)
+        sameLayout = oldDraws[i].first == draws_[i].first && oldDraws[i].count == draws_[i].count;
+    if (sameLayout)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+        for (size_t i = 0; i < draws_.size(); ++i)
+        {
+            if (drawHashes_[i] == oldDrawHashes[i]) continue;
+            glBufferSubData(GL_ARRAY_BUFFER, draws_[i].first * sizeof(Vertex), draws_[i].count * sizeof(Vertex), verts.data() + draws_[i].first);
+            uploadPositions(verts, draws_[i].first, draws_[i].count);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+            ++reloadStats_.drawsUploaded;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
     else
     {
-        int sceneIndex = gltf.defaultScene >= 0 ? gltf.defaultScene : 0;
-        const tinygltf::Scene& sc = gltf.scenes[sceneIndex];
-        for (int nodeIndex : sc.nodes)
-            traverse(traverse, nodeIndex, glm::mat4(1.0f));
+        uploadVertices(verts);
+        reloadStats_.drawsUploaded = (int)draws_.size();
+    }
+    bmin_ = bmin; bmax_ = bmax;
+
+    graph_.updateWorld();
+    if (hasSkins)
+    {
+        uploadSkinning(skinVerts);
+        updateJoints();
+    }
+    if (hasMorphs && !morphDeltas.empty())
+    {
+        uploadMorphs(morphVerts, morphDeltas);
+        updateMorphWeights();
     }
+    if (!clips_.empty()) setAnimation(0);
+    return true;
+}
+
+void Model::setAnimation(int index)
+{
+    if (index < 0 || index >= (int)clips_.size()) return;
+    activeClip_ = index;
+    animator_.setClip(&clips_[index]);
+}
 
-    if (verts.empty()) { err_ = "No triangles found in glTF."; return false; }
+void Model::update(float dt)
+{
+    if (activeClip_ < 0) return;
+    animator_.update(dt, graph_, morphWeights_);
+    if (graph_.updateWorld() && !jointNodes_.empty())
+        updateJoints();
+    if (clips_[activeClip_].hasWeights && morphWeightBuffer_)
+        updateMorphWeights();
+}
 
-    // upload to GPU (same as OBJ path)
+void Model::uploadSkinning(const std::vector<SkinVertex>& skinVerts)
+{
+    glBindVertexArray(vao_);
+    glGenBuffers(1, &skinVbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, skinVbo_);
+    glBufferData(GL_ARRAY_BUFFER, skinVerts.size()*sizeof(SkinVertex), skinVerts.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(5);
+    glVertexAttribIPointer(5, 4, GL_UNSIGNED_SHORT, sizeof(SkinVertex), (void*)offsetof(SkinVertex, joints));
+    glEnableVertexAttribArray(6);
+    glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(SkinVertex), (void*)offsetof(SkinVertex, weights));
+    glBindVertexArray(0);
+
+    jointMatrices_.resize(jointNodes_.size());
+    glGenBuffers(1, &jointBuffer_);
+    glBindBuffer(GL_TEXTURE_BUFFER, jointBuffer_);
+    glBufferData(GL_TEXTURE_BUFFER, jointMatrices_.size()*sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+    glGenTextures(1, &jointTex_);
+    glBindTexture(GL_TEXTURE_BUFFER, jointTex_);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, jointBuffer_);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void Model::uploadMorphs(const std::vector<MorphVertex>& morphVerts, const std::vector<glm::vec4>& deltas)
+{
+    glBindVertexArray(vao_);
+    glGenBuffers(1, &morphVbo_);
+    glBindBuffer(GL_ARRAY_BUFFER, morphVbo_);
+    glBufferData(GL_ARRAY_BUFFER, morphVerts.size()*sizeof(MorphVertex), morphVerts.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(7);
+    glVertexAttribIPointer(7, 2, GL_UNSIGNED_INT, sizeof(MorphVertex), (void*)0);
+    glBindVertexArray(0);
+
+    glGenBuffers(1, &morphDeltaBuffer_);
+    glBindBuffer(GL_TEXTURE_BUFFER, morphDeltaBuffer_);
+    glBufferData(GL_TEXTURE_BUFFER, deltas.size()*sizeof(glm::vec4), deltas.data(), GL_STATIC_DRAW);
+    glGenTextures(1, &morphDeltaTex_);
+    glBindTexture(GL_TEXTURE_BUFFER, morphDeltaTex_);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, morphDeltaBuffer_);
+
+    glGenBuffers(1, &morphWeightBuffer_);
+    glBindBuffer(GL_TEXTURE_BUFFER, morphWeightBuffer_);
+    glBufferData(GL_TEXTURE_BUFFER, morphWeights_.size()*sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    glGenTextures(1, &morphWeightTex_);
+    glBindTexture(GL_TEXTURE_BUFFER, morphWeightTex_);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, morphWeightBuffer_);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void Model::updateMorphWeights()
+{
+    glBindBuffer(GL_TEXTURE_BUFFER, morphWeightBuffer_);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, morphWeights_.size()*sizeof(float), morphWeights_.data());
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void Model::updateJoints()
+{
+    // One palette for all skins, rebuilt in parallel and uploaded with a single call
+    ThreadPool::Get().ParallelFor(jointNodes_.size(), 256, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i)
+            jointMatrices_[i] = graph_.world(jointNodes_[i]) * inverseBind_[i];
+    });
+    glBindBuffer(GL_TEXTURE_BUFFER, jointBuffer_);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, jointMatrices_.size()*sizeof(glm::mat4), jointMatrices_.data());
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void Model::uploadVertices(const std::vector<Vertex>& verts)
+{
+    if (vao_)
+    {
+        // Reload into the existing buffer; the VAO's attribute bindings stay valid
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+        glBufferData(GL_ARRAY_BUFFER, verts.size()*sizeof(Vertex), verts.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        vertexCount_ = static_cast<int>(verts.size());
+        uploadPositions(verts);
+        return;
+    }
     glGenVertexArrays(1, &vao_);
     glGenBuffers(1, &vbo_);
     glBindVertexArray(vao_);
@@ -469,11 +1340,35 @@ bool Model::loadGLTF(const std::string& path)
     glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, col));
     glEnableVertexAttribArray(3);
     glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, uv));
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(Vertex, tan));
     glBindVertexArray(0);
 
     vertexCount_ = static_cast<int>(verts.size());
-    bmin_ = bmin; bmax_ = bmax;
-    return true;
+    uploadPositions(verts);
+}
+
+void Model::uploadPositions(const std::vector<Vertex>& verts, int first, int count)
+{
+    const bool whole = count < 0;
+    if (whole) count = (int)verts.size();
+    std::vector<glm::vec3> pos(static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) pos[i] = verts[size_t(first) + i].pos;
+
+    if (!depthVao_)
+    {
+        glGenVertexArrays(1, &depthVao_);
+        glGenBuffers(1, &posVbo_);
+        glBindVertexArray(depthVao_);
+        glBindBuffer(GL_ARRAY_BUFFER, posVbo_);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+        glBindVertexArray(0);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, posVbo_);
+    if (whole) glBufferData(GL_ARRAY_BUFFER, pos.size() * sizeof(glm::vec3), pos.data(), GL_STATIC_DRAW);
+    else glBufferSubData(GL_ARRAY_BUFFER, size_t(first) * sizeof(glm::vec3), pos.size() * sizeof(glm::vec3), pos.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void Model::computeFlatNormal(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, glm::vec3& n) 
@@ -484,73 +1379,761 @@ void Model::computeFlatNormal(const glm::vec3& a, const glm::vec3& b, const glm:
     n = (len > 1e-10f) ? (nn / len) : glm::vec3(0, 1, 0);
 }
 
-void Model::render(const Camera& cam, const glm::mat4& model, Shader& shader) const 
+void Model::sortAndMergeDraws(std::vector<Vertex>& verts, std::vector<SkinVertex>* skinVerts,
+                              std::vector<MorphVertex>* morphVerts)
 {
-    if (!vao_ || vertexCount_ <= 0) return;
+    auto stateKey = [](const Draw& d) {
+        return std::make_tuple(d.skinned, d.morphed, d.node, d.tex, d.normalTex, d.normalScale,
+                               d.baseColorFactor.r, d.baseColorFactor.g, d.baseColorFactor.b, d.baseColorFactor.a);
+    };
 
-    // You already set uniforms in your scenes; we set them here for convenience:
-    // expect shader "uModel/uView/uProj/uNormalMat/uLightDir/uViewPos/uUseLighting"
-    glm::mat3 normalMat = glm::transpose(glm::inverse(glm::mat3(model)));
-    glUniformMatrix4fv(shader.loc("uModel"), 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(shader.loc("uView"), 1, GL_FALSE, glm::value_ptr(cam.view()));
-    glUniformMatrix4fv(shader.loc("uProj"), 1, GL_FALSE, glm::value_ptr(cam.proj()));
-    glUniformMatrix3fv(shader.loc("uNormalMat"), 1, GL_FALSE, glm::value_ptr(normalMat));
+    // Blended draws stay in file order; the opaque pass is order-independent
+    std::vector<Draw> sorted;
+    sorted.reserve(draws_.size());
+    for (const Draw& d : draws_) if (!d.blend) sorted.push_back(d);
+    std::stable_sort(sorted.begin(), sorted.end(), [&](const Draw& a, const Draw& b) { return stateKey(a) < stateKey(b); });
+    const size_t opaque = sorted.size();
+    for (const Draw& d : draws_) if (d.blend) sorted.push_back(d);
 
-    glBindVertexArray(vao_);
-    if (draws_.empty())
+    // Move each draw's vertices to its new position in all vertex streams
+    std::vector<int> newFirst(sorted.size());
+    int next = 0;
+    for (size_t i = 0; i < sorted.size(); ++i) { newFirst[i] = next; next += sorted[i].count; }
+    auto reorder = [&](auto& stream) {
+        using Stream = std::decay_t<decltype(stream)>;
+        Stream out(stream.size());
+        ThreadPool::Get().ParallelFor(sorted.size(), 16, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i)
+                std::copy_n(stream.begin() + sorted[i].first, sorted[i].count, out.begin() + newFirst[i]);
+        });
+        stream.swap(out);
+    };
+    reorder(verts);
+    if (skinVerts) reorder(*skinVerts);
+    if (morphVerts) reorder(*morphVerts);
+
+    // Merge neighbours that share every piece of state
+    draws_.clear();
+    opaqueCount_ = 0;
+    for (size_t i = 0; i < sorted.size(); ++i)
     {
-        glUniform1i(shader.loc("uHasBaseColorTex"), 0);
-        glUniform4f(shader.loc("uBaseColorFactor"), 1.0f, 1.0f, 1.0f, 1.0f);
-        glDrawArrays(GL_TRIANGLES, 0, vertexCount_);
+        Draw d = sorted[i];
+        d.first = newFirst[i];
+        if (!draws_.empty() && draws_.back().blend == d.blend && stateKey(draws_.back()) == stateKey(d))
+        {
+            draws_.back().count += d.count;
+            continue;
+        }
+        draws_.push_back(d);
+        if (i < opaque) ++opaqueCount_;
     }
-    else
-    {
-        // Pass 1: opaque (no blending, depth writes on)
-        glDisable(GL_BLEND);
-        glDepthMask(GL_TRUE);
-        for (const auto& d : draws_)
+
+    ThreadPool::Get().ParallelFor(draws_.size(), 4, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i)
         {
-            if (d.blend) continue;
-            if (d.tex)
+            Draw& d = draws_[i];
+            d.bmin = glm::vec3(std::numeric_limits<float>::max());
+            d.bmax = glm::vec3(std::numeric_limits<float>::lowest());
+            for (int v = d.first; v < d.first + d.count; ++v)
             {
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, d.tex);
-                glUniform1i(shader.loc("uBaseColorTex"), 0);
-                glUniform1i(shader.loc("uHasBaseColorTex"), 1);
+                d.bmin = glm::min(d.bmin, verts[v].pos);
+                d.bmax = glm::max(d.bmax, verts[v].pos);
             }
-            else
-            {
-                glUniform1i(shader.loc("uHasBaseColorTex"), 0);
-            }
-            glUniform4f(shader.loc("uBaseColorFactor"), d.baseColorFactor.r, d.baseColorFactor.g, d.baseColorFactor.b, d.baseColorFactor.a);
-            glDrawArrays(GL_TRIANGLES, d.first, d.count);
         }
+    });
+
+    std::vector<glm::vec3> mins, maxs;
+    bvhDraws_.clear();
+    for (size_t i = 0; i < draws_.size(); ++i)
+    {
+        const Draw& d = draws_[i];
+        if (d.node >= 0 || d.skinned || d.morphed) continue;
+        bvhDraws_.push_back((int)i);
+        mins.push_back(d.bmin);
+        maxs.push_back(d.bmax);
+    }
+    bvh_.Build(mins, maxs);
+
+    // Occluders: static opaque draws by decreasing bounds size. A draw larger than the
+    // remaining budget contributes every n-th triangle; holes only weaken occlusion.
+    std::vector<int> occluders;
+    for (size_t i = 0; i < (size_t)opaqueCount_; ++i)
+    {
+        const Draw& d = draws_[i];
+        if (d.node < 0 && !d.skinned && !d.morphed && d.baseColorFactor.a >= 1.0f) occluders.push_back((int)i);
+    }
+    auto extent = [&](int i) { return glm::length(draws_[i].bmax - draws_[i].bmin); };
+    std::stable_sort(occluders.begin(), occluders.end(), [&](int a, int b) { return extent(a) > extent(b); });
+    occluderTris_.clear();
+    for (int i : occluders)
+    {
+        const int budget = kOccluderTriangles - int(occluderTris_.size() / 3);
+        if (budget <= 0) break;
+        const Draw& d = draws_[i];
+        const int tris = d.count / 3;
+        const int stride = (tris + budget - 1) / budget;
+        for (int t = 0; t < tris; t += stride)
+            for (int k = 0; k < 3; ++k) occluderTris_.push_back(verts[d.first + t * 3 + k].pos);
+    }
+
+    // One material block per distinct parameter and texture set; batched rendering
+    // indexes its material table with the same ids
+    std::vector<MaterialBuffer::Params> materials;
+    std::vector<const Draw*> materialDraws;
+    for (Draw& d : draws_)
+    {
+        auto same = [&](const Draw* m) {
+            return m->baseColorFactor == d.baseColorFactor && m->normalScale == d.normalScale &&
+                   m->tex == d.tex && m->normalTex == d.normalTex;
+        };
+        auto it = std::find_if(materialDraws.begin(), materialDraws.end(), same);
+        d.material = int(it - materialDraws.begin());
+        if (it != materialDraws.end()) continue;
+        MaterialBuffer::Params p;
+        p.baseColorFactor = d.baseColorFactor;
+        p.normalScale = d.normalScale;
+        p.hasBaseColorTex = d.tex != 0;
+        p.hasNormalTex = d.normalTex != 0;
+        materials.push_back(p);
+        materialDraws.push_back(&d);
+    }
+    materials_.upload(materials);
+}
+
+void Model::setBatched(bool on)
+{
+    batched_ = on;
+    if (on && !batch_.ready) buildBatch();
+}
+
+void Model::setGpuDriven(bool on)
+{
+    gpuDriven_ = on;
+    if (on && !batch_.ready) buildBatch();
+}
+
+void Model::buildBatch()
+{
+    releaseBatch();
+    if (!vao_ || draws_.empty()) return;
+
+    int materialCount = 0;
+    for (const Draw& d : draws_) materialCount = std::max(materialCount, d.material + 1);
+    if (materialCount > 0xFFFF) return;
+    std::vector<const Draw*> materialDraw(materialCount, nullptr);
+    for (const Draw& d : draws_) if (!materialDraw[d.material]) materialDraw[d.material] = &d;
+
+    // Bucket textures by size and color space; each bucket becomes one array
+    struct Bucket { GLint w = 0, h = 0; GLenum internal = 0; std::vector<unsigned int> layers; };
+    std::vector<Bucket> buckets;
+    std::unordered_map<unsigned int, std::pair<int, int>> slots; // GL texture -> (array, layer)
+    auto place = [&](unsigned int tex) {
+        if (!tex || slots.count(tex)) return;
+        GLint w = 0, h = 0, fmt = 0;
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &w);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &h);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &fmt);
+        const GLenum internal = (fmt == GL_SRGB8 || fmt == GL_SRGB8_ALPHA8) ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+        size_t b = 0;
+        while (b < buckets.size() && !(buckets[b].w == w && buckets[b].h == h && buckets[b].internal == internal)) ++b;
+        if (b == buckets.size()) buckets.push_back({w, h, internal, {}});
+        slots[tex] = {int(b), int(buckets[b].layers.size())};
+        buckets[b].layers.push_back(tex);
+    };
+    for (const Draw* d : materialDraw)
+    {
+        if (!d) continue;
+        place(d->tex);
+        place(d->normalTex);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    GLint maxLayers = 256;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    if ((int)buckets.size() > kBatchArrays) return;
+    for (const Bucket& b : buckets)
+        if ((GLint)b.layers.size() > maxLayers) return;
+
+    // GL 3.3 has no image copy, so each base level is read back and re-uploaded
+    std::vector<unsigned char> pixels;
+    for (size_t a = 0; a < buckets.size(); ++a)
+    {
+        const Bucket& b = buckets[a];
+        pixels.resize(size_t(b.w) * size_t(b.h) * 4);
+        glGenTextures(1, &batch_.arrays[a]);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, batch_.arrays[a]);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, b.internal, b.w, b.h, (GLsizei)b.layers.size(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        for (size_t l = 0; l < b.layers.size(); ++l)
+        {
+            glBindTexture(GL_TEXTURE_2D, b.layers[l]);
+            glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, (GLint)l, b.w, b.h, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        }
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    batch_.arrayCount = (int)buckets.size();
+
+    // Material table
+    std::vector<glm::vec4> table(size_t(materialCount) * 3, glm::vec4(0.0f));
+    for (int m = 0; m < materialCount; ++m)
+    {
+        const Draw* d = materialDraw[m];
+        if (!d) continue;
+        const std::pair<int, int> none{-1, 0};
+        const auto base = d->tex ? slots[d->tex] : none;
+        const auto normal = d->normalTex ? slots[d->normalTex] : none;
+        table[m * 3 + 0] = d->baseColorFactor;
+        table[m * 3 + 1] = glm::vec4(d->normalScale, float(base.first), float(base.second), float(normal.first));
+        table[m * 3 + 2] = glm::vec4(float(normal.second), 0.0f, 0.0f, 0.0f);
+    }
+    glGenBuffers(1, &batch_.tableBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, batch_.tableBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, table.size()*sizeof(glm::vec4), table.data(), GL_STATIC_DRAW);
+    glGenTextures(1, &batch_.tableTex);
+    glBindTexture(GL_TEXTURE_BUFFER, batch_.tableTex);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, batch_.tableBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    // Per-vertex material index
+    std::vector<uint16_t> index(vertexCount_, 0);
+    for (const Draw& d : draws_) std::fill_n(index.begin() + d.first, d.count, uint16_t(d.material));
+    glBindVertexArray(vao_);
+    glGenBuffers(1, &batch_.materialVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, batch_.materialVbo);
+    glBufferData(GL_ARRAY_BUFFER, index.size()*sizeof(uint16_t), index.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(8);
+    glVertexAttribIPointer(8, 1, GL_UNSIGNED_SHORT, sizeof(uint16_t), (void*)0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Static opaque draws lead draws_ (see sortAndMergeDraws); they are culled on the GPU
+    int cull = 0;
+    while (cull < opaqueCount_ && !draws_[cull].skinned && !draws_[cull].morphed && draws_[cull].node < 0) ++cull;
+    if (GLExt::HasComputeIndirect() && cull > 0)
+    {
+        struct DrawInfo { glm::vec4 bmin, bmax; uint32_t first, count, pad0, pad1; }; // std430, see cull.comp
+        std::vector<DrawInfo> info(cull);
+        for (int i = 0; i < cull; ++i)
+            info[i] = {glm::vec4(draws_[i].bmin, 0.0f), glm::vec4(draws_[i].bmax, 0.0f), uint32_t(draws_[i].first), uint32_t(draws_[i].count), 0u, 0u};
+        glGenBuffers(1, &batch_.drawInfoBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch_.drawInfoBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, info.size()*sizeof(DrawInfo), info.data(), GL_STATIC_DRAW);
+        glGenBuffers(1, &batch_.commandBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch_.commandBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, size_t(cull) * 4 * sizeof(uint32_t), nullptr, GL_DYNAMIC_COPY);
+        glGenBuffers(1, &batch_.counterBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch_.counterBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(uint32_t), nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        batch_.cullCount = cull;
+    }
+
+    batch_.ready = true;
+}
+
+void Model::releaseBatch()
+{
+    if (vao_ && batch_.materialVbo)
+    {
+        glBindVertexArray(vao_);
+        glDisableVertexAttribArray(8);
+        glBindVertexArray(0);
+    }
+    if (batch_.materialVbo) glDeleteBuffers(1, &batch_.materialVbo);
+    if (batch_.tableBuffer) glDeleteBuffers(1, &batch_.tableBuffer);
+    if (batch_.tableTex) glDeleteTextures(1, &batch_.tableTex);
+    if (batch_.arrayCount) glDeleteTextures(batch_.arrayCount, batch_.arrays);
+    if (batch_.drawInfoBuffer) glDeleteBuffers(1, &batch_.drawInfoBuffer);
+    if (batch_.commandBuffer) glDeleteBuffers(1, &batch_.commandBuffer);
+    if (batch_.counterBuffer) glDeleteBuffers(1, &batch_.counterBuffer);
+    batch_ = Batch{};
+}
+
+const Model::UniformLocations& Model::locations(const Shader& shader) const
+{
+    auto it = locs_.find(shader.id());
+    if (it != locs_.end()) return it->second;
+
+    UniformLocations& L = locs_[shader.id()];
+    L.model = shader.loc("uModel");
+    L.normalMat = shader.loc("uNormalMat");
+    L.skinned = shader.loc("uSkinned");
+    L.morphed = shader.loc("uMorphed");
+    // Sampler units were set when the program linked (Phong::SetSamplerUnits)
+    return L;
+}
+
+// Bounds of a box after an affine transform (center plus absolute-matrix extents)
+static void transformBounds(const glm::mat4& m, const glm::vec3& bmin, const glm::vec3& bmax, glm::vec3& outMin, glm::vec3& outMax)
+{
+    const glm::vec3 c = 0.5f * (bmin + bmax), e = 0.5f * (bmax - bmin);
+    const glm::vec3 tc = glm::vec3(m * glm::vec4(c, 1.0f));
+    glm::vec3 te;
+    for (int a = 0; a < 3; ++a)
+        te[a] = std::abs(m[0][a]) * e.x + std::abs(m[1][a]) * e.y + std::abs(m[2][a]) * e.z;
+    outMin = tc - te;
+    outMax = tc + te;
+}
+
+void Model::cullDraws(const Camera& cam, const glm::mat4& model, size_t gpuCulled) const
+{
+    // Planes in the model's object space so static bounds need no transform
+    const Frustum frustum = Frustum::FromMatrix(cam.proj() * cam.view() * model);
+    visible_.assign(draws_.size(), 0);
+    bvhVisible_.assign(bvhDraws_.size(), 0);
+    bvh_.Cull(frustum, bvhVisible_);
+    for (size_t i = 0; i < bvhDraws_.size(); ++i)
+        if (bvhVisible_[i]) visible_[bvhDraws_[i]] = 1;
+
+    for (size_t i = 0; i < draws_.size(); ++i)
+    {
+        const Draw& d = draws_[i];
+        if (i < gpuCulled) { visible_[i] = 1; continue; } // culled by the compute pass
+        if (d.skinned || d.morphed) { visible_[i] = 1; continue; }
+        if (d.node < 0) continue;
+        glm::vec3 bmin, bmax;
+        transformBounds(graph_.world(d.node), d.bmin, d.bmax, bmin, bmax);
+        visible_[i] = frustum.Classify(bmin, bmax) != Frustum::Result::Outside;
+    }
+
+    if (occlusionCulling_ && !occluderTris_.empty())
+    {
+        const glm::mat4 mvp = cam.proj() * cam.view() * model;
+        occlusion_.Render(occluderTris_, mvp);
+        for (size_t i = gpuCulled; i < draws_.size(); ++i)
+        {
+            const Draw& d = draws_[i];
+            if (!visible_[i] || d.skinned || d.morphed) continue;
+            glm::vec3 bmin = d.bmin, bmax = d.bmax;
+            if (d.node >= 0) transformBounds(graph_.world(d.node), d.bmin, d.bmax, bmin, bmax);
+            if (occlusion_.IsOccluded(bmin, bmax, mvp)) visible_[i] = 0;
+        }
+    }
+    visibleDraws_ = 0;
+    for (uint8_t v : visible_) visibleDraws_ += v;
+}
 
-        // Pass 2: transparent (enable blending, depth writes off)
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glDepthMask(GL_FALSE);
-        for (const auto& d : draws_)
+void Model::prepareQueries(const Camera& cam, const glm::mat4& model) const
+{
+    const std::vector<Bvh::Node>& nodes = bvh_.Nodes();
+    if (queryNodes_.size() != nodes.size())
+    {
+        for (QueryNode& q : queryNodes_) if (q.queries[0]) glDeleteQueries(2, q.queries);
+        queryNodes_.assign(nodes.size(), QueryNode{});
+    }
+    drawCondition_.assign(draws_.size(), 0);
+    queryBoxes_.clear();
+    if (nodes.empty()) return;
+
+    auto setSubtree = [&](int root, bool hidden) {
+        int stack[64];
+        int top = 0;
+        stack[top++] = root;
+        while (top > 0)
         {
-            if (!d.blend) continue;
-            if (d.tex)
+            const int n = stack[--top];
+            queryNodes_[n].hidden = hidden;
+            if (nodes[n].left >= 0 && top < 62)
             {
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, d.tex);
-                glUniform1i(shader.loc("uBaseColorTex"), 0);
-                glUniform1i(shader.loc("uHasBaseColorTex"), 1);
+                stack[top++] = nodes[n].left;
+                stack[top++] = nodes[n].left + 1;
             }
-            else
+        }
+    };
+
+    // Results of last frame's queries, if the GPU has them; otherwise keep the old state
+    const int prev = queryFrame_ - 1;
+    for (size_t n = 0; n < nodes.size(); ++n)
+    {
+        QueryNode& q = queryNodes_[n];
+        if (q.issued != prev) continue;
+        const GLuint id = q.queries[prev & 1];
+        GLuint available = 0;
+        glGetQueryObjectuiv(id, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+        GLuint passed = 0;
+        glGetQueryObjectuiv(id, GL_QUERY_RESULT, &passed);
+        if (passed) setSubtree((int)n, false); // refine: children are tested on their own
+        else q.hidden = true;
+    }
+    // Pull up: a node is hidden when both children are (children follow their parent)
+    for (size_t n = nodes.size(); n-- > 0;)
+        if (nodes[n].left >= 0)
+            queryNodes_[n].hidden = queryNodes_[nodes[n].left].hidden && queryNodes_[nodes[n].left + 1].hidden;
+
+    // Walk the visible part of the hierarchy; hidden nodes stop the descent and gate
+    // their draws on this frame's box query
+    const Frustum frustum = Frustum::FromMatrix(cam.proj() * cam.view() * model);
+    const glm::vec3 eye = glm::vec3(glm::inverse(model) * glm::vec4(cam.eye(), 1.0f));
+    int stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        const int n = stack[--top];
+        const Bvh::Node& node = nodes[n];
+        QueryNode& q = queryNodes_[n];
+        if (frustum.Classify(node.bmin, node.bmax) == Frustum::Result::Outside) continue;
+
+        // A box around the eye would be clipped by the near plane; treat it as visible
+        const glm::vec3 pad = 0.01f * (node.bmax - node.bmin) + glm::vec3(1e-4f);
+        bool eyeInside = true;
+        for (int a = 0; a < 3; ++a) eyeInside = eyeInside && eye[a] >= node.bmin[a] - pad[a] && eye[a] <= node.bmax[a] + pad[a];
+        if (eyeInside && q.hidden) setSubtree(n, false);
+
+        const bool leaf = node.left < 0;
+        if (!eyeInside && (q.hidden || (leaf && (q.issued < 0 || queryFrame_ - q.issued >= kQueryInterval))))
+        {
+            if (!q.queries[0]) glGenQueries(2, q.queries);
+            queryBoxes_.push_back(n);
+        }
+        if (q.hidden)
+        {
+            const GLuint id = q.queries[queryFrame_ & 1];
+            for (int i = node.first; i < node.first + node.count; ++i)
+                drawCondition_[bvhDraws_[bvh_.Item(i)]] = id;
+            continue;
+        }
+        if (!leaf && top < 62)
+        {
+            stack[top++] = node.left;
+            stack[top++] = node.left + 1;
+        }
+    }
+}
+
+void Model::releaseQueries()
+{
+    for (QueryNode& q : queryNodes_) if (q.queries[0]) glDeleteQueries(2, q.queries);
+    queryNodes_.clear();
+    drawCondition_.clear();
+    if (boxVbo_) glDeleteBuffers(1, &boxVbo_);
+    if (boxVao_) glDeleteVertexArrays(1, &boxVao_);
+    boxVbo_ = boxVao_ = 0;
+}
+
+void Model::submit(RenderQueue& queue, const Camera& cam, const glm::mat4& model, const ShaderVariants& shaders,
+                   uint32_t frameFeatures, const Shader* cullShader, const Shader* depthShader) const
+{
+    if (!vao_ || vertexCount_ <= 0) return;
+    using Pass = RenderQueue::Pass;
+
+    // GPU-driven: cull the static opaque draws into indirect commands before drawing
+    const bool gpu = gpuDriven_ && cullShader && batch_.ready && batch_.cullCount > 0 && GLExt::HasComputeIndirect();
+    const bool compact = gpu && GLExt::HasIndirectCount();
+    if (gpu)
+    {
+        const Frustum frustum = Frustum::FromMatrix(cam.proj() * cam.view() * model);
+        const GLuint zero = 0;
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch_.counterBuffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(zero), &zero);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        cullShader->use();
+        glUniform4fv(cullShader->loc("uPlanes"), 6, glm::value_ptr(frustum.Planes()[0]));
+        glUniform1ui(cullShader->loc("uDrawCount"), (GLuint)batch_.cullCount);
+        glUniform1i(cullShader->loc("uCompact"), compact ? 1 : 0);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, batch_.drawInfoBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, batch_.commandBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, batch_.counterBuffer);
+        GLExt::DispatchCompute(GLuint(batch_.cullCount + 63) / 64, 1, 1);
+        GLExt::Barrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+    }
+
+    frame_.depthShader = (depthPrepass_ && depthVao_) ? depthShader : nullptr;
+    frame_.depthModel = frame_.depthShader ? frame_.depthShader->loc("uModel") : -1;
+    frame_.model = model;
+    frame_.gpu = gpu;
+    frame_.compact = compact;
+    frame_.batched = (batched_ || gpu) && batch_.ready && !draws_.empty();
+    runs_.clear();
+    if (draws_.empty())
+    {
+        const Shader& shader = shaders.get(frameFeatures);
+        runs_.push_back(Run{-1, 0, vertexCount_, 0, &shader});
+        queue.submit(RenderQueue::MakeKey(Pass::Opaque, shader.id(), 0, 0.0f), this, 0);
+        return;
+    }
+
+    cullDraws(cam, model, gpu ? size_t(batch_.cullCount) : 0);
+
+    // Occlusion queries gate draws of hidden BVH nodes; GPU-culled draws are not queried
+    const bool queries = occlusionQueries_ && !gpu;
+    if (queries) prepareQueries(cam, model);
+    else drawCondition_.assign(draws_.size(), 0);
+
+    // The GPU-culled static prefix is one indirect call at the initial transform
+    frame_.indirectShader = frame_.batched ? &shaders.get(frameFeatures | Phong::Batched) : nullptr;
+    if (gpu) queue.submit(RenderQueue::MakeKey(Pass::Opaque, frame_.indirectShader->id(), 0, 0.0f), this, kIndirectItem);
+
+    // Batched draws read their material per vertex, so consecutive opaque draws become one
+    // packet until the transform changes. Blended draws stay separate so they can be
+    // sorted back to front.
+    auto sameTransform = [](const Draw& a, const Draw& b) {
+        return a.skinned == b.skinned && a.morphed == b.morphed && (a.skinned || a.node == b.node);
+    };
+    const glm::mat4 view = cam.view() * model;
+    for (size_t i = gpu ? size_t(batch_.cullCount) : 0; i < draws_.size();)
+    {
+        const Draw& d = draws_[i];
+        if (!visible_[i])
+        {
+            ++i;
+            continue;
+        }
+        Run run{(int)i, d.first, d.count, drawCondition_[i]};
+        glm::vec3 bmin = d.bmin, bmax = d.bmax;
+        size_t j = i + 1;
+        if (frame_.batched && !d.blend)
+        {
+            while (j < (size_t)opaqueCount_ && visible_[j] && drawCondition_[j] == run.cond && sameTransform(draws_[j], d) &&
+                   draws_[j].first == run.first + run.count)
             {
-                glUniform1i(shader.loc("uHasBaseColorTex"), 0);
+                bmin = glm::min(bmin, draws_[j].bmin);
+                bmax = glm::max(bmax, draws_[j].bmax);
+                run.count += draws_[j++].count;
             }
-            glUniform4f(shader.loc("uBaseColorFactor"), d.baseColorFactor.r, d.baseColorFactor.g, d.baseColorFactor.b, d.baseColorFactor.a);
-            glDrawArrays(GL_TRIANGLES, d.first, d.count);
         }
-        // Restore state
-        glBindTexture(GL_TEXTURE_2D, 0);
-        glDepthMask(GL_TRUE);
-        glDisable(GL_BLEND);
+
+        glm::vec3 center = 0.5f * (bmin + bmax);
+        if (d.node >= 0 && !d.skinned) center = glm::vec3(graph_.world(d.node) * glm::vec4(center, 1.0f));
+        const float depth = -(view * glm::vec4(center, 1.0f)).z;
+        const Pass blendPass = queue.oit() ? Pass::TransparentOit : Pass::Transparent;
+        Pass pass = d.blend ? blendPass : (run.cond ? Pass::OpaqueConditional : Pass::Opaque);
+        const uint32_t material = frame_.batched ? 0u : (uint32_t)d.material;
+        // Batched runs mix materials, so texture presence stays a shader-side test there
+        uint32_t features = frameFeatures | (pass == Pass::TransparentOit ? Phong::Oit : 0u);
+        if (frame_.batched) features |= Phong::Batched;
+        else features |= (d.tex ? Phong::BaseColorTex : 0u) | (d.normalTex ? Phong::NormalTex : 0u);
+        run.shader = &shaders.get(features);
+        const float key = pass == Pass::TransparentOit ? 0.0f : depth; // OIT needs no order
+        if (pass == Pass::Opaque && frame_.depthShader && !d.skinned && !d.morphed)
+        {
+            // Front to back in the pre-pass; shading order then only follows state
+            queue.submit(RenderQueue::MakeKey(Pass::DepthPrepass, frame_.depthShader->id(), 0, depth), this,
+                         kDepthItem | (uint32_t)runs_.size());
+            pass = Pass::OpaqueEqual;
+        }
+        queue.submit(RenderQueue::MakeKey(pass, run.shader->id(), material, key), this, (uint32_t)runs_.size());
+        runs_.push_back(run);
+        i = j;
     }
+
+    if (queries)
+    {
+        ensureBoxVao();
+        // Boxes only feed queries, so they run the plainest variant
+        frame_.boxShader = &shaders.get(0);
+        for (int n : queryBoxes_)
+        {
+            queryNodes_[n].issued = queryFrame_;
+            queue.submit(RenderQueue::MakeKey(Pass::OcclusionTest, frame_.boxShader->id(), 0, 0.0f), this,
+                         kBoxItem | (uint32_t)n);
+        }
+        ++queryFrame_;
+    }
+}
+
+void Model::bind(RenderQueue::Pass pass) const
+{
+    bound_ = BoundState{};
+    if (pass == RenderQueue::Pass::DepthPrepass)
+    {
+        // phong.vert on the position stream; only static draws get here, so the same
+        // branches as in the shading pass are taken
+        frame_.depthShader->use();
+        const UniformLocations& L = locations(*frame_.depthShader);
+        glUniformMatrix4fv(frame_.depthModel, 1, GL_FALSE, glm::value_ptr(frame_.model));
+        glUniform1i(L.skinned, 0);
+        glUniform1i(L.morphed, 0);
+        glBindVertexArray(depthVao_);
+        return;
+    }
+
+    // Camera and lighting come from the "Frame" block; the program and per-object state
+    // follow in draw(), as packets of one pass may use several variants
+    if (frame_.batched)
+    {
+        glActiveTexture(GL_TEXTURE0 + Phong::MaterialTableUnit);
+        glBindTexture(GL_TEXTURE_BUFFER, batch_.tableTex);
+        for (int a = 0; a < batch_.arrayCount; ++a)
+        {
+            glActiveTexture(GL_TEXTURE0 + Phong::TexArraysUnit + a);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, batch_.arrays[a]);
+        }
+    }
+    if (jointTex_)
+    {
+        glActiveTexture(GL_TEXTURE0 + Phong::JointsUnit);
+        glBindTexture(GL_TEXTURE_BUFFER, jointTex_);
+    }
+    if (morphDeltaTex_)
+    {
+        glActiveTexture(GL_TEXTURE0 + Phong::MorphDeltasUnit);
+        glBindTexture(GL_TEXTURE_BUFFER, morphDeltaTex_);
+        glActiveTexture(GL_TEXTURE0 + Phong::MorphWeightsUnit);
+        glBindTexture(GL_TEXTURE_BUFFER, morphWeightTex_);
+    }
+    glActiveTexture(GL_TEXTURE0);
+    // The material block stays active in the program, so keep a valid range bound
+    materials_.bind(0);
+
+    bound_.material = 0;
+    glBindVertexArray(pass == RenderQueue::Pass::OcclusionTest ? boxVao_ : vao_);
+}
+
+void Model::draw(uint32_t item) const
+{
+    if (item == kIndirectItem)
+    {
+        useProgram(*frame_.indirectShader);
+        bindTransform(Draw{});
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, batch_.commandBuffer);
+        if (frame_.compact)
+        {
+            glBindBuffer(GL_PARAMETER_BUFFER, batch_.counterBuffer);
+            GLExt::MultiDrawArraysIndirectCount(GL_TRIANGLES, nullptr, 0, batch_.cullCount, 0);
+            glBindBuffer(GL_PARAMETER_BUFFER, 0);
+        }
+        else
+        {
+            GLExt::MultiDrawArraysIndirect(GL_TRIANGLES, nullptr, batch_.cullCount, 0);
+        }
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        return;
+    }
+    if ((item & kDepthItem) && !(item & kBoxItem))
+    {
+        // Only rigid draws reach the pre-pass, so the transform is the node's
+        const Run& run = runs_[item & ~kDepthItem];
+        const Draw& d = draws_[run.draw];
+        if (d.node != bound_.node)
+        {
+            const glm::mat4 M = (d.node >= 0) ? frame_.model * graph_.world(d.node) : frame_.model;
+            glUniformMatrix4fv(frame_.depthModel, 1, GL_FALSE, glm::value_ptr(M));
+            bound_.node = d.node;
+        }
+        glDrawArrays(GL_TRIANGLES, run.first, run.count);
+        return;
+    }
+    if (item & kBoxItem)
+    {
+        // Query box, slightly enlarged so faces never sit behind the geometry they bound
+        const int n = int(item & ~kBoxItem);
+        const Bvh::Node& node = bvh_.Nodes()[n];
+        const glm::vec3 pad = 0.005f * (node.bmax - node.bmin) + glm::vec3(1e-5f);
+        const glm::vec3 bmin = node.bmin - pad, size = node.bmax + pad - bmin;
+        glm::mat4 box(1.0f);
+        box[0][0] = size.x; box[1][1] = size.y; box[2][2] = size.z;
+        box[3] = glm::vec4(bmin, 1.0f);
+        const glm::mat4 M = frame_.model * box;
+        useProgram(*frame_.boxShader);
+        glUniformMatrix4fv(bound_.locs->model, 1, GL_FALSE, glm::value_ptr(M));
+        bound_.node = -2; // force the transform to be sent again
+        const QueryNode& q = queryNodes_[n];
+        const GLenum target = GLExt::AnySamplesTarget();
+        glBeginQuery(target, q.queries[q.issued & 1]);
+        glDrawArrays(GL_TRIANGLES, 0, 36);
+        glEndQuery(target);
+        return;
+    }
+
+    const Run& run = runs_[item];
+    useProgram(*run.shader);
+    if (run.draw < 0)
+    {
+        glDrawArrays(GL_TRIANGLES, 0, vertexCount_);
+        return;
+    }
+    const Draw& d = draws_[run.draw];
+    if (run.cond) glBeginConditionalRender(run.cond, GL_QUERY_NO_WAIT);
+    if (frame_.batched) bindTransform(d);
+    else bindMaterial(d);
+    glDrawArrays(GL_TRIANGLES, run.first, run.count);
+    if (run.cond) glEndConditionalRender();
+}
+
+// Draws arrive sorted by state, so only changes are sent. Animated draws carry their
+// node's world matrix; skinned ones get it from the palette.
+void Model::bindTransform(const Draw& d) const
+{
+    const UniformLocations& L = *bound_.locs;
+    if (d.morphed != bound_.morphed)
+    {
+        glUniform1i(L.morphed, d.morphed ? 1 : 0);
+        bound_.morphed = d.morphed;
+    }
+    const int node = d.skinned ? -1 : d.node;
+    if (node == bound_.node && d.skinned == bound_.skinned) return;
+    const glm::mat4 M = (node >= 0) ? frame_.model * graph_.world(node) : frame_.model;
+    const glm::mat3 N = glm::transpose(glm::inverse(glm::mat3(M)));
+    glUniformMatrix4fv(L.model, 1, GL_FALSE, glm::value_ptr(M));
+    glUniformMatrix3fv(L.normalMat, 1, GL_FALSE, glm::value_ptr(N));
+    if (d.skinned != bound_.skinned) glUniform1i(L.skinned, d.skinned ? 1 : 0);
+    bound_.node = node;
+    bound_.skinned = d.skinned;
+}
+
+void Model::bindMaterial(const Draw& d) const
+{
+    bindTransform(d);
+    if (d.material != bound_.material)
+    {
+        materials_.bind(d.material);
+        bound_.material = d.material;
+    }
+    if (d.tex && d.tex != bound_.tex)
+    {
+        glActiveTexture(GL_TEXTURE0 + Phong::BaseColorUnit);
+        glBindTexture(GL_TEXTURE_2D, d.tex);
+        bound_.tex = d.tex;
+    }
+    if (d.normalTex && d.normalTex != bound_.normalTex)
+    {
+        glActiveTexture(GL_TEXTURE0 + Phong::NormalUnit);
+        glBindTexture(GL_TEXTURE_2D, d.normalTex);
+        glActiveTexture(GL_TEXTURE0);
+        bound_.normalTex = d.normalTex;
+    }
+}
+
+void Model::useProgram(const Shader& shader) const
+{
+    if (&shader == bound_.shader) return;
+    shader.use();
+    const UniformLocations& L = locations(shader);
+    const glm::mat3 normalMat = glm::transpose(glm::inverse(glm::mat3(frame_.model)));
+    glUniformMatrix4fv(L.model, 1, GL_FALSE, glm::value_ptr(frame_.model));
+    glUniformMatrix3fv(L.normalMat, 1, GL_FALSE, glm::value_ptr(normalMat));
+    glUniform1i(L.skinned, 0);
+    glUniform1i(L.morphed, 0);
+    bound_.shader = &shader;
+    bound_.locs = &L;
+    bound_.node = -1;
+    bound_.skinned = bound_.morphed = false;
+}
+
+void Model::ensureBoxVao() const
+{
+    if (boxVao_) return;
+    static const float kCube[] = {
+        0,0,0, 1,0,0, 1,1,0,  0,0,0, 1,1,0, 0,1,0,   0,0,1, 1,1,1, 1,0,1,  0,0,1, 0,1,1, 1,1,1,
+        0,0,0, 0,1,1, 0,0,1,  0,0,0, 0,1,0, 0,1,1,   1,0,0, 1,0,1, 1,1,1,  1,0,0, 1,1,1, 1,1,0,
+        0,0,0, 0,0,1, 1,0,1,  0,0,0, 1,0,1, 1,0,0,   0,1,0, 1,1,1, 0,1,1,  0,1,0, 1,1,0, 1,1,1 };
+    glGenVertexArrays(1, &boxVao_);
+    glGenBuffers(1, &boxVbo_);
+    glBindVertexArray(boxVao_);
+    glBindBuffer(GL_ARRAY_BUFFER, boxVbo_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(kCube), kCube, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glBindVertexArray(0);
 }
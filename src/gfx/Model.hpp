@@ -1,16 +1,26 @@
 #pragma once
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
+#include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 
 #include "gfx/Shader.hpp"
+#include "gfx/ShaderVariants.hpp"
+#include "gfx/SceneGraph.hpp"
+#include "gfx/Animation.hpp"
+#include "gfx/UniformBuffers.hpp"
+#include "gfx/RenderQueue.hpp"
 #include "core/Camera.hpp"
+#include "core/Bvh.hpp"
+#include "core/OcclusionBuffer.hpp"
 
 using GLuint = unsigned int;
 
-class Model {
+class Model : public RenderQueue::Submitter {
 public:
     Model() = default;
     ~Model();
@@ -18,11 +28,93 @@ public:
     // Load a .gltf or .glb file (geometry only; colors if present). Returns false on error.
     bool loadGLTF(const std::string& path);
 
-    // Auto-detect by file extension: .gltf, .glb
+    // Load a Wavefront .obj (with optional .mtl colors/textures). Parsed in parallel chunks.
+    bool loadOBJ(const std::string& path);
+
+    // Load a binary .stl. Parsed in parallel chunks.
+    bool loadSTL(const std::string& path);
+
+    // Auto-detect by file extension: .gltf, .glb, .obj, .stl
     bool load(const std::string& path);
 
-    // Draw with Phong shader (provided by caller or owned here)
-    void render(const Camera& cam, const glm::mat4& model, Shader& shader) const;
+    // Re-read the current glTF file after it changed on disk, skipping the decode of
+    // unchanged images and re-uploading only changed primitives and textures into the
+    // existing GL objects. A failed reload keeps the current model intact. Other
+    // formats (reloadsInPlace() false) are loaded into a new Model instead, since
+    // their loaders start by releasing everything.
+    bool reload();
+    bool reloadsInPlace() const;
+    struct ReloadStats {
+        bool incremental = false;
+        int drawsUploaded = 0, drawsTotal = 0;
+        int texturesUploaded = 0, texturesTotal = 0;
+    };
+    const ReloadStats& lastReload() const { return reloadStats_; }
+
+    // Files the current model was read from (model, external buffers and images)
+    const std::vector<std::string>& sourceFiles() const { return sourceFiles_; }
+
+    // Advance the active animation and refresh skinning joints (no-op for static models)
+    void update(float dt);
+    int animationCount() const { return (int)clips_.size(); }
+    int animation() const { return activeClip_; }
+    void setAnimation(int index);
+
+    // Batched mode packs material textures into texture arrays (bucketed by size and
+    // color space) and material factors into a buffer texture indexed per vertex, so
+    // all opaque static geometry draws in one call and blended geometry in another.
+    // Unavailable (canBatch() false) when the textures need more than kBatchArrays arrays.
+    void setBatched(bool on);
+    bool batched() const { return batched_ && batch_.ready; }
+    bool canBatch() const { return batch_.ready; }
+    static constexpr int kBatchArrays = Phong::kTexArrays;
+
+    // GPU-driven mode (GL 4.3+): the static opaque draws are frustum-culled by the
+    // compute shader passed to submit(), which writes multi-draw-indirect commands, and
+    // are submitted with a single call. Shades like batched mode; without GL 4.3 or a
+    // cull shader the CPU path is used.
+    void setGpuDriven(bool on);
+    bool gpuDriven() const { return gpuDriven_ && batch_.ready && batch_.cullCount > 0; }
+
+    // Software occlusion culling: the largest static opaque draws are rasterized on the CPU
+    // into a low-resolution depth buffer each frame and every draw that survived frustum
+    // culling is tested against it before submission. Draws culled on the GPU are not tested.
+    void setOcclusionCulling(bool on) { occlusionCulling_ = on; }
+    bool occlusionCulling() const { return occlusionCulling_; }
+    static constexpr int kOccluderTriangles = 16384;
+
+    // Hardware occlusion queries (CPU path): BVH nodes hidden at their last query are
+    // drawn under conditional rendering on one box query per node, so a hidden subtree
+    // costs a single query. Visible leaves re-query every kQueryInterval frames and results
+    // are read a frame late, so the CPU never waits on the GPU.
+    void setOcclusionQueries(bool on) { occlusionQueries_ = on; }
+    bool occlusionQueries() const { return occlusionQueries_; }
+    static constexpr int kQueryInterval = 4;
+
+    // Depth pre-pass: static opaque draws are first drawn from a tightly packed
+    // position-only stream with the depth shader passed to submit() (phong.vert with
+    // depth.frag, so positions match bit for bit), then shaded with GL_EQUAL and depth
+    // writes off, so hidden fragments never run the lighting shader.
+    // Skinned, morphed, query-gated and GPU-culled draws are shaded as usual.
+    void setDepthPrepass(bool on) { depthPrepass_ = on; }
+    bool depthPrepass() const { return depthPrepass_; }
+
+    // Cull and record this frame's packets: one per draw (or per run of merged batched
+    // draws), plus query boxes and the indirect call. The queue sorts them by pass, state
+    // and depth, so blended draws come back to front, or go unsorted into the OIT pass
+    // when the queue has one. Each packet picks the phong variant its draw needs: the
+    // caller's frame features (Phong::Lighting, Phong::Environment) plus the draw's
+    // textures, batching and OIT. Shaders and model must stay alive until the queue has executed.
+    void submit(RenderQueue& queue, const Camera& cam, const glm::mat4& model, const ShaderVariants& shaders,
+                uint32_t frameFeatures, const Shader* cullShader = nullptr, const Shader* depthShader = nullptr) const;
+
+    // RenderQueue::Submitter
+    void bind(RenderQueue::Pass pass) const override;
+    void draw(uint32_t item) const override;
+
+    // Draws that passed frustum (and occlusion) culling in the last submit(), out of all draws
+    int visibleDraws() const { return visibleDraws_; }
+    int drawCount() const { return (int)draws_.size(); }
 
     // Simple bounds for framing the camera
     void getBounds(glm::vec3& minOut, glm::vec3& maxOut) const { minOut = bmin_; maxOut = bmax_; }
@@ -33,22 +125,189 @@ public:
     void shutdown();
 
 private:
-    struct Vertex { glm::vec3 pos; glm::vec3 nrm; glm::vec3 col; glm::vec2 uv; };
+    struct Vertex {
+        glm::vec3 pos; glm::vec3 nrm; glm::vec3 col; glm::vec2 uv;
+        glm::vec4 tan{0.0f}; // xyz tangent, w bitangent sign; zero when there is no normal map
+    };
     struct Draw {
         int first = 0;
         int count = 0;
         unsigned int tex = 0;
         bool blend = false;              // glTF material alphaMode == BLEND
         glm::vec4 baseColorFactor{1.0f}; // glTF baseColorFactor
+        unsigned int normalTex = 0;      // tangent-space normal map (linear)
+        float normalScale = 1.0f;        // glTF normalTexture.scale
+        int node = -1;                   // scene graph node for animated draws; -1 = baked into vertices
+        bool skinned = false;            // vertices are skinned by the joint palette
+        bool morphed = false;            // vertices carry morph target deltas
+        int material = 0;                // range in materials_
+        glm::vec3 bmin{0.0f}, bmax{0.0f};  // bounds of the vertex range (node space for animated draws)
     };
+    struct SkinVertex { uint16_t joints[4]; float weights[4]; }; // joints index the global palette
+    struct MorphVertex { uint32_t first = 0, count = 0; };        // range of delta records
 
     GLuint vao_ = 0, vbo_ = 0;
+    GLuint depthVao_ = 0, posVbo_ = 0; // positions only, for the depth pre-pass
     int vertexCount_ = 0; // non-indexed triangles
     glm::vec3 bmin_{0}, bmax_{0}; // AABB in object space
     std::string err_;
 
-    std::vector<Draw> draws_;
+    std::vector<Draw> draws_;            // opaque draws sorted by state, then blended draws in file order
+    int opaqueCount_ = 0;                // draws_[0, opaqueCount_) are opaque
     std::vector<unsigned int> textures_; // owned GL textures
 
+    MaterialBuffer materials_;           // one "Material" block range per distinct material
+
+    // Frustum culling: static draws (baked into vertices) sit in a BVH over their object-space
+    // bounds; draws under animated nodes are tested one by one with their node transform.
+    // Skinned and morphed draws are always submitted.
+    Bvh bvh_;
+    std::vector<int> bvhDraws_;              // BVH item -> draw index
+    mutable std::vector<uint8_t> bvhVisible_, visible_;
+    mutable int visibleDraws_ = 0;
+    // Occluder triangles in object space, three positions each, taken from the largest
+    // static opaque draws up to kOccluderTriangles (larger draws are subsampled)
+    std::vector<glm::vec3> occluderTris_;
+    mutable OcclusionBuffer occlusion_;
+    bool occlusionCulling_ = false;
+
+    // Occlusion query state, one entry per BVH node. hidden holds for a node iff it holds
+    // for every leaf below it. Each node alternates two query objects so the one issued
+    // last frame can be read while this frame's is recorded.
+    struct QueryNode {
+        GLuint queries[2] = {};
+        int issued = -1;      // frame of the last query, -1 if none
+        bool hidden = false;
+    };
+    mutable std::vector<QueryNode> queryNodes_;
+    mutable std::vector<int> queryBoxes_;          // nodes to query this frame
+    mutable std::vector<GLuint> drawCondition_;    // per draw: query gating it this frame, 0 if none
+    mutable int queryFrame_ = 0;
+    mutable GLuint boxVao_ = 0, boxVbo_ = 0;       // unit cube for query boxes
+    bool occlusionQueries_ = false;
+    bool depthPrepass_ = false;
+    // Read last frame's results and pick the nodes to query; fills drawCondition_
+    void prepareQueries(const Camera& cam, const glm::mat4& model) const;
+    void releaseQueries();
+    void cullDraws(const Camera& cam, const glm::mat4& model, size_t gpuCulled) const;
+
+    // Packets of the current frame. Items index runs_ except the two tagged ones.
+    struct Run {
+        int draw = -1;        // first draw of the run; -1 draws the whole vertex buffer
+        int first = 0, count = 0;
+        GLuint cond = 0;      // occlusion query gating the run, 0 if none
+        const Shader* shader = nullptr; // phong variant
+    };
+    static constexpr uint32_t kIndirectItem = 0xFFFFFFFFu;
+    static constexpr uint32_t kBoxItem = 0x80000000u;  // | BVH node of a query box
+    static constexpr uint32_t kDepthItem = 0x40000000u; // | run drawn in the depth pre-pass
+    mutable std::vector<Run> runs_;
+    struct FrameState {
+        const Shader* indirectShader = nullptr; // variants of the indirect call and query boxes
+        const Shader* boxShader = nullptr;
+        const Shader* depthShader = nullptr;
+        GLint depthModel = -1;    // uModel in depthShader
+        glm::mat4 model{1.0f};
+        bool batched = false, gpu = false, compact = false;
+    };
+    mutable FrameState frame_;
+    // State sent since the last bind(), so sorted packets only send changes
+    struct UniformLocations;
+    struct BoundState {
+        const Shader* shader = nullptr;
+        const UniformLocations* locs = nullptr;
+        int node = -1;
+        bool skinned = false, morphed = false;
+        int material = -1;
+        unsigned int tex = 0, normalTex = 0;
+    };
+    mutable BoundState bound_;
+    void bindTransform(const Draw& d) const;
+    void bindMaterial(const Draw& d) const;
+    void ensureBoxVao() const;
+    // Switch to a variant mid-pass; transforms are resent since uniforms are per program
+    void useProgram(const Shader& shader) const;
+
+    // Uniform locations per variant, resolved (and sampler units set) on first use
+    struct UniformLocations {
+        GLint model = -1, normalMat = -1;
+        GLint skinned = -1, morphed = -1;
+    };
+    mutable std::unordered_map<GLuint, UniformLocations> locs_;
+    const UniformLocations& locations(const Shader& shader) const;
+
+    // Batched rendering resources, built on demand and after every (re)load while enabled.
+    // The table holds three RGBA32F texels per material: base color factor; (normal scale,
+    // base array, base layer, normal array); (normal layer). Array -1 means no texture.
+    struct Batch {
+        bool ready = false;
+        GLuint materialVbo = 0;               // per-vertex material index, attribute 8
+        GLuint tableBuffer = 0, tableTex = 0;
+        GLuint arrays[kBatchArrays] = {};
+        int arrayCount = 0;
+        // GPU-driven path: draws_[0, cullCount) are static and opaque
+        GLuint drawInfoBuffer = 0;            // SSBO of bounds + vertex range per draw
+        GLuint commandBuffer = 0;             // indirect commands written by the cull shader
+        GLuint counterBuffer = 0;             // visible count (indirect-count parameter)
+        int cullCount = 0;
+    };
+    Batch batch_;
+    bool batched_ = false;
+    bool gpuDriven_ = false;
+    void buildBatch();
+    void releaseBatch();
+
+    // Hot reload bookkeeping
+    std::string path_;
+    std::vector<std::string> sourceFiles_;
+    std::vector<uint64_t> drawHashes_;      // content hash of each draw's vertex range
+    std::vector<uint64_t> imageHashes_;     // hash of each glTF image's encoded bytes
+    struct TextureRecord { unsigned int id = 0; uint64_t hash = 0; };
+    std::unordered_map<int, TextureRecord> gltfTextures_; // (texture index, srgb) -> GL texture
+    ReloadStats reloadStats_;
+
+    bool loadGLTFImpl(const std::string& path, bool incremental);
+
+    // Retained hierarchy for animated files. Static subtrees are still baked into
+    // vertices; only draws under animated or skinned nodes reference a graph node.
+    SceneGraph graph_;
+    std::vector<AnimationClip> clips_;
+    Animator animator_;
+    int activeClip_ = -1;
+
+    // Joint palette of every skin, concatenated: world(joint) * inverseBind
+    std::vector<int> jointNodes_;
+    std::vector<glm::mat4> inverseBind_;
+    std::vector<glm::mat4> jointMatrices_;
+    GLuint skinVbo_ = 0;
+    GLuint jointBuffer_ = 0, jointTex_ = 0; // texture buffer, 4 RGBA32F texels per joint
+
+    // Morph targets: only non-zero deltas are kept, as records of two RGBA32F texels
+    // (position delta + weight slot, normal delta). Each vertex references its own
+    // contiguous record range; the base vertices are never modified.
+    std::vector<float> morphWeights_;    // one slot per (node, target)
+    GLuint morphVbo_ = 0;
+    GLuint morphDeltaBuffer_ = 0, morphDeltaTex_ = 0;
+    GLuint morphWeightBuffer_ = 0, morphWeightTex_ = 0;
+
+    // Sort opaque draws by render state (blended ones keep file order after them), reorder
+    // the vertex streams to match, merge neighbours that share all state and upload the
+    // distinct materials. Called by every loader before upload.
+    void sortAndMergeDraws(std::vector<Vertex>& verts, std::vector<SkinVertex>* skinVerts = nullptr,
+                           std::vector<MorphVertex>* morphVerts = nullptr);
+
+    // Create the VAO/VBO for a non-indexed triangle list and record the vertex count
+    void uploadVertices(const std::vector<Vertex>& verts);
+    // Positions of verts[first, first + count) into the pre-pass stream (whole stream if count < 0)
+    void uploadPositions(const std::vector<Vertex>& verts, int first = 0, int count = -1);
+    // Per-vertex joints/weights as a second VBO on the same VAO, plus the joint palette buffer
+    void uploadSkinning(const std::vector<SkinVertex>& skinVerts);
+    void updateJoints();
+    void uploadMorphs(const std::vector<MorphVertex>& morphVerts, const std::vector<glm::vec4>& deltas);
+    void updateMorphWeights();
+    // Drop graph, animation, skinning and morph state (kept separate from the vertex data)
+    void releaseAnimation();
+    void releaseAnimationBuffers(); // GL side only; the CPU state stays
+
     static void computeFlatNormal(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, glm::vec3& n);
 };
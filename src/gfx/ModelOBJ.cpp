@@ -0,0 +1,541 @@
+#include "gfx/Model.hpp"
+#include "core/MappedFile.hpp"
+#include "core/ThreadPool.hpp"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+
+// Wavefront OBJ loader.
+//
+// The file is memory-mapped and split into chunks on line boundaries. Three
+// parallel passes run over the chunks:
+//   1. count v/vt/vn records per chunk (a prefix sum then gives each chunk its
+//      global attribute offsets)
+//   2. parse attributes straight into the global arrays and resolve face
+//      corners (including negative, relative indices) to global indices
+//   3. fan-triangulate faces into the final non-indexed vertex array
+// Material switches (usemtl) become Draw ranges, merged across chunk edges.
+
+namespace {
+
+constexpr size_t kMinChunkBytes = 1u << 20; // 1 MiB
+
+const double kPow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool isDigit(char c) { return (unsigned)(c - '0') < 10u; }
+
+inline const char* skipSpaces(const char* p, const char* end)
+{
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    return p;
+}
+
+inline const char* nextLine(const char* p, const char* end)
+{
+    const void* nl = std::memchr(p, '\n', size_t(end - p));
+    return nl ? static_cast<const char*>(nl) + 1 : end;
+}
+
+// Decimal float parser for the plain "[-]123.456[e-7]" numbers OBJ exporters write.
+// Accumulates up to 19 significant digits in an integer and scales once, which is
+// several times faster than strtof and accurate to float precision.
+const char* parseFloat(const char* p, const char* end, float& out)
+{
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) { neg = (*p == '-'); ++p; }
+
+    uint64_t mant = 0;
+    int digits = 0;
+    int exp10 = 0;
+    bool any = false;
+    while (p < end && isDigit(*p))
+    {
+        any = true;
+        if (digits < 19) { mant = mant * 10 + uint64_t(*p - '0'); if (mant) ++digits; }
+        else ++exp10;
+        ++p;
+    }
+    if (p < end && *p == '.')
+    {
+        ++p;
+        while (p < end && isDigit(*p))
+        {
+            any = true;
+            if (digits < 19) { mant = mant * 10 + uint64_t(*p - '0'); if (mant) ++digits; --exp10; }
+            ++p;
+        }
+    }
+    if (!any) { out = 0.0f; return p; }
+
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char* q = p + 1;
+        bool eneg = false;
+        if (q < end && (*q == '-' || *q == '+')) { eneg = (*q == '-'); ++q; }
+        if (q < end && isDigit(*q))
+        {
+            int e = 0;
+            while (q < end && isDigit(*q)) { if (e < 10000) e = e * 10 + (*q - '0'); ++q; }
+            exp10 += eneg ? -e : e;
+            p = q;
+        }
+    }
+
+    double v = double(mant);
+    if (exp10 < 0)      v = (exp10 >= -22) ? v / kPow10[-exp10] : v * std::pow(10.0, exp10);
+    else if (exp10 > 0) v = (exp10 <= 22)  ? v * kPow10[exp10]  : v * std::pow(10.0, exp10);
+    out = float(neg ? -v : v);
+    return p;
+}
+
+const char* parseInt(const char* p, const char* end, long long& out, bool& ok)
+{
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) { neg = (*p == '-'); ++p; }
+    long long v = 0;
+    ok = false;
+    while (p < end && isDigit(*p)) { v = v * 10 + (*p - '0'); ++p; ok = true; }
+    out = neg ? -v : v;
+    return p;
+}
+
+struct ObjCorner { int64_t v = -1, t = -1, n = -1; };
+
+struct ObjChunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+
+    size_t numV = 0, numT = 0, numN = 0;    // pass 1
+    size_t baseV = 0, baseT = 0, baseN = 0; // prefix sums
+    bool vertexColors = false;
+
+    std::vector<ObjCorner> corners;         // pass 2
+    std::vector<uint32_t> faceStart;        // per face offset into corners, plus end sentinel
+    std::vector<std::pair<size_t, std::string>> useMtl; // (chunk-local triangle index, name)
+    std::string mtllib;
+    size_t triCount = 0;
+    size_t triBase = 0;
+    bool badIndex = false;
+
+    int startMaterial = -1;                 // resolved material ids
+    std::vector<std::pair<size_t, int>> matRuns;
+
+    glm::vec3 bmin{ std::numeric_limits<float>::max() };
+    glm::vec3 bmax{ std::numeric_limits<float>::lowest() };
+};
+
+struct ObjMaterial {
+    glm::vec3 kd{0.75f};
+    float d = 1.0f;
+    std::string mapKd;
+};
+
+std::string dirOf(const std::string& path)
+{
+    const auto slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+}
+
+std::string trim(const std::string& s)
+{
+    const auto b = s.find_first_not_of(" \t\r");
+    if (b == std::string::npos) return {};
+    const auto e = s.find_last_not_of(" \t\r");
+    return s.substr(b, e - b + 1);
+}
+
+// .mtl files are tiny next to the geometry, so a plain sequential reader is fine
+void parseMtl(const std::string& path, std::unordered_map<std::string, ObjMaterial>& out)
+{
+    std::ifstream in(path);
+    if (!in) return;
+    std::string line;
+    ObjMaterial* cur = nullptr;
+    while (std::getline(in, line))
+    {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream ss(line);
+        std::string key; ss >> key;
+        if (key == "newmtl")
+        {
+            std::string name; std::getline(ss, name);
+            cur = &out[trim(name)];
+        }
+        else if (!cur) continue;
+        else if (key == "Kd") { ss >> cur->kd.r >> cur->kd.g >> cur->kd.b; }
+        else if (key == "d")  { ss >> cur->d; }
+        else if (key == "Tr") { float tr = 0.0f; ss >> tr; cur->d = 1.0f - tr; }
+        else if (key == "map_Kd")
+        {
+            // Options (-s, -o, ...) precede the file name; take the last token
+            std::string tok, last;
+            while (ss >> tok) last = tok;
+            cur->mapKd = last;
+        }
+    }
+}
+
+unsigned int loadTextureFile(const std::string& path)
+{
+    int w = 0, h = 0, comp = 0;
+    unsigned char* pixels = stbi_load(path.c_str(), &w, &h, &comp, 4);
+    if (!pixels) return 0U;
+    unsigned int tex = 0;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8_ALPHA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    stbi_image_free(pixels);
+    return tex;
+}
+
+// Pass 1: count attribute records so every chunk knows where its data lands
+void countChunk(ObjChunk& c)
+{
+    const char* end = c.end;
+    bool firstV = true;
+    for (const char* p = c.begin; p < end; p = nextLine(p, end))
+    {
+        const char* q = skipSpaces(p, end);
+        if (end - q < 2 || q[0] != 'v') continue;
+        if (q[1] == ' ' || q[1] == '\t')
+        {
+            ++c.numV;
+            if (firstV)
+            {
+                // "v x y z r g b" vertex color extension: more than three numbers
+                firstV = false;
+                int numbers = 0;
+                const char* lineEnd = nextLine(q, end);
+                const char* s = q + 1;
+                float tmp;
+                while (true)
+                {
+                    s = skipSpaces(s, lineEnd);
+                    if (s >= lineEnd || *s == '\r' || *s == '\n') break;
+                    const char* t = parseFloat(s, lineEnd, tmp);
+                    if (t == s) break;
+                    s = t; ++numbers;
+                }
+                c.vertexColors = numbers >= 6;
+            }
+        }
+        else if (q[1] == 't') ++c.numT;
+        else if (q[1] == 'n') ++c.numN;
+    }
+}
+
+// Pass 2: parse attributes into the global arrays and resolve face corners
+void parseChunk(ObjChunk& c, std::vector<float>& P, std::vector<float>& C, std::vector<float>& T,
+                std::vector<float>& N, size_t totalV, size_t totalT, size_t totalN)
+{
+    const char* end = c.end;
+    size_t cv = 0, ct = 0, cn = 0;
+    const bool wantColors = !C.empty();
+
+    auto resolve = [](long long idx, size_t seen, size_t total, bool& bad) -> int64_t {
+        long long r = idx > 0 ? idx - 1 : (long long)seen + idx;
+        if (idx == 0 || r < 0 || r >= (long long)total) { bad = true; return -1; }
+        return r;
+    };
+
+    for (const char* p = c.begin; p < end; p = nextLine(p, end))
+    {
+        const char* q = skipSpaces(p, end);
+        if (q >= end) break;
+        const char* lineEnd = nextLine(q, end);
+
+        if (q[0] == 'v')
+        {
+            if (end - q < 2) continue;
+            if (q[1] == ' ' || q[1] == '\t')
+            {
+                const size_t i = c.baseV + cv++;
+                const char* s = q + 1;
+                for (int k = 0; k < 3; ++k) s = parseFloat(skipSpaces(s, lineEnd), lineEnd, P[3*i+k]);
+                if (wantColors)
+                {
+                    float rgb[3] = {0.75f, 0.75f, 0.75f};
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        const char* s2 = skipSpaces(s, lineEnd);
+                        const char* t = parseFloat(s2, lineEnd, rgb[k]);
+                        if (t == s2) { rgb[0] = rgb[1] = rgb[2] = 0.75f; break; }
+                        s = t;
+                    }
+                    C[3*i+0] = rgb[0]; C[3*i+1] = rgb[1]; C[3*i+2] = rgb[2];
+                }
+            }
+            else if (q[1] == 't')
+            {
+                const size_t i = c.baseT + ct++;
+                const char* s = q + 2;
+                for (int k = 0; k < 2; ++k) s = parseFloat(skipSpaces(s, lineEnd), lineEnd, T[2*i+k]);
+            }
+            else if (q[1] == 'n')
+            {
+                const size_t i = c.baseN + cn++;
+                const char* s = q + 2;
+                for (int k = 0; k < 3; ++k) s = parseFloat(skipSpaces(s, lineEnd), lineEnd, N[3*i+k]);
+            }
+        }
+        else if (q[0] == 'f' && end - q > 1 && (q[1] == ' ' || q[1] == '\t'))
+        {
+            const uint32_t first = (uint32_t)c.corners.size();
+            const char* s = q + 1;
+            for (;;)
+            {
+                s = skipSpaces(s, lineEnd);
+                long long iv = 0; bool ok = false;
+                const char* t = parseInt(s, lineEnd, iv, ok);
+                if (!ok) break;
+                ObjCorner corner;
+                corner.v = resolve(iv, c.baseV + cv, totalV, c.badIndex);
+                if (t < lineEnd && *t == '/')
+                {
+                    ++t;
+                    long long it = 0; bool okT = false;
+                    t = parseInt(t, lineEnd, it, okT);
+                    if (okT) corner.t = resolve(it, c.baseT + ct, totalT, c.badIndex);
+                    if (t < lineEnd && *t == '/')
+                    {
+                        ++t;
+                        long long in = 0; bool okN = false;
+                        t = parseInt(t, lineEnd, in, okN);
+                        if (okN) corner.n = resolve(in, c.baseN + cn, totalN, c.badIndex);
+                    }
+                }
+                c.corners.push_back(corner);
+                s = t;
+            }
+            const uint32_t count = (uint32_t)c.corners.size() - first;
+            if (count < 3)
+            {
+                c.corners.resize(first); // points/lines are not drawn
+                continue;
+            }
+            c.faceStart.push_back(first);
+            c.triCount += count - 2;
+        }
+        else if (lineEnd - q > 6 && (q[6] == ' ' || q[6] == '\t') &&
+                 (std::memcmp(q, "usemtl", 6) == 0 || std::memcmp(q, "mtllib", 6) == 0))
+        {
+            std::string name(q + 6, lineEnd);
+            name = trim(name.substr(0, name.find_first_of("\r\n")));
+            if (q[0] == 'u') c.useMtl.emplace_back(c.triCount, name);
+            else if (c.mtllib.empty()) c.mtllib = name;
+        }
+    }
+    c.faceStart.push_back((uint32_t)c.corners.size());
+}
+
+} // namespace
+
+bool Model::loadOBJ(const std::string& path)
+{
+    shutdown();
+    err_.clear();
+
+    MappedFile file;
+    if (!file.Open(path)) { err_ = "Failed to open OBJ: " + path; return false; }
+    if (file.Size() == 0) { err_ = "Empty OBJ file: " + path; return false; }
+
+    const char* data = file.Data();
+    const char* dataEnd = data + file.Size();
+    ThreadPool& pool = ThreadPool::Get();
+
+    // Split on line boundaries into roughly equal chunks
+    const size_t wanted = std::max<size_t>(1, std::min<size_t>((pool.Size() + 1) * 4, file.Size() / kMinChunkBytes));
+    const size_t approx = file.Size() / wanted + 1;
+    std::vector<ObjChunk> chunks;
+    chunks.reserve(wanted);
+    for (const char* p = data; p < dataEnd; )
+    {
+        const char* stop = (size_t(dataEnd - p) > approx) ? nextLine(p + approx, dataEnd) : dataEnd;
+        ObjChunk c; c.begin = p; c.end = stop;
+        chunks.push_back(std::move(c));
+        p = stop;
+    }
+
+    // Pass 1
+    pool.ParallelFor(chunks.size(), 1, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) countChunk(chunks[i]);
+    });
+
+    size_t totalV = 0, totalT = 0, totalN = 0;
+    bool vertexColors = false;
+    for (auto& c : chunks)
+    {
+        c.baseV = totalV; c.baseT = totalT; c.baseN = totalN;
+        totalV += c.numV; totalT += c.numT; totalN += c.numN;
+        if (c.numV) vertexColors = vertexColors || c.vertexColors;
+    }
+    if (totalV == 0) { err_ = "No vertices found in OBJ."; return false; }
+
+    std::vector<float> P(totalV * 3), T(totalT * 2), N(totalN * 3), C;
+    if (vertexColors) C.resize(totalV * 3);
+
+    // Pass 2
+    pool.ParallelFor(chunks.size(), 1, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) parseChunk(chunks[i], P, C, T, N, totalV, totalT, totalN);
+    });
+
+    std::string mtllib;
+    size_t totalTris = 0;
+    for (auto& c : chunks)
+    {
+        if (c.badIndex) { err_ = "OBJ face references a vertex that does not exist."; return false; }
+        if (mtllib.empty()) mtllib = c.mtllib;
+        c.triBase = totalTris;
+        totalTris += c.triCount;
+    }
+    if (totalTris == 0) { err_ = "No triangles found in OBJ."; return false; }
+
+    // Materials: assign ids in first-use order and carry the active one across chunks
+    std::unordered_map<std::string, ObjMaterial> mtlByName;
+    if (!mtllib.empty()) parseMtl(dirOf(path) + mtllib, mtlByName);
+
+    std::vector<ObjMaterial> materials;
+    std::unordered_map<std::string, int> matIds;
+    int current = -1;
+    for (auto& c : chunks)
+    {
+        c.startMaterial = current;
+        for (const auto& u : c.useMtl)
+        {
+            auto it = matIds.find(u.second);
+            if (it == matIds.end())
+            {
+                auto mit = mtlByName.find(u.second);
+                materials.push_back(mit != mtlByName.end() ? mit->second : ObjMaterial{});
+                it = matIds.emplace(u.second, (int)materials.size() - 1).first;
+            }
+            c.matRuns.emplace_back(u.first, it->second);
+            current = it->second;
+        }
+    }
+
+    // Pass 3
+    std::vector<Vertex> verts(totalTris * 3);
+    pool.ParallelFor(chunks.size(), 1, [&](size_t b, size_t e) {
+        for (size_t ci = b; ci < e; ++ci)
+        {
+            ObjChunk& c = chunks[ci];
+            Vertex* out = verts.data() + c.triBase * 3;
+            int mat = c.startMaterial;
+            size_t run = 0, localTri = 0;
+            const size_t faces = c.faceStart.size() - 1;
+            for (size_t f = 0; f < faces; ++f)
+            {
+                while (run < c.matRuns.size() && c.matRuns[run].first <= localTri) mat = c.matRuns[run++].second;
+                const glm::vec3 kd = (mat >= 0) ? materials[mat].kd : glm::vec3(0.75f);
+
+                auto corner = [&](const ObjCorner& k) {
+                    Vertex v;
+                    v.pos = { P[3*k.v+0], P[3*k.v+1], P[3*k.v+2] };
+                    v.nrm = (k.n >= 0) ? glm::vec3(N[3*k.n+0], N[3*k.n+1], N[3*k.n+2]) : glm::vec3(0.0f);
+                    v.col = C.empty() ? kd : glm::vec3(C[3*k.v+0], C[3*k.v+1], C[3*k.v+2]);
+                    // OBJ puts the UV origin bottom-left; textures are uploaded top row first
+                    v.uv = (k.t >= 0) ? glm::vec2(T[2*k.t+0], 1.0f - T[2*k.t+1]) : glm::vec2(0.0f);
+                    return v;
+                };
+
+                const ObjCorner* fc = c.corners.data() + c.faceStart[f];
+                const uint32_t n = c.faceStart[f + 1] - c.faceStart[f];
+                localTri += n - 2;
+                const Vertex v0 = corner(fc[0]);
+                for (uint32_t k = 1; k + 1 < n; ++k)
+                {
+                    Vertex tri[3] = { v0, corner(fc[k]), corner(fc[k + 1]) };
+                    if (fc[0].n < 0 || fc[k].n < 0 || fc[k + 1].n < 0)
+                    {
+                        glm::vec3 fn;
+                        computeFlatNormal(tri[0].pos, tri[1].pos, tri[2].pos, fn);
+                        for (auto& v : tri) if (v.nrm == glm::vec3(0.0f)) v.nrm = fn;
+                    }
+                    for (auto& v : tri)
+                    {
+                        c.bmin = glm::min(c.bmin, v.pos);
+                        c.bmax = glm::max(c.bmax, v.pos);
+                        *out++ = v;
+                    }
+                }
+            }
+        }
+    });
+
+    // Draw ranges: one per material run, merged across chunk boundaries
+    std::unordered_map<std::string, unsigned int> texCache;
+    auto makeDraw = [&](int mat, int first, int count) {
+        Draw d;
+        d.first = first;
+        d.count = count;
+        if (mat >= 0)
+        {
+            const ObjMaterial& m = materials[mat];
+            d.baseColorFactor = glm::vec4(1.0f, 1.0f, 1.0f, m.d);
+            d.blend = m.d < 1.0f;
+            if (!m.mapKd.empty())
+            {
+                auto it = texCache.find(m.mapKd);
+                if (it == texCache.end())
+                {
+                    unsigned int tex = loadTextureFile(dirOf(path) + m.mapKd);
+                    if (tex) textures_.push_back(tex);
+                    it = texCache.emplace(m.mapKd, tex).first;
+                }
+                d.tex = it->second;
+            }
+        }
+        return d;
+    };
+
+    int runMat = -2;
+    size_t runFirstTri = 0;
+    auto closeRun = [&](size_t endTri) {
+        if (runMat != -2 && endTri > runFirstTri)
+            draws_.push_back(makeDraw(runMat, int(runFirstTri * 3), int((endTri - runFirstTri) * 3)));
+    };
+    glm::vec3 bmin{ std::numeric_limits<float>::max() };
+    glm::vec3 bmax{ std::numeric_limits<float>::lowest() };
+    for (const auto& c : chunks)
+    {
+        bmin = glm::min(bmin, c.bmin);
+        bmax = glm::max(bmax, c.bmax);
+
+        if (c.startMaterial != runMat) { closeRun(c.triBase); runMat = c.startMaterial; runFirstTri = c.triBase; }
+        for (const auto& r : c.matRuns)
+        {
+            if (r.second == runMat) continue;
+            closeRun(c.triBase + r.first);
+            runMat = r.second;
+            runFirstTri = c.triBase + r.first;
+        }
+    }
+    closeRun(totalTris);
+
+    sortAndMergeDraws(verts);
+    uploadVertices(verts);
+    bmin_ = bmin; bmax_ = bmax;
+    return true;
+}
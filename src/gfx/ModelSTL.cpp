@@ -0,0 +1,90 @@
+#include "gfx/Model.hpp"
+#include "core/MappedFile.hpp"
+#include "core/ThreadPool.hpp"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+// Binary STL: 80-byte header, uint32 triangle count, then 50-byte records
+// (normal, three positions, uint16 attribute). Records are fixed size, so the
+// mapped file splits into triangle ranges that decode independently.
+
+namespace {
+
+constexpr size_t kHeaderSize = 84;
+constexpr size_t kRecordSize = 50;
+constexpr size_t kMinChunkTris = 1u << 15;
+
+inline glm::vec3 readVec3(const char* p)
+{
+    float f[3];
+    std::memcpy(f, p, sizeof(f)); // records are not 4-byte aligned
+    return { f[0], f[1], f[2] };
+}
+
+} // namespace
+
+bool Model::loadSTL(const std::string& path)
+{
+    shutdown();
+    err_.clear();
+
+    MappedFile file;
+    if (!file.Open(path)) { err_ = "Failed to open STL: " + path; return false; }
+    if (file.Size() < kHeaderSize) { err_ = "STL file too small: " + path; return false; }
+
+    const char* data = file.Data();
+    uint32_t triCount = 0;
+    std::memcpy(&triCount, data + 80, sizeof(triCount));
+    if (file.Size() != kHeaderSize + size_t(triCount) * kRecordSize)
+    {
+        // ASCII STL starts with "solid"; so do some binary headers, hence the size check
+        err_ = (std::strncmp(data, "solid", 5) == 0)
+            ? "ASCII STL is not supported; export as binary STL."
+            : "Corrupt binary STL (size does not match triangle count).";
+        return false;
+    }
+    if (triCount == 0) { err_ = "No triangles found in STL."; return false; }
+
+    std::vector<Vertex> verts(size_t(triCount) * 3);
+    glm::vec3 bmin{ std::numeric_limits<float>::max() };
+    glm::vec3 bmax{ std::numeric_limits<float>::lowest() };
+    std::mutex boundsMutex;
+
+    ThreadPool::Get().ParallelFor(triCount, kMinChunkTris, [&](size_t b, size_t e) {
+        glm::vec3 lmin{ std::numeric_limits<float>::max() };
+        glm::vec3 lmax{ std::numeric_limits<float>::lowest() };
+        for (size_t i = b; i < e; ++i)
+        {
+            const char* rec = data + kHeaderSize + i * kRecordSize;
+            const glm::vec3 p0 = readVec3(rec + 12);
+            const glm::vec3 p1 = readVec3(rec + 24);
+            const glm::vec3 p2 = readVec3(rec + 36);
+            // Stored facet normals are often zero or stale; recompute from winding
+            glm::vec3 n;
+            computeFlatNormal(p0, p1, p2, n);
+
+            Vertex* out = verts.data() + i * 3;
+            out[0] = { p0, n, glm::vec3(0.75f), glm::vec2(0.0f) };
+            out[1] = { p1, n, glm::vec3(0.75f), glm::vec2(0.0f) };
+            out[2] = { p2, n, glm::vec3(0.75f), glm::vec2(0.0f) };
+            lmin = glm::min(lmin, glm::min(p0, glm::min(p1, p2)));
+            lmax = glm::max(lmax, glm::max(p0, glm::max(p1, p2)));
+        }
+        std::lock_guard<std::mutex> lock(boundsMutex);
+        bmin = glm::min(bmin, lmin);
+        bmax = glm::max(bmax, lmax);
+    });
+
+    draws_.push_back({0, (int)verts.size(), 0U, false, glm::vec4(1.0f)});
+
+    sortAndMergeDraws(verts);
+    uploadVertices(verts);
+    bmin_ = bmin; bmax_ = bmax;
+    return true;
+}
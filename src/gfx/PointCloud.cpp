@@ -0,0 +1,767 @@
+#include "gfx/PointCloud.hpp"
+#include "core/ThreadPool.hpp"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <queue>
+#include <sstream>
+
+namespace {
+
+constexpr uint64_t kTargetPointsPerNode = 20000;
+constexpr uint32_t kMaxDepth = 12;
+constexpr size_t kMinChunkPoints = 1u << 16;
+constexpr float kMinNodePixels = 80.0f;          // do not refine nodes smaller than this on screen
+constexpr uint64_t kUploadPointsPerFrame = 1000000;
+constexpr size_t kMaxInflightReads = 8;
+
+struct CacheHeader {
+    char magic[8];
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    double origin[3];
+    float cubeSize;
+    uint32_t depth;
+    uint32_t nodeCount;
+    uint32_t zUp;
+    uint64_t pointCount;
+    float bmin[3], bmax[3];
+};
+
+struct CacheNode {
+    uint32_t level, x, y, z, count, pad;
+    uint64_t offset;
+};
+
+const char kCacheMagic[8] = { 'M', 'V', 'P', 'C', 'O', 'C', 'T', '1' };
+
+// Decoder over the fixed-size records of a PLY vertex element or LAS point block
+struct PointSource {
+    const char* base = nullptr;
+    size_t stride = 0;
+    uint64_t count = 0;
+
+    enum class Pos { Float, Double, ScaledInt } posType = Pos::Float;
+    size_t posOffset[3] = { 0, 0, 0 };
+    double scale[3] = { 1, 1, 1 };
+    double offset[3] = { 0, 0, 0 };
+
+    enum class Color { None, U8, U16, Float } colorType = Color::None;
+    size_t colorOffset[3] = { 0, 0, 0 };
+
+    bool zUp = false;
+    bool hasBounds = false;
+    double bmin[3] = { 0, 0, 0 }, bmax[3] = { 0, 0, 0 };
+
+    void position(uint64_t i, double p[3]) const
+    {
+        const char* rec = base + i * stride;
+        for (int k = 0; k < 3; ++k)
+        {
+            const char* src = rec + posOffset[k];
+            switch (posType)
+            {
+                case Pos::Float:     { float f; std::memcpy(&f, src, 4); p[k] = f; break; }
+                case Pos::Double:    { double d; std::memcpy(&d, src, 8); p[k] = d; break; }
+                case Pos::ScaledInt: { int32_t v; std::memcpy(&v, src, 4); p[k] = v * scale[k] + offset[k]; break; }
+            }
+        }
+    }
+
+    void color(uint64_t i, uint8_t rgb[3]) const
+    {
+        const char* rec = base + i * stride;
+        for (int k = 0; k < 3; ++k)
+        {
+            const char* src = rec + colorOffset[k];
+            switch (colorType)
+            {
+                case Color::None:  rgb[k] = 200; break;
+                case Color::U8:    rgb[k] = (uint8_t)*src; break;
+                case Color::U16:   { uint16_t v; std::memcpy(&v, src, 2); rgb[k] = uint8_t(v >> 8); break; }
+                case Color::Float: { float f; std::memcpy(&f, src, 4); rgb[k] = uint8_t(std::clamp(f, 0.0f, 1.0f) * 255.0f + 0.5f); break; }
+            }
+        }
+    }
+};
+
+size_t plyTypeSize(const std::string& t)
+{
+    if (t == "char" || t == "uchar" || t == "int8" || t == "uint8") return 1;
+    if (t == "short" || t == "ushort" || t == "int16" || t == "uint16") return 2;
+    if (t == "int" || t == "uint" || t == "int32" || t == "uint32" || t == "float" || t == "float32") return 4;
+    if (t == "double" || t == "float64") return 8;
+    return 0;
+}
+
+bool parsePly(const MappedFile& file, PointSource& src, std::string& err)
+{
+    const char* data = file.Data();
+    const size_t size = file.Size();
+    const char* endTag = nullptr;
+    {
+        const std::string head(data, std::min<size_t>(size, 64 * 1024));
+        const size_t pos = head.find("end_header");
+        if (head.compare(0, 3, "ply") != 0 || pos == std::string::npos) { err = "Not a PLY file."; return false; }
+        const size_t nl = head.find('\n', pos);
+        if (nl == std::string::npos) { err = "Truncated PLY header."; return false; }
+        endTag = data + nl + 1;
+    }
+
+    std::istringstream header(std::string(data, endTag));
+    std::string line;
+    bool vertexSeen = false, inVertex = false;
+    size_t skipBefore = 0;      // bytes of fixed-size elements preceding "vertex"
+    size_t elemSize = 0;
+    uint64_t elemCount = 0;
+    int found = 0;
+    while (std::getline(header, line))
+    {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        std::istringstream ls(line);
+        std::string key; ls >> key;
+        if (key == "format")
+        {
+            std::string fmt; ls >> fmt;
+            if (fmt != "binary_little_endian") { err = "Only binary_little_endian PLY is supported."; return false; }
+        }
+        else if (key == "element")
+        {
+            if (!vertexSeen) skipBefore += elemSize * elemCount;
+            else if (inVertex) inVertex = false;
+            std::string name; ls >> name >> elemCount;
+            elemSize = 0;
+            if (name == "vertex" && !vertexSeen)
+            {
+                vertexSeen = inVertex = true;
+                src.count = elemCount;
+            }
+        }
+        else if (key == "property")
+        {
+            std::string type, name; ls >> type;
+            if (type == "list")
+            {
+                if (inVertex || !vertexSeen) { err = "PLY list properties before/inside vertex data are not supported."; return false; }
+                continue;
+            }
+            ls >> name;
+            const size_t ts = plyTypeSize(type);
+            if (ts == 0) { err = "Unknown PLY property type: " + type; return false; }
+            if (inVertex)
+            {
+                const int axis = (name == "x") ? 0 : (name == "y") ? 1 : (name == "z") ? 2 : -1;
+                if (axis >= 0)
+                {
+                    if (type != "float" && type != "float32" && type != "double" && type != "float64") { err = "PLY positions must be float or double."; return false; }
+                    src.posType = (ts == 8) ? PointSource::Pos::Double : PointSource::Pos::Float;
+                    src.posOffset[axis] = elemSize;
+                    found |= 1 << axis;
+                }
+                const int ch = (name == "red" || name == "diffuse_red") ? 0
+                             : (name == "green" || name == "diffuse_green") ? 1
+                             : (name == "blue" || name == "diffuse_blue") ? 2 : -1;
+                if (ch >= 0)
+                {
+                    src.colorType = (ts == 1) ? PointSource::Color::U8 : (ts == 2) ? PointSource::Color::U16 : PointSource::Color::Float;
+                    src.colorOffset[ch] = elemSize;
+                }
+            }
+            elemSize += ts;
+            if (inVertex) src.stride = elemSize;
+        }
+    }
+    if (!vertexSeen || found != 7) { err = "PLY has no x/y/z vertex positions."; return false; }
+
+    src.base = endTag + skipBefore;
+    if (src.base + src.stride * src.count > data + size) { err = "PLY vertex data is truncated."; return false; }
+    return true;
+}
+
+template <class T> T readLE(const char* p) { T v; std::memcpy(&v, p, sizeof(T)); return v; }
+
+bool parseLas(const MappedFile& file, PointSource& src, std::string& err)
+{
+    const char* d = file.Data();
+    const size_t size = file.Size();
+    if (size < 227 || std::memcmp(d, "LASF", 4) != 0) { err = "Not a LAS file."; return false; }
+
+    const uint8_t versionMinor = (uint8_t)d[25];
+    const uint16_t headerSize = readLE<uint16_t>(d + 94);
+    const uint32_t dataOffset = readLE<uint32_t>(d + 96);
+    const uint8_t format = (uint8_t)d[104];
+    const uint16_t recordLength = readLE<uint16_t>(d + 105);
+    uint64_t count = readLE<uint32_t>(d + 107);
+    if (versionMinor >= 4 && headerSize >= 255 && size >= 255)
+    {
+        const uint64_t count64 = readLE<uint64_t>(d + 247);
+        if (count64) count = count64;
+    }
+    if (format & 0xC0) { err = "Compressed LAZ is not supported; decompress to LAS first."; return false; }
+    // Every record starts with the three 32-bit coordinates
+    if (dataOffset > size || recordLength < 12) { err = "Invalid LAS header."; return false; }
+    if (count > (size - dataOffset) / recordLength) { err = "LAS point data is truncated."; return false; }
+
+    src.base = d + dataOffset;
+    src.stride = recordLength;
+    src.count = count;
+    src.posType = PointSource::Pos::ScaledInt;
+    src.posOffset[0] = 0; src.posOffset[1] = 4; src.posOffset[2] = 8;
+    for (int k = 0; k < 3; ++k)
+    {
+        src.scale[k] = readLE<double>(d + 131 + 8 * k);
+        src.offset[k] = readLE<double>(d + 155 + 8 * k);
+        src.bmax[k] = readLE<double>(d + 179 + 16 * k);
+        src.bmin[k] = readLE<double>(d + 187 + 16 * k);
+    }
+    src.hasBounds = true;
+    src.zUp = true;
+
+    size_t rgb = 0;
+    switch (format & 0x3F)
+    {
+        case 2: rgb = 20; break;
+        case 3: case 5: rgb = 28; break;
+        case 7: case 8: case 10: rgb = 30; break;
+        default: break;
+    }
+    if (rgb && rgb + 6 <= recordLength)
+    {
+        src.colorType = PointSource::Color::U16;
+        src.colorOffset[0] = rgb; src.colorOffset[1] = rgb + 2; src.colorOffset[2] = rgb + 4;
+    }
+    return true;
+}
+
+inline uint64_t nodeKey(uint32_t level, uint32_t x, uint32_t y, uint32_t z)
+{
+    return (uint64_t(level) << 60) | (uint64_t(x) << 40) | (uint64_t(y) << 20) | uint64_t(z);
+}
+
+inline uint32_t hash32(uint64_t v)
+{
+    v ^= v >> 33; v *= 0xff51afd7ed558ccdULL;
+    v ^= v >> 33; v *= 0xc4ceb9fe1a85ec53ULL;
+    v ^= v >> 33;
+    return uint32_t(v);
+}
+
+// Pick the level of point i so that level d receives ~4^d times as many points
+// as the root: scanned surfaces quadruple their node count per level, which
+// keeps the points per node roughly constant.
+inline uint32_t levelFor(uint64_t i, uint32_t depth, double total)
+{
+    const double x = (hash32(i) / 4294967296.0) * total;
+    uint32_t level = 0;
+    double edge = 3.0; // 4^(level+1) - 1
+    while (level < depth && x >= edge) { ++level; edge = edge * 4.0 + 3.0; }
+    return level;
+}
+
+int64_t fileTime(const std::string& path)
+{
+    std::error_code ec;
+    auto t = std::filesystem::last_write_time(path, ec);
+    return ec ? 0 : (int64_t)t.time_since_epoch().count();
+}
+
+bool frustumCullsBox(const glm::vec4 planes[6], const glm::vec3& mn, const glm::vec3& mx)
+{
+    for (int i = 0; i < 6; ++i)
+    {
+        const glm::vec4& p = planes[i];
+        const glm::vec3 v(p.x >= 0 ? mx.x : mn.x, p.y >= 0 ? mx.y : mn.y, p.z >= 0 ? mx.z : mn.z);
+        if (p.x * v.x + p.y * v.y + p.z * v.z + p.w < 0.0f) return true;
+    }
+    return false;
+}
+
+// FNV-1a
+uint64_t hashPath(const std::string& s)
+{
+    uint64_t h = 1469598103934665603ull;
+    for (unsigned char c : s) { h ^= c; h *= 1099511628211ull; }
+    return h;
+}
+
+// Where the octree cache may live, in order of preference: next to the source, then
+// the per-user cache directory and the temp directory, keyed by the source path
+std::vector<std::string> cacheCandidates(const std::string& source)
+{
+    std::vector<std::string> paths{ source + ".octree" };
+
+    std::error_code ec;
+    const std::filesystem::path absolute = std::filesystem::absolute(source, ec);
+    char name[48];
+    std::snprintf(name, sizeof(name), "%016" PRIx64 ".octree", hashPath(ec ? source : absolute.string()));
+
+#ifdef _WIN32
+    const char* userCache = std::getenv("LOCALAPPDATA");
+#else
+    const char* userCache = std::getenv("XDG_CACHE_HOME");
+    std::string home;
+    if ((!userCache || !*userCache) && std::getenv("HOME"))
+    {
+        home = std::string(std::getenv("HOME")) + "/.cache";
+        userCache = home.c_str();
+    }
+#endif
+    if (userCache && *userCache)
+        paths.push_back((std::filesystem::path(userCache) / "modelviewer" / "pointcloud" / name).string());
+
+    const std::filesystem::path temp = std::filesystem::temp_directory_path(ec);
+    if (!ec) paths.push_back((temp / "modelviewer" / name).string());
+    return paths;
+}
+
+} // namespace
+
+PointCloud::~PointCloud()
+{
+    shutdown();
+}
+
+void PointCloud::shutdown()
+{
+    for (auto& f : inflight_) f.wait();
+    inflight_.clear();
+    ready_.clear();
+    for (auto& n : nodes_)
+    {
+        if (n.vbo) glDeleteBuffers(1, &n.vbo);
+        if (n.vao) glDeleteVertexArrays(1, &n.vao);
+    }
+    nodes_.clear();
+    root_ = -1;
+    points_ = nullptr;
+    cache_.Close();
+    std::vector<char>().swap(memory_);
+    totalPoints_ = pointsDrawn_ = 0;
+    residentCount_ = 0;
+    residentPoints_ = 0;
+}
+
+bool PointCloud::load(const std::string& path)
+{
+    shutdown();
+    err_.clear();
+
+    std::error_code ec;
+    const uint64_t sourceSize = (uint64_t)std::filesystem::file_size(path, ec);
+    if (ec) { err_ = "Failed to open point cloud: " + path; return false; }
+    const int64_t sourceTime = fileTime(path);
+
+    const std::vector<std::string> cachePaths = cacheCandidates(path);
+    for (const std::string& cachePath : cachePaths)
+        if (openCache(cachePath, sourceSize, sourceTime)) return true;
+
+    err_.clear();
+    const auto t0 = std::chrono::steady_clock::now();
+    std::string cachePath;
+    if (!buildCache(path, cachePaths, cachePath)) return false;
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    printf("Built point cloud octree for %s in %.2f s\n", path.c_str(), secs);
+
+    if (cachePath.empty())
+    {
+        // Nowhere writable: stream from the in-memory build for this session
+        printf("No writable octree cache location for %s; keeping it in memory\n", path.c_str());
+        if (!attach(memory_.data(), memory_.size(), sourceSize, sourceTime))
+        {
+            if (err_.empty()) err_ = "Failed to build octree for: " + path;
+            return false;
+        }
+        return true;
+    }
+    if (!openCache(cachePath, sourceSize, sourceTime))
+    {
+        if (err_.empty()) err_ = "Failed to open octree cache: " + cachePath;
+        return false;
+    }
+    return true;
+}
+
+bool PointCloud::buildCache(const std::string& source, const std::vector<std::string>& cachePaths, std::string& cachePath)
+{
+    cachePath.clear();
+    MappedFile file;
+    if (!file.Open(source)) { err_ = "Failed to open point cloud: " + source; return false; }
+
+    PointSource src;
+    std::string ext = std::filesystem::path(source).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return char(std::tolower(c)); });
+    const bool ok = (ext == ".las") ? parseLas(file, src, err_) : parsePly(file, src, err_);
+    if (!ok) return false;
+    if (src.count == 0) { err_ = "Point cloud is empty."; return false; }
+
+    ThreadPool& pool = ThreadPool::Get();
+    std::mutex mergeMutex;
+
+    // Bounds (LAS carries them in the header)
+    if (!src.hasBounds)
+    {
+        for (int k = 0; k < 3; ++k) { src.bmin[k] = std::numeric_limits<double>::max(); src.bmax[k] = std::numeric_limits<double>::lowest(); }
+        pool.ParallelFor(src.count, kMinChunkPoints, [&](size_t b, size_t e) {
+            double mn[3], mx[3], p[3];
+            for (int k = 0; k < 3; ++k) { mn[k] = std::numeric_limits<double>::max(); mx[k] = std::numeric_limits<double>::lowest(); }
+            for (size_t i = b; i < e; ++i)
+            {
+                src.position(i, p);
+                for (int k = 0; k < 3; ++k) { mn[k] = std::min(mn[k], p[k]); mx[k] = std::max(mx[k], p[k]); }
+            }
+            std::lock_guard<std::mutex> lock(mergeMutex);
+            for (int k = 0; k < 3; ++k) { src.bmin[k] = std::min(src.bmin[k], mn[k]); src.bmax[k] = std::max(src.bmax[k], mx[k]); }
+        });
+    }
+
+    double cube = std::max(src.bmax[0] - src.bmin[0], std::max(src.bmax[1] - src.bmin[1], src.bmax[2] - src.bmin[2]));
+    if (!(cube > 0.0)) cube = 1.0;
+    cube *= 1.0001; // keep max-coordinate points inside the last cell
+
+    uint32_t depth = 0;
+    for (uint64_t n = kTargetPointsPerNode; n < src.count && depth < kMaxDepth; n *= 4) ++depth;
+    const double levelTotal = (std::pow(4.0, double(depth + 1)) - 1.0);
+
+    auto cellOf = [&](const double p[3], uint32_t level, uint32_t c[3]) {
+        const double cells = double(1u << level);
+        for (int k = 0; k < 3; ++k)
+        {
+            const double t = (p[k] - src.bmin[k]) / cube * cells;
+            c[k] = (uint32_t)std::clamp(t, 0.0, cells - 1.0);
+        }
+    };
+
+    // Pass 1: points per node
+    std::unordered_map<uint64_t, uint64_t> counts;
+    pool.ParallelFor(src.count, kMinChunkPoints, [&](size_t b, size_t e) {
+        std::unordered_map<uint64_t, uint64_t> local;
+        double p[3]; uint32_t c[3];
+        for (size_t i = b; i < e; ++i)
+        {
+            src.position(i, p);
+            const uint32_t level = levelFor(i, depth, levelTotal);
+            cellOf(p, level, c);
+            ++local[nodeKey(level, c[0], c[1], c[2])];
+        }
+        std::lock_guard<std::mutex> lock(mergeMutex);
+        for (const auto& kv : local) counts[kv.first] += kv.second;
+    });
+
+    // Every node needs its ancestors so traversal can reach it from the root
+    std::vector<uint64_t> keys;
+    keys.reserve(counts.size());
+    for (const auto& kv : counts) keys.push_back(kv.first);
+    for (uint64_t key : keys)
+    {
+        uint32_t level = uint32_t(key >> 60);
+        uint32_t x = uint32_t(key >> 40) & 0xFFFFF, y = uint32_t(key >> 20) & 0xFFFFF, z = uint32_t(key) & 0xFFFFF;
+        while (level > 0)
+        {
+            --level; x >>= 1; y >>= 1; z >>= 1;
+            if (!counts.emplace(nodeKey(level, x, y, z), 0).second) break;
+        }
+    }
+    keys.clear();
+    for (const auto& kv : counts) keys.push_back(kv.first);
+    std::sort(keys.begin(), keys.end());
+
+    std::unordered_map<uint64_t, uint32_t> indexOf;
+    indexOf.reserve(keys.size());
+    std::vector<CacheNode> table(keys.size());
+    uint64_t running = 0;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        const uint64_t key = keys[i];
+        CacheNode& n = table[i];
+        n.level = uint32_t(key >> 60);
+        n.x = uint32_t(key >> 40) & 0xFFFFF; n.y = uint32_t(key >> 20) & 0xFFFFF; n.z = uint32_t(key) & 0xFFFFF;
+        n.count = (uint32_t)counts[key];
+        n.pad = 0;
+        n.offset = running;
+        running += n.count;
+        indexOf[key] = (uint32_t)i;
+    }
+
+    const size_t headerBytes = sizeof(CacheHeader) + table.size() * sizeof(CacheNode);
+    const size_t payloadBytes = size_t(src.count) * sizeof(PointRecord);
+    // First writable location wins; otherwise build into memory
+    MappedFile out;
+    std::string tmpPath;
+    for (const std::string& candidate : cachePaths)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(std::filesystem::path(candidate).parent_path(), ec);
+        tmpPath = candidate + ".tmp";
+        if (out.Create(tmpPath, headerBytes + payloadBytes)) { cachePath = candidate; break; }
+    }
+    if (cachePath.empty()) memory_.resize(headerBytes + payloadBytes);
+    char* base = cachePath.empty() ? memory_.data() : out.MutableData();
+
+    // Pass 2: scatter points into their node's range of the output
+    PointRecord* payload = reinterpret_cast<PointRecord*>(base + headerBytes);
+    std::vector<std::atomic<uint64_t>> cursor(table.size());
+    for (size_t i = 0; i < table.size(); ++i) cursor[i].store(table[i].offset);
+    pool.ParallelFor(src.count, kMinChunkPoints, [&](size_t b, size_t e) {
+        double p[3]; uint32_t c[3]; uint8_t rgb[3];
+        for (size_t i = b; i < e; ++i)
+        {
+            src.position(i, p);
+            src.color(i, rgb);
+            const uint32_t level = levelFor(i, depth, levelTotal);
+            cellOf(p, level, c);
+            const uint32_t node = indexOf.find(nodeKey(level, c[0], c[1], c[2]))->second;
+            PointRecord& r = payload[cursor[node].fetch_add(1, std::memory_order_relaxed)];
+            r.x = float(p[0] - src.bmin[0]);
+            r.y = float(p[1] - src.bmin[1]);
+            r.z = float(p[2] - src.bmin[2]);
+            r.r = rgb[0]; r.g = rgb[1]; r.b = rgb[2]; r.a = 255;
+        }
+    });
+
+    CacheHeader h{};
+    std::memcpy(h.magic, kCacheMagic, sizeof(h.magic));
+    h.sourceSize = (uint64_t)std::filesystem::file_size(source);
+    h.sourceTime = fileTime(source);
+    for (int k = 0; k < 3; ++k)
+    {
+        h.origin[k] = src.bmin[k];
+        h.bmin[k] = 0.0f;
+        h.bmax[k] = float(src.bmax[k] - src.bmin[k]);
+    }
+    h.cubeSize = float(cube);
+    h.depth = depth;
+    h.nodeCount = (uint32_t)table.size();
+    h.zUp = src.zUp ? 1u : 0u;
+    h.pointCount = src.count;
+    std::memcpy(base, &h, sizeof(h));
+    std::memcpy(base + sizeof(h), table.data(), table.size() * sizeof(CacheNode));
+    if (cachePath.empty()) return true;
+    out.Close();
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, cachePath, ec);
+    if (ec) { err_ = "Failed to write octree cache: " + cachePath; return false; }
+    return true;
+}
+
+bool PointCloud::openCache(const std::string& cachePath, uint64_t sourceSize, int64_t sourceTime)
+{
+    std::error_code ec;
+    if (!std::filesystem::exists(cachePath, ec)) return false;
+    if (!cache_.Open(cachePath)) return false;
+    if (!attach(cache_.Data(), cache_.Size(), sourceSize, sourceTime))
+    {
+        cache_.Close();
+        return false;
+    }
+    return true;
+}
+
+bool PointCloud::attach(const char* data, size_t size, uint64_t sourceSize, int64_t sourceTime)
+{
+    if (size < sizeof(CacheHeader)) return false;
+    CacheHeader h;
+    std::memcpy(&h, data, sizeof(h));
+    const size_t headerBytes = sizeof(CacheHeader) + size_t(h.nodeCount) * sizeof(CacheNode);
+    if (std::memcmp(h.magic, kCacheMagic, sizeof(h.magic)) != 0 || h.sourceSize != sourceSize || h.sourceTime != sourceTime ||
+        size != headerBytes + size_t(h.pointCount) * sizeof(PointRecord))
+        return false; // stale or foreign; caller rebuilds
+
+    const CacheNode* table = reinterpret_cast<const CacheNode*>(data + sizeof(CacheHeader));
+    points_ = reinterpret_cast<const PointRecord*>(data + headerBytes);
+    nodes_.resize(h.nodeCount);
+    std::unordered_map<uint64_t, int> indexOf;
+    indexOf.reserve(h.nodeCount);
+    for (uint32_t i = 0; i < h.nodeCount; ++i)
+    {
+        Node& n = nodes_[i];
+        n.level = table[i].level; n.x = table[i].x; n.y = table[i].y; n.z = table[i].z;
+        n.count = table[i].count;
+        n.offset = table[i].offset;
+        indexOf[nodeKey(n.level, n.x, n.y, n.z)] = (int)i;
+    }
+    for (uint32_t i = 0; i < h.nodeCount; ++i)
+    {
+        const Node& n = nodes_[i];
+        if (n.level == 0) { root_ = (int)i; continue; }
+        auto it = indexOf.find(nodeKey(n.level - 1, n.x >> 1, n.y >> 1, n.z >> 1));
+        if (it == indexOf.end()) continue;
+        const int child = int((n.x & 1) | ((n.y & 1) << 1) | ((n.z & 1) << 2));
+        nodes_[it->second].children[child] = (int)i;
+    }
+    if (root_ < 0) { err_ = "Octree cache has no root node."; points_ = nullptr; nodes_.clear(); return false; }
+
+    cubeSize_ = h.cubeSize;
+    bmin_ = glm::vec3(h.bmin[0], h.bmin[1], h.bmin[2]);
+    bmax_ = glm::vec3(h.bmax[0], h.bmax[1], h.bmax[2]);
+    zUp_ = h.zUp != 0;
+    totalPoints_ = h.pointCount;
+    return true;
+}
+
+void PointCloud::requestNode(int index)
+{
+    Node& n = nodes_[index];
+    if (n.requested || n.count == 0) return;
+
+    inflight_.erase(std::remove_if(inflight_.begin(), inflight_.end(), [](std::future<void>& f) {
+        return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }), inflight_.end());
+    if (inflight_.size() >= kMaxInflightReads) return;
+
+    n.requested = true;
+    const PointRecord* src = points_ + n.offset;
+    const uint32_t count = n.count;
+    // Copying on a worker faults the pages in off the render thread
+    inflight_.push_back(ThreadPool::Get().Submit([this, index, src, count]() {
+        LoadedNode loaded{ index, std::vector<PointRecord>(src, src + count) };
+        std::lock_guard<std::mutex> lock(readyMutex_);
+        ready_.push_back(std::move(loaded));
+    }));
+}
+
+void PointCloud::uploadReady()
+{
+    uint64_t uploaded = 0;
+    while (uploaded < kUploadPointsPerFrame)
+    {
+        LoadedNode loaded;
+        {
+            std::lock_guard<std::mutex> lock(readyMutex_);
+            if (ready_.empty()) break;
+            loaded = std::move(ready_.front());
+            ready_.pop_front();
+        }
+        Node& n = nodes_[loaded.node];
+        glGenVertexArrays(1, &n.vao);
+        glGenBuffers(1, &n.vbo);
+        glBindVertexArray(n.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, n.vbo);
+        glBufferData(GL_ARRAY_BUFFER, loaded.points.size() * sizeof(PointRecord), loaded.points.data(), GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(PointRecord), (void*)offsetof(PointRecord, x));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PointRecord), (void*)offsetof(PointRecord, r));
+        glBindVertexArray(0);
+        ++residentCount_;
+        residentPoints_ += n.count;
+        uploaded += n.count;
+    }
+}
+
+void PointCloud::evict(uint64_t keepFrame)
+{
+    // Keep up to a few budgets' worth resident so orbiting back is free
+    const uint64_t limit = pointBudget_ * 4;
+    if (residentPoints_ <= limit) return;
+
+    std::vector<int> candidates;
+    for (int i = 0; i < (int)nodes_.size(); ++i)
+    {
+        if (nodes_[i].vao && nodes_[i].lastUsedFrame < keepFrame) candidates.push_back(i);
+    }
+    std::sort(candidates.begin(), candidates.end(), [&](int a, int b) { return nodes_[a].lastUsedFrame < nodes_[b].lastUsedFrame; });
+    for (int i : candidates)
+    {
+        if (residentPoints_ <= limit) break;
+        Node& n = nodes_[i];
+        glDeleteBuffers(1, &n.vbo);
+        glDeleteVertexArrays(1, &n.vao);
+        n.vbo = n.vao = 0;
+        n.requested = false;
+        --residentCount_;
+        residentPoints_ -= n.count;
+    }
+}
+
+void PointCloud::render(const Camera& cam, const glm::mat4& model, Shader& shader, int viewportHeight)
+{
+    if (root_ < 0) return;
+    uploadReady();
+    ++frame_;
+
+    // Frustum planes in model space (Gribb/Hartmann), so node boxes test directly
+    const glm::mat4 mvp = cam.proj() * cam.view() * model;
+    glm::vec4 planes[6];
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int k = 0; k < 4; ++k)
+        {
+            planes[i * 2 + 0][k] = mvp[k][3] + mvp[k][i];
+            planes[i * 2 + 1][k] = mvp[k][3] - mvp[k][i];
+        }
+    }
+    const glm::mat4 invMV = glm::inverse(cam.view() * model);
+    const glm::vec3 eye = glm::vec3(invMV * glm::vec4(0, 0, 0, 1));
+    const float modelScale = glm::length(glm::vec3(model[0]));
+    const float pixelScale = cam.proj()[1][1] * 0.5f * float(viewportHeight);
+
+    // Largest-on-screen first until the point budget is spent
+    std::priority_queue<std::pair<float, int>> open;
+    open.push({ std::numeric_limits<float>::max(), root_ });
+    std::vector<int> visible;
+    uint64_t budgetUsed = 0;
+    while (!open.empty())
+    {
+        const int index = open.top().second;
+        open.pop();
+        Node& n = nodes_[index];
+        const float size = cubeSize_ / float(1u << n.level);
+        const glm::vec3 mn = glm::vec3(float(n.x), float(n.y), float(n.z)) * size;
+        const glm::vec3 mx = mn + glm::vec3(size);
+        if (frustumCullsBox(planes, mn, mx)) continue;
+
+        const glm::vec3 center = (mn + mx) * 0.5f;
+        const float dist = std::max(glm::length(center - eye) - size * 0.866f, 1e-3f);
+        const float screen = size / dist * pixelScale;
+        if (n.level > 0 && screen < kMinNodePixels) continue;
+        if (budgetUsed + n.count > pointBudget_) break;
+
+        budgetUsed += n.count;
+        visible.push_back(index);
+        for (int c : n.children)
+        {
+            if (c >= 0) open.push({ screen, c });
+        }
+    }
+
+    shader.use();
+    glUniformMatrix4fv(shader.loc("uModel"), 1, GL_FALSE, glm::value_ptr(model));
+    glUniformMatrix4fv(shader.loc("uView"), 1, GL_FALSE, glm::value_ptr(cam.view()));
+    glUniformMatrix4fv(shader.loc("uProj"), 1, GL_FALSE, glm::value_ptr(cam.proj()));
+    glUniform1f(shader.loc("uPointScale"), pixelScale);
+    const GLint spacingLoc = shader.loc("uSpacing");
+    glEnable(GL_PROGRAM_POINT_SIZE);
+
+    pointsDrawn_ = 0;
+    missingNodes_ = 0;
+    for (int index : visible)
+    {
+        Node& n = nodes_[index];
+        n.lastUsedFrame = frame_;
+        if (!n.vao) { requestNode(index); ++missingNodes_; continue; }
+        // Approximate spacing of this node's sample on a surface through its cell
+        const float size = cubeSize_ / float(1u << n.level);
+        glUniform1f(spacingLoc, modelScale * size / std::sqrt(float(std::max<uint32_t>(n.count, 1u))));
+        glBindVertexArray(n.vao);
+        glDrawArrays(GL_POINTS, 0, (GLsizei)n.count);
+        pointsDrawn_ += n.count;
+    }
+    glBindVertexArray(0);
+    glDisable(GL_PROGRAM_POINT_SIZE);
+
+    evict(frame_);
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include "core/MappedFile.hpp"
+#include "gfx/Shader.hpp"
+#include "core/Camera.hpp"
+
+using GLuint = unsigned int;
+
+// Out-of-core point cloud (binary PLY or uncompressed LAS).
+//
+// On first load the source is converted into an octree cache file next to it
+// ("<file>.octree"), falling back to the user cache or temp directory when that
+// is not writable and to an in-memory octree when nothing is. Every point is
+// assigned to exactly one node: deeper levels receive exponentially more points,
+// so each node holds a roughly uniform random subset of its cell and a node plus
+// its ancestors form a progressively denser sample. At render time the octree is
+// traversed largest-on-screen first and nodes are drawn until a fixed point
+// budget is spent; missing nodes are read from the cache on worker threads and
+// uploaded a few per frame.
+class PointCloud {
+public:
+    PointCloud() = default;
+    ~PointCloud();
+
+    bool load(const std::string& path);
+    void shutdown();
+
+    // Draw with the point shader; viewportHeight drives the screen-space LOD
+    void render(const Camera& cam, const glm::mat4& model, Shader& shader, int viewportHeight);
+
+    void getBounds(glm::vec3& minOut, glm::vec3& maxOut) const { minOut = bmin_; maxOut = bmax_; }
+    bool isZUp() const { return zUp_; }
+
+    void setPointBudget(uint64_t points) { pointBudget_ = points; }
+    uint64_t pointBudget() const { return pointBudget_; }
+
+    uint64_t totalPoints() const { return totalPoints_; }
+    uint64_t pointsDrawn() const { return pointsDrawn_; }
+    size_t residentNodes() const { return residentCount_; }
+    // Nodes selected by the last render that are still being read or uploaded
+    bool streaming() const { return missingNodes_ > 0; }
+
+    const std::string& lastError() const { return err_; }
+
+private:
+    struct PointRecord { float x, y, z; uint8_t r, g, b, a; };
+
+    struct Node {
+        uint32_t level = 0;
+        uint32_t x = 0, y = 0, z = 0;
+        uint64_t offset = 0;             // in points, into the cache payload
+        uint32_t count = 0;
+        int children[8] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+
+        GLuint vao = 0, vbo = 0;         // resident GPU copy
+        bool requested = false;
+        uint64_t lastUsedFrame = 0;
+    };
+
+    struct LoadedNode { int node; std::vector<PointRecord> points; };
+
+    // Writes the octree to the first writable candidate and returns its path in cachePath;
+    // if none is writable, cachePath is left empty and the octree is built into memory_
+    bool buildCache(const std::string& source, const std::vector<std::string>& cachePaths, std::string& cachePath);
+    bool openCache(const std::string& cachePath, uint64_t sourceSize, int64_t sourceTime);
+    // Point the node table and payload at a cache image (mapped file or memory_)
+    bool attach(const char* data, size_t size, uint64_t sourceSize, int64_t sourceTime);
+
+    void requestNode(int index);
+    void uploadReady();
+    void evict(uint64_t keepFrame);
+
+    std::string err_;
+    MappedFile cache_;
+    std::vector<char> memory_;     // octree image when no cache file could be written
+    const PointRecord* points_ = nullptr;
+    std::vector<Node> nodes_;
+    int root_ = -1;
+
+    glm::vec3 bmin_{0}, bmax_{0};  // cloud bounds, relative to the cube origin
+    float cubeSize_ = 1.0f;
+    bool zUp_ = false;
+
+    uint64_t totalPoints_ = 0;
+    uint64_t pointBudget_ = 3000000;
+    uint64_t pointsDrawn_ = 0;
+    uint64_t frame_ = 0;
+    size_t residentCount_ = 0;
+    size_t missingNodes_ = 0;
+    uint64_t residentPoints_ = 0;
+
+    // Background reads of node payloads; the render thread only uploads
+    std::mutex readyMutex_;
+    std::deque<LoadedNode> ready_;
+    std::vector<std::future<void>> inflight_;
+};
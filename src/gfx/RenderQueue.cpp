@@ -0,0 +1,172 @@
+#include "gfx/RenderQueue.hpp"
+#include "gfx/WeightedOit.hpp"
+#include "gfx/DynamicResolution.hpp"
+#include "core/RadixSort.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+// 24 bits of an order-preserving float encoding: sign, exponent and 15 mantissa bits
+uint32_t quantizeDepth(float depth)
+{
+    return FloatToSortableBits(std::max(depth, 0.0f)) >> 8;
+}
+
+} // namespace
+
+uint64_t RenderQueue::MakeKey(Pass pass, uint32_t program, uint32_t material, float depth)
+{
+    const uint64_t p = uint64_t(pass) & 0xF;
+    const uint64_t prog = program & 0x3FF;
+    const uint64_t mat = material & 0xFFFF;
+    const uint64_t d = quantizeDepth(depth);
+    if (pass == Pass::Transparent)
+        return (p << 60) | ((0xFFFFFFull - d) << 36) | (prog << 26) | (mat << 10);
+    return (p << 60) | (prog << 50) | (mat << 34) | (d << 10);
+}
+
+RenderQueue::~RenderQueue()
+{
+    shutdown();
+}
+
+void RenderQueue::shutdown()
+{
+    if (timers_[0]) glDeleteQueries(kTimers, timers_);
+    for (unsigned int& t : timers_) t = 0;
+}
+
+void RenderQueue::clear()
+{
+    keys_.clear();
+    packets_.clear();
+}
+
+void RenderQueue::submit(uint64_t key, const Submitter* submitter, uint32_t item)
+{
+    keys_.push_back(key);
+    packets_.push_back(Packet{submitter, item});
+}
+
+void RenderQueue::execute()
+{
+    using clock = std::chrono::steady_clock;
+    const auto t0 = clock::now();
+    const size_t n = keys_.size();
+    order_.resize(n);
+    for (size_t i = 0; i < n; ++i) order_[i] = (uint32_t)i;
+    tmpKeys_.resize(n);
+    tmpOrder_.resize(n);
+    // A frame's packets fit in one block, so the sort stays on this thread
+    RadixSortPairs(keys_.data(), order_.data(), tmpKeys_.data(), tmpOrder_.data(), n, nullptr);
+    const auto t1 = clock::now();
+
+    // The timer issued kTimers frames ago is normally done by now; never wait for it
+    if (!timers_[0]) glGenQueries(kTimers, timers_);
+    const GLuint timer = timers_[timerFrame_ % kTimers];
+    if (timerFrame_ >= kTimers)
+    {
+        GLuint available = 0;
+        glGetQueryObjectuiv(timer, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available)
+        {
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(timer, GL_QUERY_RESULT, &ns);
+            gpuMs_ = ns / 1e6;
+        }
+    }
+    glBeginQuery(GL_TIME_ELAPSED, timer);
+
+    const GLboolean cullWasOn = glIsEnabled(GL_CULL_FACE);
+    const Submitter* bound = nullptr;
+    int pass = -1;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Packet& p = packets_[order_[i]];
+        const int packetPass = int(keys_[i] >> 60);
+        if (packetPass != pass)
+        {
+            if (pass >= 0) endPass(Pass(pass), cullWasOn);
+            pass = packetPass;
+            beginPass(Pass(pass));
+            bound = nullptr;
+        }
+        if (p.submitter != bound)
+        {
+            p.submitter->bind(Pass(pass));
+            bound = p.submitter;
+        }
+        p.submitter->draw(p.item);
+    }
+
+    // Leave the defaults every pass starts from
+    if (pass >= 0) endPass(Pass(pass), cullWasOn);
+    if (cullWasOn) glEnable(GL_CULL_FACE);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDepthMask(GL_TRUE);
+    glDepthFunc(GL_LESS);
+    glDisable(GL_BLEND);
+    glBindVertexArray(0);
+    if (target_) target_->present(); // no-op if the overlay pass already did
+    glEndQuery(GL_TIME_ELAPSED);
+    ++timerFrame_;
+
+    sortMs_ = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    executeMs_ = std::chrono::duration<double, std::milli>(clock::now() - t1).count();
+}
+
+void RenderQueue::beginPass(Pass pass)
+{
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDepthFunc(GL_LESS);
+    switch (pass)
+    {
+    case Pass::DepthPrepass:
+        glDisable(GL_BLEND);
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glDepthMask(GL_TRUE);
+        break;
+    case Pass::OpaqueEqual:
+        glDisable(GL_BLEND);
+        glDepthMask(GL_FALSE);
+        glDepthFunc(GL_EQUAL);
+        break;
+    case Pass::Background:
+        glDisable(GL_BLEND);
+        glDepthMask(GL_FALSE);
+        break;
+    case Pass::Opaque:
+    case Pass::OpaqueConditional:
+        glDisable(GL_BLEND);
+        glDepthMask(GL_TRUE);
+        break;
+    case Pass::OcclusionTest:
+        glDisable(GL_BLEND);
+        glDisable(GL_CULL_FACE);
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glDepthMask(GL_FALSE);
+        glDepthFunc(GL_LEQUAL);
+        break;
+    case Pass::TransparentOit:
+        if (oit_) oit_->begin();
+        break;
+    case Pass::Transparent:
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glDepthMask(GL_FALSE);
+        break;
+    case Pass::Overlay:
+        if (target_) target_->present();
+        break;
+    }
+}
+
+void RenderQueue::endPass(Pass pass, bool cullWasOn)
+{
+    if (pass == Pass::OcclusionTest && cullWasOn) glEnable(GL_CULL_FACE);
+    if (pass == Pass::TransparentOit && oit_) oit_->composite();
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class WeightedOit;
+class DynamicResolution;
+
+// Per-frame list of draw packets, sorted by a 64-bit key and then executed.
+//
+// Scenes submit (key, submitter, item) packets instead of drawing directly. The key
+// orders packets by pass first; opaque-style passes then group by program and material
+// and go front to back inside a state bucket (early-Z), the transparent pass goes back
+// to front. Keys are sorted with the LSD radix sort; all-equal digits are skipped, so
+// the unused low bits cost nothing.
+//
+//   opaque-style:  [63:60] pass  [59:50] program  [49:34] material  [33:10] depth
+//   transparent:   [63:60] pass  [59:36] far-to-near depth  [35:26] program  [25:10] material
+//
+// With order-independent transparency set, submitters put blended geometry in the
+// TransparentOit pass instead, which needs no depth order. With a scaled scene target
+// set, everything before the Overlay pass renders into it and is upscaled to the window
+// before the overlay draws.
+class RenderQueue {
+public:
+    // Execution order. The queue owns the GL state that defines each pass.
+    enum class Pass : uint8_t {
+        DepthPrepass = 0,      // depth writes only, color masked
+        Background = 1,        // depth test, no depth writes (grid)
+        Opaque = 2,            // depth test and writes, no blending
+        OpaqueEqual = 3,       // shading after the prepass: GL_EQUAL, no depth writes
+        OcclusionTest = 4,     // query boxes: color and depth writes off, no face culling
+        OpaqueConditional = 5, // like Opaque; draws gated on this frame's occlusion queries
+        TransparentOit = 6,    // weighted blended OIT targets, resolved when the pass ends
+        Transparent = 7,       // alpha blending, no depth writes
+        Overlay = 8,           // screen-space UI at window resolution; submitters manage their own state
+    };
+
+    // Something that draws packets back. bind() runs whenever execution switches to this
+    // submitter or to a new pass, draw() once per packet.
+    class Submitter {
+    public:
+        virtual ~Submitter() = default;
+        virtual void bind(Pass) const {}
+        virtual void draw(uint32_t item) const = 0;
+    };
+
+    // depth is view-space distance; program is a GL program id and material any small id
+    static uint64_t MakeKey(Pass pass, uint32_t program, uint32_t material, float depth);
+
+    // Order-independent transparency for this queue; null sorts blended draws instead
+    void setOit(WeightedOit* oit) { oit_ = oit; }
+    bool oit() const { return oit_ != nullptr; }
+    // Scaled scene target, bound by the caller before execute(); presented before the overlay
+    void setSceneTarget(DynamicResolution* target) { target_ = target; }
+
+    void clear();
+    void submit(uint64_t key, const Submitter* submitter, uint32_t item);
+
+    // Sort by key (stable for equal keys) and draw every packet
+    void execute();
+
+    size_t size() const { return packets_.size(); }
+    double lastSortMs() const { return sortMs_; }
+    double lastExecuteMs() const { return executeMs_; }
+    // GPU time of execute(), from a timer query read kTimers frames later (0 until then)
+    double lastGpuMs() const { return gpuMs_; }
+
+    RenderQueue() = default;
+    ~RenderQueue();
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+    void shutdown();
+
+private:
+    struct Packet {
+        const Submitter* submitter;
+        uint32_t item;
+    };
+    std::vector<uint64_t> keys_, tmpKeys_;
+    std::vector<uint32_t> order_, tmpOrder_;
+    std::vector<Packet> packets_;
+    double sortMs_ = 0.0, executeMs_ = 0.0;
+    static constexpr int kTimers = 4;
+    unsigned int timers_[kTimers] = {};
+    int timerFrame_ = 0;
+    double gpuMs_ = 0.0;
+    WeightedOit* oit_ = nullptr;
+    DynamicResolution* target_ = nullptr;
+
+    void beginPass(Pass pass);
+    void endPass(Pass pass, bool cullWasOn);
+};
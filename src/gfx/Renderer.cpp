@@ -1,13 +1,15 @@
 #include "gfx/Renderer.hpp"
+#include "gfx/GLExt.hpp"
 
 void Renderer::Init() 
 {
+    GLExt::Init();
     glEnable(GL_DEPTH_TEST);
     // Depth clamp can produce artifacts; keep it off for better depth behavior
     glDisable(GL_DEPTH_CLAMP);
     glDepthFunc(GL_LESS);
     glClearDepth(1.0);              // default, but be explicit
-    // Enable multisampling (MSAA must be requested at window creation)
+    // Multisampled rasterization into the scene target (see DynamicResolution)
     glEnable(GL_MULTISAMPLE);
 }
 
@@ -17,11 +19,6 @@ void Renderer::Clear(float r, float g, float b, float a)
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
-void Renderer::SetWireframe(bool on) 
-{
-    glPolygonMode(GL_FRONT_AND_BACK, on ? GL_LINE : GL_FILL);
-}
-
 void Renderer::SetCull(bool on) 
 {
     if (on) 
@@ -35,9 +32,3 @@ void Renderer::SetCull(bool on)
         glDisable(GL_CULL_FACE);
     }    
 }
-
-void Renderer::SetMSAA(bool on)
-{
-    if (on) glEnable(GL_MULTISAMPLE);
-    else     glDisable(GL_MULTISAMPLE);
-}
@@ -6,7 +6,5 @@ class Renderer {
 public:
     static void Init();
     static void Clear(float r, float g, float b, float a);
-    static void SetWireframe(bool on);
     static void SetCull(bool on);
-    static void SetMSAA(bool on);
 };
@@ -0,0 +1,67 @@
+#include "gfx/SceneGraph.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+
+int SceneGraph::addNode(int parent, const glm::vec3& t, const glm::quat& r, const glm::vec3& s)
+{
+    const int index = (int)parent_.size();
+    parent_.push_back(parent);
+    translation_.push_back(t);
+    rotation_.push_back(r);
+    scale_.push_back(s);
+    hasTRS_.push_back(1);
+    local_.emplace_back(1.0f);
+    world_.emplace_back(1.0f);
+    dirty_.push_back(1);
+    changed_.push_back(0);
+    anyDirty_ = true;
+    return index;
+}
+
+int SceneGraph::addNode(int parent, const glm::mat4& local)
+{
+    const int index = addNode(parent, glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f));
+    hasTRS_[index] = 0;
+    local_[index] = local;
+    return index;
+}
+
+void SceneGraph::clear()
+{
+    parent_.clear();
+    translation_.clear(); scale_.clear(); rotation_.clear();
+    hasTRS_.clear();
+    local_.clear(); world_.clear();
+    dirty_.clear(); changed_.clear();
+    anyDirty_ = false;
+}
+
+bool SceneGraph::updateWorld()
+{
+    const size_t n = parent_.size();
+    if (!anyDirty_)
+    {
+        std::fill(changed_.begin(), changed_.end(), uint8_t(0));
+        return false;
+    }
+
+    // Parents precede children, so a parent's changed flag is final when its children are visited
+    for (size_t i = 0; i < n; ++i)
+    {
+        const int p = parent_[i];
+        const bool parentMoved = p >= 0 && changed_[p];
+        if (dirty_[i] && hasTRS_[i])
+        {
+            glm::mat4 m = glm::translate(glm::mat4(1.0f), translation_[i]) * glm::mat4_cast(rotation_[i]);
+            local_[i] = glm::scale(m, scale_[i]);
+        }
+        changed_[i] = (dirty_[i] || parentMoved) ? 1 : 0;
+        if (changed_[i])
+            world_[i] = (p >= 0) ? world_[p] * local_[i] : local_[i];
+        dirty_[i] = 0;
+    }
+    anyDirty_ = false;
+    return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// Retained node hierarchy with SoA transform arrays.
+//
+// Nodes are appended parents-first, so world transforms are resolved in a single
+// linear pass. Setters only flag a node dirty; updateWorld() rebuilds the local
+// matrix of dirty nodes and the world matrix of everything below them, and leaves
+// untouched subtrees alone.
+class SceneGraph {
+public:
+    // parent must already exist (or be -1 for a root)
+    int addNode(int parent, const glm::vec3& t, const glm::quat& r, const glm::vec3& s);
+    int addNode(int parent, const glm::mat4& local); // fixed matrix, not animatable
+    void clear();
+
+    void setTranslation(int node, const glm::vec3& t) { translation_[node] = t; dirty_[node] = 1; anyDirty_ = true; }
+    void setRotation(int node, const glm::quat& r)    { rotation_[node] = r;    dirty_[node] = 1; anyDirty_ = true; }
+    void setScale(int node, const glm::vec3& s)       { scale_[node] = s;       dirty_[node] = 1; anyDirty_ = true; }
+
+    // Recompute local/world matrices below dirty nodes. Returns true if anything moved.
+    bool updateWorld();
+
+    size_t size() const { return parent_.size(); }
+    int parent(int node) const { return parent_[node]; }
+    const glm::mat4& world(int node) const { return world_[node]; }
+    const glm::mat4& local(int node) const { return local_[node]; }
+    bool changed(int node) const { return changed_[node] != 0; } // moved in the last updateWorld()
+
+private:
+    std::vector<int> parent_;
+    std::vector<glm::vec3> translation_, scale_;
+    std::vector<glm::quat> rotation_;
+    std::vector<uint8_t> hasTRS_;
+    std::vector<glm::mat4> local_, world_;
+    std::vector<uint8_t> dirty_, changed_;
+    bool anyDirty_ = false;
+};
@@ -1,44 +1,138 @@
 #include "gfx/Shader.hpp"
+#include "gfx/GLExt.hpp"
+#include "gfx/ShaderCache.hpp"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
 #include <fstream>
 #include <sstream>
 #include <string>
 
-Shader::Shader(const char* vertSrc, const char* fragSrc) 
+Shader::Shader(const char* vertSrc, const char* fragSrc, const std::string& defines) 
 {
-    GLuint vs = compile(GL_VERTEX_SHADER, vertSrc);
-    GLuint fs = compile(GL_FRAGMENT_SHADER, fragSrc);
+    const GLenum types[] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+    const char* sources[] = { vertSrc, fragSrc };
+    start(types, sources, 2, defines);
+    finish();
+}
+
+Shader::Shader(const char* computeSrc)
+{
+    const GLenum type = GL_COMPUTE_SHADER;
+    start(&type, &computeSrc, 1, {});
+    finish();
+}
 
+std::unique_ptr<Shader> Shader::Start(const char* vertexSrc, const char* fragmentSrc, const std::string& defines,
+                                      const char* geometrySrc)
+{
+    std::unique_ptr<Shader> shader(new Shader());
+    if (geometrySrc)
+    {
+        const GLenum types[] = { GL_VERTEX_SHADER, GL_GEOMETRY_SHADER, GL_FRAGMENT_SHADER };
+        const char* sources[] = { vertexSrc, geometrySrc, fragmentSrc };
+        shader->start(types, sources, 3, defines);
+    }
+    else
+    {
+        const GLenum types[] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+        const char* sources[] = { vertexSrc, fragmentSrc };
+        shader->start(types, sources, 2, defines);
+    }
+    return shader;
+}
+
+void Shader::start(const GLenum* types, const char* const* sources, int count, const std::string& defines)
+{
+    cacheKey_ = ShaderCache::Key(sources, count, defines);
     prog_ = glCreateProgram();
-    glAttachShader(prog_, vs);
-    glAttachShader(prog_, fs);
+    if (ShaderCache::Load(prog_, cacheKey_))
+    {
+        reflect();
+        return;
+    }
+    // A rejected binary may leave state behind; build from source in a fresh object
+    glDeleteProgram(prog_);
+    prog_ = glCreateProgram();
+
+    // No status queries until finish(), so the driver can compile in the background
+    for (int i = 0; i < count; ++i)
+    {
+        stages_[i] = compile(types[i], sources[i], defines);
+        glAttachShader(prog_, stages_[i]);
+    }
+    stageCount_ = count;
+    if (GLExt::HasProgramBinary()) GLExt::ProgramParameteri(prog_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(prog_);
+    pending_ = true;
+}
 
-    GLint ok = 0;
-    glGetProgramiv(prog_, GL_LINK_STATUS, &ok);
-    if (!ok) 
+bool Shader::ready() const
+{
+    if (!pending_ || !GLExt::HasParallelCompile()) return true;
+    GLint done = 0;
+    glGetProgramiv(prog_, GL_COMPLETION_STATUS_KHR, &done);
+    return done != 0;
+}
+
+void Shader::finish()
+{
+    if (!pending_) return;
+    pending_ = false;
+
+    std::string error;
+    for (int i = 0; i < stageCount_ && error.empty(); ++i)
     {
+        GLint ok = 0;
+        glGetShaderiv(stages_[i], GL_COMPILE_STATUS, &ok);
+        if (ok) continue;
         char log[2048];
-        glGetProgramInfoLog(prog_, 2048, nullptr, log);
-        glDeleteShader(vs);
-        glDeleteShader(fs);
+        glGetShaderInfoLog(stages_[i], 2048, nullptr, log);
+        GLint type = 0;
+        glGetShaderiv(stages_[i], GL_SHADER_TYPE, &type);
+        const char* kind = (type == GL_VERTEX_SHADER) ? "vertex" : (type == GL_FRAGMENT_SHADER) ? "fragment"
+                         : (type == GL_GEOMETRY_SHADER) ? "geometry" : "compute";
+        error = std::string("Compile failed (") + kind + "): " + log;
+    }
+    if (error.empty())
+    {
+        GLint ok = 0;
+        glGetProgramiv(prog_, GL_LINK_STATUS, &ok);
+        if (!ok)
+        {
+            char log[2048];
+            glGetProgramInfoLog(prog_, 2048, nullptr, log);
+            error = std::string("Program link failed: ") + log;
+        }
+    }
+    releaseStages();
+    if (!error.empty())
+    {
         glDeleteProgram(prog_);
-        throw std::runtime_error(std::string("Program link failed: ") + log);
+        prog_ = 0;
+        throw std::runtime_error(error);
     }
-    glDeleteShader(vs);
-    glDeleteShader(fs);
+    ShaderCache::Store(prog_, cacheKey_);
+    reflect();
+}
+
+void Shader::releaseStages()
+{
+    for (int i = 0; i < stageCount_; ++i) glDeleteShader(stages_[i]);
+    stageCount_ = 0;
 }
 
 Shader::~Shader() 
 {
+    releaseStages();
     if (prog_) glDeleteProgram(prog_);
 }
 
-static std::string readTextFile(const char* path)
+std::string Shader::ReadFile(const char* path)
 {
     std::ifstream in(path, std::ios::in | std::ios::binary);
     if (!in)
@@ -49,46 +143,62 @@ static std::string readTextFile(const char* path)
     return ss.str();
 }
 
-std::unique_ptr<Shader> Shader::FromFiles(const char* vertexPath, const char* fragmentPath)
+std::unique_ptr<Shader> Shader::FromFiles(const char* vertexPath, const char* fragmentPath, const std::string& defines)
 {
-    const std::string vs = readTextFile(vertexPath);
-    const std::string fs = readTextFile(fragmentPath);
-    return std::unique_ptr<Shader>(new Shader(vs.c_str(), fs.c_str()));
+    const std::string vs = ReadFile(vertexPath);
+    const std::string fs = ReadFile(fragmentPath);
+    return std::unique_ptr<Shader>(new Shader(vs.c_str(), fs.c_str(), defines));
+}
+
+std::unique_ptr<Shader> Shader::ComputeFromFile(const char* computePath)
+{
+    const std::string cs = ReadFile(computePath);
+    return std::unique_ptr<Shader>(new Shader(cs.c_str()));
 }
 
 Shader::Shader(Shader&& o) noexcept 
 { 
-    prog_ = o.prog_;
-    o.prog_ = 0; 
+    *this = std::move(o);
 }
 
 Shader& Shader::operator=(Shader&& o) noexcept 
 {
     if (this != &o) 
     { 
+        releaseStages();
         if (prog_) glDeleteProgram(prog_);
         prog_ = o.prog_;
+        std::copy(o.stages_, o.stages_ + 3, stages_);
+        stageCount_ = o.stageCount_;
+        pending_ = o.pending_;
+        cacheKey_ = o.cacheKey_;
+        uniforms_ = std::move(o.uniforms_);
+        blocks_ = std::move(o.blocks_);
         o.prog_ = 0; 
+        o.stageCount_ = 0;
+        o.pending_ = false;
     }
 
     return *this;
 }
 
-GLuint Shader::compile(GLenum type, const char* src) 
+GLuint Shader::compile(GLenum type, const char* src, const std::string& defines) 
 {
     GLuint s = glCreateShader(type);
-    glShaderSource(s, 1, &src, nullptr);
-    glCompileShader(s);
-    GLint ok = 0; glGetShaderiv(s, GL_COMPILE_STATUS, &ok);
-    if (!ok) 
+    // #version must stay the first line, so defines go right after it
+    const char* body = src;
+    const char* version = std::strstr(src, "#version");
+    if (version)
     {
-        char log[2048];
-        glGetShaderInfoLog(s, 2048, nullptr, log);
-        glDeleteShader(s);
-        const char* kind = (type == GL_VERTEX_SHADER) ? "vertex" : "fragment";
-        throw std::runtime_error(std::string("Compile failed (") + kind + "): " + log);
+        const char* eol = std::strchr(version, '\n');
+        body = eol ? eol + 1 : version + std::strlen(version);
     }
-
+    const std::string head(src, body);
+    // Keep compiler messages on the source file's line numbers
+    const std::string injected = defines.empty() ? std::string() : defines + "#line 2\n";
+    const char* parts[3] = { head.c_str(), injected.c_str(), body };
+    glShaderSource(s, 3, parts, nullptr);
+    glCompileShader(s);
     return s;
 }
 
@@ -97,9 +207,53 @@ void Shader::use() const
     glUseProgram(prog_); 
 }
 
+void Shader::reflect()
+{
+    uniforms_.clear();
+    blocks_.clear();
+
+    GLint count = 0, maxLen = 0;
+    glGetProgramiv(prog_, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(prog_, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLen);
+    std::vector<char> name(std::max(maxLen, 1) + 1);
+    for (GLint i = 0; i < count; ++i)
+    {
+        GLsizei len = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(prog_, (GLuint)i, (GLsizei)name.size(), &len, &size, &type, name.data());
+        const GLint l = glGetUniformLocation(prog_, name.data());
+        if (l < 0) continue; // member of a uniform block
+        std::string n(name.data(), len);
+        // arrays are reported as "name[0]"; index them by their base name
+        if (n.size() > 3 && n.compare(n.size() - 3, 3, "[0]") == 0) n.resize(n.size() - 3);
+        uniforms_.emplace_back(std::move(n), l);
+    }
+    std::sort(uniforms_.begin(), uniforms_.end());
+
+    glGetProgramiv(prog_, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+    glGetProgramiv(prog_, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLen);
+    name.resize(std::max(maxLen, 1) + 1);
+    for (GLint i = 0; i < count; ++i)
+    {
+        GLsizei len = 0;
+        glGetActiveUniformBlockName(prog_, (GLuint)i, (GLsizei)name.size(), &len, name.data());
+        blocks_.emplace_back(name.data(), len);
+        if (blocks_.back() == "Frame") glUniformBlockBinding(prog_, (GLuint)i, FrameBlockBinding);
+        else if (blocks_.back() == "Material") glUniformBlockBinding(prog_, (GLuint)i, MaterialBlockBinding);
+    }
+}
+
 GLint Shader::loc(const char* name) const 
 { 
-    return glGetUniformLocation(prog_, name); 
+    auto it = std::lower_bound(uniforms_.begin(), uniforms_.end(), name,
+                               [](const std::pair<std::string, GLint>& u, const char* n) { return std::strcmp(u.first.c_str(), n) < 0; });
+    return (it != uniforms_.end() && it->first == name) ? it->second : -1;
+}
+
+bool Shader::hasBlock(const char* name) const
+{
+    return std::find(blocks_.begin(), blocks_.end(), name) != blocks_.end();
 }
 
 void Shader::setMat4(const char* name, const float* m16) const 
@@ -2,6 +2,8 @@
 #include <string>
 #include <cstdint>
 #include <memory>
+#include <utility>
+#include <vector>
 
 using GLuint = unsigned int;
 using GLenum = unsigned int;
@@ -9,7 +11,11 @@ using GLint  = int;
 
 class Shader {
 public:
-    Shader(const char* vertexSrc, const char* fragmentSrc);
+    // defines ("#define NAME\n" lines) are inserted after the #version line of both stages.
+    // Programs are linked from the on-disk binary cache when possible (see ShaderCache).
+    Shader(const char* vertexSrc, const char* fragmentSrc, const std::string& defines = {});
+    // Compute program; needs a GL 4.3+ context (see GLExt)
+    explicit Shader(const char* computeSrc);
     ~Shader();
 
     Shader(const Shader&) = delete;
@@ -17,17 +23,50 @@ public:
     Shader(Shader&&) noexcept;
     Shader& operator=(Shader&&) noexcept;
 
+    // Uniform block binding points shared by every program. Blocks with these names are
+    // bound at link time, so callers only bind buffers.
+    static constexpr GLuint FrameBlockBinding    = 0; // "Frame": camera and lighting, once per frame
+    static constexpr GLuint MaterialBlockBinding = 1; // "Material": one range per draw
+
     void use() const;
     GLuint id() const { return prog_; }
 
+    // Location of an active uniform, reflected at link time (-1 if inactive)
     GLint loc(const char* name) const;
+    bool  hasBlock(const char* name) const;
     void  setMat4(const char* name, const float* m16) const;
     void  setVec3(const char* name, float x, float y, float z) const;
 
     // Load shader sources from files on disk located at the given paths.
-    static std::unique_ptr<Shader> FromFiles(const char* vertexPath, const char* fragmentPath);
+    static std::unique_ptr<Shader> FromFiles(const char* vertexPath, const char* fragmentPath,
+                                             const std::string& defines = {});
+    static std::string ReadFile(const char* path);
+    static std::unique_ptr<Shader> ComputeFromFile(const char* computePath);
+
+    // Start building without waiting on the driver: with parallel shader compilation
+    // (GLExt::HasParallelCompile) programs started back to back build concurrently.
+    // finish() waits, checks and reflects, throwing like the constructor; until then only
+    // id() and ready() may be used. Cache hits come back finished. A geometrySrc adds a
+    // geometry stage between the two.
+    static std::unique_ptr<Shader> Start(const char* vertexSrc, const char* fragmentSrc,
+                                         const std::string& defines = {}, const char* geometrySrc = nullptr);
+    bool ready() const; // finish() would not block; always true without parallel compilation
+    void finish();
 
 private:
+    Shader() = default;
+
     GLuint prog_ = 0;
-    static GLuint compile(GLenum type, const char* src);
+    GLuint stages_[3] = {};   // compiled stages of a pending program
+    int stageCount_ = 0;
+    bool pending_ = false;    // linked but not yet checked
+    uint64_t cacheKey_ = 0;
+    // Sorted by name for allocation-free lookup
+    std::vector<std::pair<std::string, GLint>> uniforms_;
+    std::vector<std::string> blocks_;
+
+    void start(const GLenum* types, const char* const* sources, int count, const std::string& defines);
+    void releaseStages();
+    void reflect();
+    static GLuint compile(GLenum type, const char* src, const std::string& defines); // status checked in finish()
 };
@@ -0,0 +1,111 @@
+#include "gfx/ShaderCache.hpp"
+#include "gfx/GLExt.hpp"
+
+#include <glad/glad.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+std::string ShaderCache::dir_ = "shadercache";
+ShaderCache::Stats ShaderCache::stats_;
+uint64_t ShaderCache::driver_ = 0;
+
+namespace {
+
+constexpr char kProgramMagic[8] = { 'M','V','P','R','O','G','0','1' };
+
+struct ProgramCacheHeader {
+    char magic[8];
+    uint32_t format;   // driver binary format
+    uint32_t length;   // bytes of binary that follow
+};
+
+// FNV-1a
+uint64_t hashBytes(const void* data, size_t size, uint64_t h = 1469598103934665603ull)
+{
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+uint64_t hashString(const char* s, uint64_t h)
+{
+    // Include the terminator so ("ab", "c") and ("a", "bc") differ
+    return s ? hashBytes(s, std::strlen(s) + 1, h) : hashBytes("", 1, h);
+}
+
+std::string entryPath(const std::string& dir, uint64_t key)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "/%016" PRIx64 ".bin", key);
+    return dir + name;
+}
+
+} // namespace
+
+uint64_t ShaderCache::Key(const char* const* sources, int count, const std::string& defines)
+{
+    if (!driver_)
+    {
+        uint64_t h = 1469598103934665603ull;
+        for (GLenum e : { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION })
+            h = hashString(reinterpret_cast<const char*>(glGetString(e)), h);
+        driver_ = h;
+    }
+    uint64_t h = driver_;
+    for (int i = 0; i < count; ++i) h = hashString(sources[i], h);
+    return hashString(defines.c_str(), h);
+}
+
+bool ShaderCache::Load(GLuint program, uint64_t key)
+{
+    if (dir_.empty() || !GLExt::HasProgramBinary()) return false;
+    std::ifstream in(entryPath(dir_, key), std::ios::binary);
+    if (!in) return false;
+    ProgramCacheHeader h{};
+    if (!in.read(reinterpret_cast<char*>(&h), sizeof(h)) ||
+        std::memcmp(h.magic, kProgramMagic, sizeof(h.magic)) != 0 || h.length == 0)
+        return false;
+    std::vector<char> binary(h.length);
+    if (!in.read(binary.data(), std::streamsize(h.length))) return false;
+
+    GLExt::ProgramBinary(program, (GLenum)h.format, binary.data(), (GLsizei)h.length);
+    GLint ok = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &ok);
+    if (!ok) return false;
+    ++stats_.loaded;
+    return true;
+}
+
+void ShaderCache::Store(GLuint program, uint64_t key)
+{
+    ++stats_.compiled;
+    if (dir_.empty() || !GLExt::HasProgramBinary()) return;
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+    std::vector<char> binary((size_t)length);
+    GLsizei written = 0;
+    GLenum format = 0;
+    GLExt::GetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) return;
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir_, ec);
+    std::ofstream out(entryPath(dir_, key), std::ios::binary | std::ios::trunc);
+    if (!out) return; // read-only working directories just skip the cache
+    ProgramCacheHeader h{};
+    std::memcpy(h.magic, kProgramMagic, sizeof(h.magic));
+    h.format = (uint32_t)format;
+    h.length = (uint32_t)written;
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(binary.data(), written);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+using GLuint = unsigned int;
+
+// On-disk cache of linked program binaries (glGetProgramBinary). Entries are keyed by a
+// hash of the stage sources, the injected defines and the driver (vendor, renderer,
+// version), so a driver update simply misses and the binary is rebuilt. Each entry is
+// one "<dir>/<key>.bin" file; a binary the driver rejects is compiled again and
+// overwritten. Without program binary support only the statistics are kept.
+class ShaderCache {
+public:
+    // Relative to the working directory like assets/; empty disables the cache
+    static void SetDirectory(const std::string& dir) { dir_ = dir; }
+    static const std::string& Directory() { return dir_; }
+
+    static uint64_t Key(const char* const* sources, int count, const std::string& defines);
+
+    // Link program from the cached binary; false (program unlinked) on a miss
+    static bool Load(GLuint program, uint64_t key);
+    // Record a freshly compiled and linked program and write its binary
+    static void Store(GLuint program, uint64_t key);
+
+    struct Stats {
+        int loaded = 0;     // programs linked from a cached binary
+        int compiled = 0;   // programs compiled from source
+    };
+    static const Stats& GetStats() { return stats_; }
+
+private:
+    static std::string dir_;
+    static Stats stats_;
+    static uint64_t driver_;  // hash of the driver strings, 0 until the first Key()
+};
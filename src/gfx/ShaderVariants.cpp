@@ -0,0 +1,113 @@
+#include "gfx/ShaderVariants.hpp"
+
+#include <glad/glad.h>
+
+#include <functional>
+
+ShaderVariants::ShaderVariants(std::string vertexSrc, std::string fragmentSrc, std::vector<std::string> features,
+                               std::string geometrySrc, uint32_t geometryFeatures)
+    : vertexSrc_(std::move(vertexSrc)), fragmentSrc_(std::move(fragmentSrc)), geometrySrc_(std::move(geometrySrc)),
+      features_(std::move(features)), geometryFeatures_(geometryFeatures)
+{
+}
+
+std::shared_ptr<ShaderVariants> ShaderVariants::FromFiles(const char* vertexPath, const char* fragmentPath,
+                                                          std::vector<std::string> features,
+                                                          const char* geometryPath, uint32_t geometryFeatures)
+{
+    static std::unordered_map<size_t, std::weak_ptr<ShaderVariants>> live;
+
+    std::string vs = Shader::ReadFile(vertexPath), fs = Shader::ReadFile(fragmentPath);
+    std::string gs = geometryPath ? Shader::ReadFile(geometryPath) : std::string();
+    std::string key = vs + '\0' + fs + '\0' + gs + '\0' + std::to_string(geometryFeatures);
+    for (const std::string& f : features) key += '\0' + f;
+    const size_t hash = std::hash<std::string>{}(key);
+
+    // A hash collision only costs a second set, never a wrong one
+    std::weak_ptr<ShaderVariants>& slot = live[hash];
+    std::shared_ptr<ShaderVariants> shared = slot.lock();
+    if (shared && shared->vertexSrc_ == vs && shared->fragmentSrc_ == fs && shared->geometrySrc_ == gs &&
+        shared->geometryFeatures_ == geometryFeatures && shared->features_ == features)
+        return shared;
+    shared = std::make_shared<ShaderVariants>(std::move(vs), std::move(fs), std::move(features),
+                                              std::move(gs), geometryFeatures);
+    slot = shared;
+    return shared;
+}
+
+const Shader& ShaderVariants::get(uint32_t mask) const
+{
+    auto it = cache_.find(mask);
+    if (it != cache_.end()) return *it->second;
+
+    auto shader = start(mask);
+    shader->finish();
+    if (linkHook_) linkHook_(*shader);
+    return *cache_.emplace(mask, std::move(shader)).first->second;
+}
+
+void ShaderVariants::setLinkHook(std::function<void(const Shader&)> hook)
+{
+    linkHook_ = std::move(hook);
+    if (!linkHook_) return;
+    for (const auto& kv : cache_) linkHook_(*kv.second);
+}
+
+std::unique_ptr<Shader> ShaderVariants::start(uint32_t mask) const
+{
+    const bool geometry = (mask & geometryFeatures_) && !geometrySrc_.empty();
+    return Shader::Start(vertexSrc_.c_str(), fragmentSrc_.c_str(), defines(mask),
+                         geometry ? geometrySrc_.c_str() : nullptr);
+}
+
+void ShaderVariants::precompile(const std::vector<uint32_t>& masks) const
+{
+    std::vector<std::pair<uint32_t, std::unique_ptr<Shader>>> started;
+    for (uint32_t mask : masks)
+    {
+        if (cache_.count(mask)) continue;
+        bool dup = false;
+        for (const auto& s : started) dup |= s.first == mask;
+        if (!dup) started.emplace_back(mask, start(mask));
+    }
+    // Nothing is cached until all finished, so a failure leaves no half-built variant
+    for (auto& s : started) s.second->finish();
+    for (auto& s : started)
+    {
+        if (linkHook_) linkHook_(*s.second);
+        cache_.emplace(s.first, std::move(s.second));
+    }
+}
+
+std::string ShaderVariants::defines(uint32_t mask) const
+{
+    std::string defines;
+    for (size_t i = 0; i < features_.size(); ++i)
+    {
+        if (mask & (1u << i)) defines += "#define " + features_[i] + "\n";
+    }
+    return defines;
+}
+
+std::shared_ptr<ShaderVariants> Phong::Load()
+{
+    auto variants = ShaderVariants::FromFiles("assets/shaders/phong.vert", "assets/shaders/phong.frag",
+                                              { "LIGHTING", "ENVIRONMENT", "BASE_COLOR_TEX", "NORMAL_TEX", "BATCHED", "OIT", "WIREFRAME" },
+                                              "assets/shaders/phong.geom", Phong::Wireframe);
+    variants->setLinkHook(&Phong::SetSamplerUnits);
+    return variants;
+}
+
+void Phong::SetSamplerUnits(const Shader& shader)
+{
+    shader.use();
+    glUniform1i(shader.loc("uBaseColorTex"), BaseColorUnit);
+    glUniform1i(shader.loc("uNormalTex"), NormalUnit);
+    glUniform1i(shader.loc("uJoints"), JointsUnit);
+    glUniform1i(shader.loc("uMorphDeltas"), MorphDeltasUnit);
+    glUniform1i(shader.loc("uMorphWeights"), MorphWeightsUnit);
+    glUniform1i(shader.loc("uMaterialTable"), MaterialTableUnit);
+    GLint arrayUnits[kTexArrays];
+    for (int i = 0; i < kTexArrays; ++i) arrayUnits[i] = TexArraysUnit + i;
+    glUniform1iv(shader.loc("uTexArrays"), kTexArrays, arrayUnits);
+}
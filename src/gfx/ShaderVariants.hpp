@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gfx/Shader.hpp"
+
+// Programs compiled from one vertex/fragment source pair with different #define sets,
+// so features a draw does not use cost nothing at runtime. Bit i of a mask defines
+// features[i]. Variants with any of the geometryFeatures bits also link the geometry
+// source. Variants are compiled on first use and kept; get() throws like Shader when a
+// variant fails to build.
+class ShaderVariants {
+public:
+    ShaderVariants(std::string vertexSrc, std::string fragmentSrc, std::vector<std::string> features,
+                   std::string geometrySrc = {}, uint32_t geometryFeatures = 0);
+
+    // Sets are shared by source hash: loading the same sources and features again
+    // returns the live instance, so every scene drawing with phong uses one set of programs
+    static std::shared_ptr<ShaderVariants> FromFiles(const char* vertexPath, const char* fragmentPath,
+                                                     std::vector<std::string> features,
+                                                     const char* geometryPath = nullptr, uint32_t geometryFeatures = 0);
+
+    const Shader& get(uint32_t mask) const;
+    // Called once for every variant right after it links (and now for those already built),
+    // e.g. to set sampler units that never change
+    void setLinkHook(std::function<void(const Shader&)> hook);
+    // Build the given variants now, all started before any is waited on so the driver
+    // can compile them in parallel (GLExt::HasParallelCompile)
+    void precompile(const std::vector<uint32_t>& masks) const;
+    size_t compiledCount() const { return cache_.size(); }
+
+private:
+    std::string vertexSrc_, fragmentSrc_, geometrySrc_;
+    std::vector<std::string> features_;
+    uint32_t geometryFeatures_ = 0;
+    std::function<void(const Shader&)> linkHook_;
+    mutable std::unordered_map<uint32_t, std::unique_ptr<Shader>> cache_;
+
+    std::unique_ptr<Shader> start(uint32_t mask) const;
+    std::string defines(uint32_t mask) const;
+};
+
+// Feature bits of assets/shaders/phong.*; Load() defines LIGHTING, ENVIRONMENT, ... in this order
+namespace Phong
+{
+    enum Feature : uint32_t {
+        Lighting     = 1u << 0, // directional Phong; otherwise unlit base color
+        Environment  = 1u << 1, // hemisphere ambient and reflection tint
+        BaseColorTex = 1u << 2,
+        NormalTex    = 1u << 3,
+        Batched      = 1u << 4, // materials and texture arrays from the batch table
+        Oit          = 1u << 5, // weighted blended OIT outputs
+        Wireframe    = 1u << 6, // triangle edges over the shading (adds phong.geom)
+    };
+
+    // Texture units of the phong samplers; samplers of different types may not share a unit
+    enum Unit : int {
+        BaseColorUnit     = 0,
+        NormalUnit        = 1,
+        JointsUnit        = 2,
+        MorphDeltasUnit   = 3,
+        MorphWeightsUnit  = 4,
+        MaterialTableUnit = 5,
+        TexArraysUnit     = 6,  // uTexArrays[i] uses TexArraysUnit + i
+    };
+    constexpr int kTexArrays = 4; // size of uTexArrays in phong.frag
+
+    // Variants set their sampler units at link time through SetSamplerUnits
+    std::shared_ptr<ShaderVariants> Load();
+    // Point a program built from phong.vert and/or phong.frag at the units above (binds it)
+    void SetSamplerUnits(const Shader& shader);
+}
@@ -0,0 +1,389 @@
+#include "gfx/SplatCloud.hpp"
+#include "core/MappedFile.hpp"
+#include "core/RadixSort.hpp"
+#include "core/ThreadPool.hpp"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+constexpr int kTexWidth = 4096;            // texels per row; two per splat
+constexpr size_t kMinChunkSplats = 1u << 14;
+constexpr float kShC0 = 0.28209479177387814f;
+
+uint16_t floatToHalf(float f)
+{
+    uint32_t x;
+    std::memcpy(&x, &f, sizeof(x));
+    const uint32_t sign = (x >> 16) & 0x8000u;
+    int32_t exp = int32_t((x >> 23) & 0xFF) - 127 + 15;
+    uint32_t mant = x & 0x7FFFFFu;
+    if (exp <= 0)
+    {
+        if (exp < -10) return uint16_t(sign);
+        mant |= 0x800000u;
+        return uint16_t(sign | (mant >> (14 - exp)));
+    }
+    if (exp >= 31) return uint16_t(sign | 0x7BFFu); // clamp to max finite
+    return uint16_t(sign | (uint32_t(exp) << 10) | (mant >> 13));
+}
+
+inline uint8_t toUnorm8(float v)
+{
+    return uint8_t(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+inline uint32_t packRgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+    return uint32_t(r) | (uint32_t(g) << 8) | (uint32_t(b) << 16) | (uint32_t(a) << 24);
+}
+
+inline float sigmoid(float x) { return 1.0f / (1.0f + std::exp(-x)); }
+
+} // namespace
+
+SplatCloud::~SplatCloud()
+{
+    shutdown();
+}
+
+void SplatCloud::shutdown()
+{
+    if (sortJob_.valid()) sortJob_.wait();
+    sortJob_ = {};
+    if (dataTex_) { glDeleteTextures(1, &dataTex_); dataTex_ = 0; }
+    if (quadVbo_) { glDeleteBuffers(1, &quadVbo_); quadVbo_ = 0; }
+    if (orderVbo_) { glDeleteBuffers(1, &orderVbo_); orderVbo_ = 0; }
+    if (vao_) { glDeleteVertexArrays(1, &vao_); vao_ = 0; }
+    px_.clear(); py_.clear(); pz_.clear();
+    sx_.clear(); sy_.clear(); sz_.clear();
+    rgba_.clear(); rot_.clear();
+    readyOrder_.clear();
+    orderReady_ = false;
+    sortedOnce_ = false;
+    count_ = 0;
+}
+
+bool SplatCloud::IsSplatPly(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::string head(4096, '\0');
+    in.read(&head[0], (std::streamsize)head.size());
+    head.resize((size_t)in.gcount());
+    const size_t end = head.find("end_header");
+    if (end == std::string::npos) return false;
+    head.resize(end);
+    return head.find(" f_dc_0") != std::string::npos && head.find(" scale_0") != std::string::npos;
+}
+
+bool SplatCloud::load(const std::string& path)
+{
+    shutdown();
+    err_.clear();
+
+    std::string ext;
+    const auto dot = path.find_last_of('.');
+    if (dot != std::string::npos) ext = path.substr(dot);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return char(std::tolower(c)); });
+
+    const bool ok = (ext == ".splat") ? loadSplat(path) : loadPly(path);
+    if (!ok) return false;
+    if (count_ == 0) { err_ = "No splats found."; return false; }
+
+    computeBounds();
+    return upload();
+}
+
+bool SplatCloud::loadPly(const std::string& path)
+{
+    MappedFile file;
+    if (!file.Open(path)) { err_ = "Failed to open splat PLY: " + path; return false; }
+
+    const std::string head(file.Data(), std::min<size_t>(file.Size(), 64 * 1024));
+    const size_t endTag = head.find("end_header");
+    if (head.compare(0, 3, "ply") != 0 || endTag == std::string::npos) { err_ = "Not a PLY file."; return false; }
+    const size_t dataStart = head.find('\n', endTag) + 1;
+
+    // 3DGS exports are a single vertex element of float properties
+    std::istringstream header(head.substr(0, endTag));
+    std::string line;
+    std::unordered_map<std::string, size_t> offsets;
+    size_t stride = 0;
+    uint64_t count = 0;
+    bool inVertex = false;
+    while (std::getline(header, line))
+    {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        std::istringstream ls(line);
+        std::string key; ls >> key;
+        if (key == "format")
+        {
+            std::string fmt; ls >> fmt;
+            if (fmt != "binary_little_endian") { err_ = "Only binary_little_endian splat PLY is supported."; return false; }
+        }
+        else if (key == "element")
+        {
+            std::string name; ls >> name;
+            inVertex = (name == "vertex");
+            if (inVertex) ls >> count;
+            else if (count) break; // trailing elements do not matter
+        }
+        else if (key == "property" && inVertex)
+        {
+            std::string type, name; ls >> type >> name;
+            if (type != "float" && type != "float32") { err_ = "Splat PLY properties must be float: " + name; return false; }
+            offsets[name] = stride;
+            stride += 4;
+        }
+    }
+    const char* required[] = { "x", "y", "z", "f_dc_0", "f_dc_1", "f_dc_2", "opacity",
+                               "scale_0", "scale_1", "scale_2", "rot_0", "rot_1", "rot_2", "rot_3" };
+    size_t off[14];
+    for (int i = 0; i < 14; ++i)
+    {
+        auto it = offsets.find(required[i]);
+        if (it == offsets.end()) { err_ = std::string("Splat PLY is missing property ") + required[i]; return false; }
+        off[i] = it->second;
+    }
+    if (dataStart + stride * count > file.Size()) { err_ = "Splat PLY data is truncated."; return false; }
+
+    count_ = (size_t)count;
+    px_.resize(count_); py_.resize(count_); pz_.resize(count_);
+    sx_.resize(count_); sy_.resize(count_); sz_.resize(count_);
+    rgba_.resize(count_); rot_.resize(count_);
+
+    const char* base = file.Data() + dataStart;
+    ThreadPool::Get().ParallelFor(count_, kMinChunkSplats, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i)
+        {
+            const char* rec = base + i * stride;
+            float v[14];
+            for (int k = 0; k < 14; ++k) std::memcpy(&v[k], rec + off[k], 4);
+
+            px_[i] = v[0]; py_[i] = v[1]; pz_[i] = v[2];
+            // Degree-0 spherical harmonics give the view-independent base color
+            rgba_[i] = packRgba(toUnorm8(0.5f + kShC0 * v[3]), toUnorm8(0.5f + kShC0 * v[4]),
+                                toUnorm8(0.5f + kShC0 * v[5]), toUnorm8(sigmoid(v[6])));
+            sx_[i] = floatToHalf(std::exp(v[7]));
+            sy_[i] = floatToHalf(std::exp(v[8]));
+            sz_[i] = floatToHalf(std::exp(v[9]));
+
+            float q[4] = { v[10], v[11], v[12], v[13] };
+            const float len = std::sqrt(q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3]);
+            const float inv = len > 0.0f ? 1.0f / len : 0.0f;
+            uint8_t qb[4];
+            for (int k = 0; k < 4; ++k)
+                qb[k] = uint8_t(std::clamp(q[k] * inv * 128.0f + 128.0f, 0.0f, 255.0f));
+            rot_[i] = packRgba(qb[0], qb[1], qb[2], qb[3]);
+        }
+    });
+    return true;
+}
+
+bool SplatCloud::loadSplat(const std::string& path)
+{
+    // 32-byte records: float3 position, float3 scale, RGBA8 color, quaternion as 4 x uint8
+    MappedFile file;
+    if (!file.Open(path)) { err_ = "Failed to open .splat: " + path; return false; }
+    if (file.Size() % 32 != 0) { err_ = "Corrupt .splat (size is not a multiple of 32)."; return false; }
+
+    count_ = file.Size() / 32;
+    px_.resize(count_); py_.resize(count_); pz_.resize(count_);
+    sx_.resize(count_); sy_.resize(count_); sz_.resize(count_);
+    rgba_.resize(count_); rot_.resize(count_);
+
+    const char* base = file.Data();
+    ThreadPool::Get().ParallelFor(count_, kMinChunkSplats, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i)
+        {
+            const char* rec = base + i * 32;
+            float f[6];
+            std::memcpy(f, rec, sizeof(f));
+            px_[i] = f[0]; py_[i] = f[1]; pz_[i] = f[2];
+            sx_[i] = floatToHalf(f[3]); sy_[i] = floatToHalf(f[4]); sz_[i] = floatToHalf(f[5]);
+            std::memcpy(&rgba_[i], rec + 24, 4);
+            std::memcpy(&rot_[i], rec + 28, 4);
+        }
+    });
+    return true;
+}
+
+void SplatCloud::computeBounds()
+{
+    // Trained scenes carry far-away floaters; frame the 2nd..98th percentile instead
+    const size_t step = std::max<size_t>(1, count_ / 100000);
+    std::vector<float> axis[3];
+    for (size_t i = 0; i < count_; i += step)
+    {
+        axis[0].push_back(px_[i]); axis[1].push_back(py_[i]); axis[2].push_back(pz_[i]);
+    }
+    for (int k = 0; k < 3; ++k)
+    {
+        auto& a = axis[k];
+        const size_t lo = a.size() * 2 / 100, hi = std::min(a.size() - 1, a.size() * 98 / 100);
+        std::nth_element(a.begin(), a.begin() + lo, a.end());
+        bmin_[k] = a[lo];
+        std::nth_element(a.begin(), a.begin() + hi, a.end());
+        bmax_[k] = a[hi];
+    }
+}
+
+bool SplatCloud::upload()
+{
+    // Two RGBA32UI texels per splat: (pos.xyz bits, rgba8) and (scale.xy half, scale.z half, rot, 0)
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    const size_t rowCount = (count_ * 2 + kTexWidth - 1) / kTexWidth;
+    if (kTexWidth > maxSize || rowCount > size_t(maxSize))
+    {
+        char buf[160];
+        snprintf(buf, sizeof(buf), "Too many splats for one data texture (%zu, the GPU allows %zu).",
+                 count_, size_t(maxSize) * kTexWidth / 2);
+        err_ = buf;
+        return false;
+    }
+    const int rows = int(rowCount);
+    std::vector<uint32_t> texels(size_t(rows) * kTexWidth * 4, 0u);
+    ThreadPool::Get().ParallelFor(count_, kMinChunkSplats, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i)
+        {
+            uint32_t* t = texels.data() + i * 8;
+            std::memcpy(&t[0], &px_[i], 4);
+            std::memcpy(&t[1], &py_[i], 4);
+            std::memcpy(&t[2], &pz_[i], 4);
+            t[3] = rgba_[i];
+            t[4] = uint32_t(sx_[i]) | (uint32_t(sy_[i]) << 16);
+            t[5] = uint32_t(sz_[i]);
+            t[6] = rot_[i];
+            t[7] = 0u;
+        }
+    });
+
+    glGenTextures(1, &dataTex_);
+    glBindTexture(GL_TEXTURE_2D, dataTex_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32UI, kTexWidth, rows, 0, GL_RGBA_INTEGER, GL_UNSIGNED_INT, texels.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Quad corners at +-2 sigma, the extent the shader scales to the projected ellipse
+    const float quad[] = { -2.0f, -2.0f, 2.0f, -2.0f, -2.0f, 2.0f, 2.0f, 2.0f };
+    std::vector<uint32_t> order(count_);
+    for (size_t i = 0; i < count_; ++i) order[i] = (uint32_t)i;
+
+    glGenVertexArrays(1, &vao_);
+    glGenBuffers(1, &quadVbo_);
+    glGenBuffers(1, &orderVbo_);
+    glBindVertexArray(vao_);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVbo_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glBindBuffer(GL_ARRAY_BUFFER, orderVbo_);
+    glBufferData(GL_ARRAY_BUFFER, order.size() * sizeof(uint32_t), order.data(), GL_DYNAMIC_DRAW);
+    glEnableVertexAttribArray(1);
+    glVertexAttribIPointer(1, 1, GL_UNSIGNED_INT, sizeof(uint32_t), (void*)0);
+    glVertexAttribDivisor(1, 1);
+    glBindVertexArray(0);
+    return true;
+}
+
+void SplatCloud::startSort(const glm::vec4& depthRow)
+{
+    sortedRow_ = depthRow;
+    sortedOnce_ = true;
+    sortJob_ = ThreadPool::Get().Submit([this, depthRow]() {
+        const auto t0 = std::chrono::steady_clock::now();
+        const size_t n = count_;
+        sortKeys_.resize(n); sortTmpKeys_.resize(n);
+        sortValues_.resize(n); sortTmpValues_.resize(n);
+
+        // View-space z ascending = farthest first, which is the back-to-front blend order
+        ThreadPool::Get().ParallelFor(n, kMinChunkSplats, [&](size_t b, size_t e) {
+            for (size_t i = b; i < e; ++i)
+            {
+                const float z = depthRow.x * px_[i] + depthRow.y * py_[i] + depthRow.z * pz_[i] + depthRow.w;
+                sortKeys_[i] = FloatToSortableBits(z);
+                sortValues_[i] = (uint32_t)i;
+            }
+        });
+        RadixSortPairs(sortKeys_.data(), sortValues_.data(), sortTmpKeys_.data(), sortTmpValues_.data(), n);
+
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        std::lock_guard<std::mutex> lock(sortMutex_);
+        readyOrder_.swap(sortValues_);
+        orderReady_ = true;
+        lastSortMs_ = ms;
+    });
+}
+
+bool SplatCloud::sortPending() const
+{
+    std::lock_guard<std::mutex> lock(sortMutex_);
+    return sortJob_.valid() || orderReady_;
+}
+
+void SplatCloud::collectSort()
+{
+    std::lock_guard<std::mutex> lock(sortMutex_);
+    if (!orderReady_) return;
+    glBindBuffer(GL_ARRAY_BUFFER, orderVbo_);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, readyOrder_.size() * sizeof(uint32_t), readyOrder_.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    orderReady_ = false;
+}
+
+void SplatCloud::render(const Camera& cam, const glm::mat4& model, Shader& shader, int viewportWidth, int viewportHeight)
+{
+    if (!vao_ || count_ == 0) return;
+
+    const glm::mat4 modelView = cam.view() * model;
+    collectSort();
+
+    // Only the view-space z row matters for ordering; re-sort when it moves noticeably
+    const glm::vec4 row(modelView[0][2], modelView[1][2], modelView[2][2], modelView[3][2]);
+    const bool busy = sortJob_.valid() && sortJob_.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    if (!busy)
+    {
+        if (sortJob_.valid()) sortJob_.get();
+        const glm::vec4 d = row - sortedRow_;
+        const float extent = glm::length(bmax_ - bmin_);
+        if (!sortedOnce_ || std::abs(d.x) + std::abs(d.y) + std::abs(d.z) > 1e-3f || std::abs(d.w) > 1e-3f * extent)
+            startSort(row);
+    }
+
+    shader.use();
+    glUniformMatrix4fv(shader.loc("uModelView"), 1, GL_FALSE, glm::value_ptr(modelView));
+    glUniformMatrix4fv(shader.loc("uProj"), 1, GL_FALSE, glm::value_ptr(cam.proj()));
+    glUniform2f(shader.loc("uViewport"), float(viewportWidth), float(viewportHeight));
+    glUniform2f(shader.loc("uFocal"), cam.proj()[0][0] * 0.5f * float(viewportWidth), cam.proj()[1][1] * 0.5f * float(viewportHeight));
+    glUniform1i(shader.loc("uSplats"), 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, dataTex_);
+
+    // Back-to-front "over" blending; splats test against but never write depth
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDepthMask(GL_FALSE);
+    glBindVertexArray(vao_);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)count_);
+    glBindVertexArray(0);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include "gfx/Shader.hpp"
+#include "core/Camera.hpp"
+
+using GLuint = unsigned int;
+
+// 3D Gaussian splat scene (.ply from 3DGS training, or antimatter15 .splat).
+//
+// Splats are stored as quantized SoA on the CPU (float positions for sorting,
+// half-float scales, RGBA8 color, 8-bit quaternions) and packed into an integer
+// texture for the GPU. They are drawn as instanced screen-aligned quads whose
+// per-instance attribute is the splat index in back-to-front order. Whenever the
+// view changes a depth sort is launched on the worker pool (parallel radix sort);
+// the render thread keeps drawing the previous order and uploads the new one
+// once it is ready, so it never waits on the sort.
+class SplatCloud {
+public:
+    SplatCloud() = default;
+    ~SplatCloud();
+
+    bool load(const std::string& path);
+    void shutdown();
+
+    void render(const Camera& cam, const glm::mat4& model, Shader& shader, int viewportWidth, int viewportHeight);
+
+    // Robust bounds (outlier floaters trimmed) for framing the camera
+    void getBounds(glm::vec3& minOut, glm::vec3& maxOut) const { minOut = bmin_; maxOut = bmax_; }
+    size_t count() const { return count_; }
+    double lastSortMs() const { return lastSortMs_; }
+    // A sort is running or its order has not been uploaded yet
+    bool sortPending() const;
+
+    const std::string& lastError() const { return err_; }
+
+    // True if a .ply file carries 3DGS splat attributes rather than a plain point cloud
+    static bool IsSplatPly(const std::string& path);
+
+private:
+    bool loadPly(const std::string& path);
+    bool loadSplat(const std::string& path);
+    void computeBounds();
+    bool upload();
+
+    void startSort(const glm::vec4& depthRow);
+    void collectSort();
+
+    std::string err_;
+    size_t count_ = 0;
+
+    // Quantized SoA
+    std::vector<float> px_, py_, pz_;
+    std::vector<uint16_t> sx_, sy_, sz_;  // half-float linear scales
+    std::vector<uint32_t> rgba_;          // RGBA8, alpha = opacity
+    std::vector<uint32_t> rot_;           // quaternion (w,x,y,z) as 4 x uint8, q*128+128
+
+    glm::vec3 bmin_{0}, bmax_{0};
+
+    GLuint dataTex_ = 0;                  // RGBA32UI, two texels per splat
+    GLuint quadVbo_ = 0, orderVbo_ = 0, vao_ = 0;
+
+    // Async sort state; the job owns its key scratch and publishes into ready*
+    std::future<void> sortJob_;
+    mutable std::mutex sortMutex_;
+    std::vector<uint32_t> readyOrder_;
+    bool orderReady_ = false;
+    double lastSortMs_ = 0.0;
+    glm::vec4 sortedRow_{0.0f};
+    bool sortedOnce_ = false;
+    std::vector<uint32_t> sortKeys_, sortTmpKeys_, sortValues_, sortTmpValues_;
+};
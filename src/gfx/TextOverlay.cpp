@@ -8,58 +8,14 @@
 #include <cstring>
 #include <cctype>
 
-static unsigned int compile(GLenum type, const char* src)
-{
-    GLuint s = glCreateShader(type);
-    glShaderSource(s, 1, &src, nullptr);
-    glCompileShader(s);
-    GLint ok = 0; 
-    glGetShaderiv(s, GL_COMPILE_STATUS, &ok);
-    if (!ok) 
-    { 
-        char log[1024]; 
-        glGetShaderInfoLog(s, 1024, nullptr, log); 
-        glDeleteShader(s); 
-        return 0; 
-    }
-    return s;
-}
-
-static unsigned int linkProg(const char* vs, const char* fs)
-{
-    GLuint v = compile(GL_VERTEX_SHADER, vs);
-    GLuint f = compile(GL_FRAGMENT_SHADER, fs);
-    if (!v || !f) 
-    { 
-        if(v) glDeleteShader(v); 
-        if(f) glDeleteShader(f); 
-        return 0; 
-    }
-    GLuint p = glCreateProgram();
-    glAttachShader(p, v); 
-    glAttachShader(p, f); 
-    glLinkProgram(p);
-    glDeleteShader(v); 
-    glDeleteShader(f);
-    GLint ok = 0; 
-    glGetProgramiv(p, GL_LINK_STATUS, &ok);
-    if (!ok) 
-    { char log[1024]; 
-        glGetProgramInfoLog(p, 1024, nullptr, log); 
-        glDeleteProgram(p); 
-        return 0; 
-    }
-    return p;
-}
-
 void TextOverlay::init()
 {
-    if (!prog_)
+    if (!shader_)
     {
         // Minimal inline shader sources matching assets/shaders/overlay.* for portability
         const char* vs = "#version 330 core\nlayout(location=0) in vec2 aPos;\nvoid main(){ gl_Position = vec4(aPos,0.0,1.0); }\n";
         const char* fs = "#version 330 core\nout vec4 FragColor; uniform vec4 uColor; void main(){ FragColor = uColor; }\n";
-        prog_ = linkProg(vs, fs);
+        shader_ = std::make_unique<Shader>(vs, fs);
     }
     if (!vao_)
     {
@@ -77,7 +33,7 @@ void TextOverlay::shutdown()
 {
     if (vbo_) { glDeleteBuffers(1, &vbo_); vbo_ = 0; }
     if (vao_) { glDeleteVertexArrays(1, &vao_); vao_ = 0; }
-    if (prog_) { glDeleteProgram(prog_); prog_ = 0; }
+    shader_.reset();
 }
 
 void TextOverlay::ensureGL() const
@@ -100,9 +56,8 @@ void TextOverlay::drawRect(int fbWidth, int fbHeight, float x, float y, float w,
         x0,y0, x1,y1, x0,y1
     };
 
-    glUseProgram(prog_);
-    GLint loc = glGetUniformLocation(prog_, "uColor");
-    glUniform4f(loc, r,g,b,a);
+    shader_->use();
+    glUniform4f(shader_->loc("uColor"), r,g,b,a);
     glBindVertexArray(vao_);
     glBindBuffer(GL_ARRAY_BUFFER, vbo_);
     glBufferData(GL_ARRAY_BUFFER, sizeof(verts), verts, GL_DYNAMIC_DRAW);
@@ -213,9 +168,8 @@ void TextOverlay::drawString(int fbWidth, int fbHeight, float x, float y, float
         xy[i+1] = toNDCY(fbHeight, xy[i+1]);
     }
 
-    glUseProgram(prog_);
-    GLint loc = glGetUniformLocation(prog_, "uColor");
-    glUniform4f(loc, r,g,b,a);
+    shader_->use();
+    glUniform4f(shader_->loc("uColor"), r,g,b,a);
     glBindVertexArray(vao_);
     glBindBuffer(GL_ARRAY_BUFFER, vbo_);
     glBufferData(GL_ARRAY_BUFFER, xy.size()*sizeof(float), xy.data(), GL_DYNAMIC_DRAW);
@@ -228,6 +182,17 @@ void TextOverlay::drawString(int fbWidth, int fbHeight, float x, float y, float
     if (depthWasOn) glEnable(GL_DEPTH_TEST);
 }
 
+void TextOverlay::submitHelp(RenderQueue& queue, int fbWidth, int fbHeight, bool modelMode)
+{
+    help_ = Help{fbWidth, fbHeight, modelMode};
+    queue.submit(RenderQueue::MakeKey(RenderQueue::Pass::Overlay, shader_ ? shader_->id() : 0u, 0, 0.0f), this, 0);
+}
+
+void TextOverlay::draw(uint32_t) const
+{
+    renderHelp(help_.fbWidth, help_.fbHeight, help_.modelMode);
+}
+
 void TextOverlay::renderHelp(int fbWidth, int fbHeight, bool modelMode) const
 {
     const float pad = 12.0f;
@@ -239,8 +204,15 @@ void TextOverlay::renderHelp(int fbWidth, int fbHeight, bool modelMode) const
     const char* linesModel[] = {
         "M - Toggle Model/Cube",
         "L - Toggle Lighting",
-        "A - Toggle Anti-Aliasing",
+        "A - Cycle Anti-Aliasing",
+        "E - Toggle On-demand Rendering",
         "LEFT/RIGHT - Switch Model",
+        "B - Toggle Batching",
+        "G - Toggle GPU Culling (GL 4.3)",
+        "O - Toggle Occlusion Culling",
+        "Q - Toggle Occlusion Queries",
+        "T - Toggle OIT Transparency",
+        "Z - Toggle Depth Pre-pass",
         "F - Toggle Wireframe",
         "C - Toggle Face Culling",
         "R - Reset Camera",
@@ -252,7 +224,8 @@ void TextOverlay::renderHelp(int fbWidth, int fbHeight, bool modelMode) const
     const char* linesCube[] = {
         "M - Toggle Model/Cube",
         "L - Toggle Lighting",
-        "A - Toggle Anti-Aliasing",
+        "A - Cycle Anti-Aliasing",
+        "E - Toggle On-demand Rendering",
         "F - Toggle Wireframe",
         "C - Toggle Face Culling",
         "R - Reset Camera",
@@ -267,8 +240,10 @@ void TextOverlay::renderHelp(int fbWidth, int fbHeight, bool modelMode) const
 
     int maxChars = 0;
     for (int i=0 ; i < nlines; ++i) maxChars = std::max<int>(maxChars, (int)std::strlen(lines[i]));
+    maxChars = std::max<int>(maxChars, (int)status_.size());
+    const int rows = nlines + (status_.empty() ? 0 : 1);
     int panelW = (int)(pad*2 + (maxChars * 6.0f * scale));
-    int panelH = (int)(pad*2 + 22.0f + (nlines * (9.0f * scale)));
+    int panelH = (int)(pad*2 + 22.0f + (rows * (9.0f * scale)));
 
     // Background panel (semi-transparent)
     drawRect(fbWidth, fbHeight, 8.0f, 8.0f, (float)panelW, (float)panelH, 0.05f, 0.06f, 0.08f, 0.8f);
@@ -281,4 +256,8 @@ void TextOverlay::renderHelp(int fbWidth, int fbHeight, bool modelMode) const
     {
         drawString(fbWidth, fbHeight, x, y + i * (9.0f * scale), scale, lines[i], 0.9f,0.9f,0.9f,1.0f);
     }
+    if (!status_.empty())
+    {
+        drawString(fbWidth, fbHeight, x, y + nlines * (9.0f * scale), scale, status_, 0.6f,0.6f,0.6f,1.0f);
+    }
 }
@@ -1,16 +1,24 @@
 #pragma once
+#include <memory>
 #include <string>
 #include <vector>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
-class TextOverlay {
+#include "gfx/RenderQueue.hpp"
+#include "gfx/Shader.hpp"
+
+class TextOverlay : public RenderQueue::Submitter {
 public:
     void init();
     void shutdown();
 
     // Render a translucent panel with white text lines at top-left.
     void renderHelp(int fbWidth, int fbHeight, bool modelMode) const;
+    // Queue renderHelp() for the overlay pass
+    void submitHelp(RenderQueue& queue, int fbWidth, int fbHeight, bool modelMode);
+    // Extra line shown dimmed under the help text (e.g. startup stats); empty hides it
+    void setStatus(const std::string& status) { status_ = status; }
 
     // Low-level: draw a string at pixel position with given color.
     void drawString(int fbWidth, int fbHeight, float x, float y, float scale, const std::string& text, float r, float g, float b, float a) const;
@@ -18,9 +26,15 @@ public:
     // Draw a solid rect at pixel coordinates.
     void drawRect(int fbWidth, int fbHeight, float x, float y, float w, float h, float r, float g, float b, float a) const;
 
+    // RenderQueue::Submitter
+    void draw(uint32_t item) const override;
+
 private:
+    struct Help { int fbWidth = 0, fbHeight = 0; bool modelMode = false; };
+    Help help_;
+    std::string status_;
     unsigned int vao_ = 0, vbo_ = 0;
-    unsigned int prog_ = 0;
+    std::unique_ptr<Shader> shader_;
 
     void ensureGL() const;
     static void buildGlyph(char c, std::vector<float>& outXY, float x, float y, float px, float py, float scale);
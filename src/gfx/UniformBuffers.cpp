@@ -0,0 +1,135 @@
+#include "gfx/UniformBuffers.hpp"
+#include "gfx/Shader.hpp"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+// std140 mirrors of the GLSL blocks
+struct FrameBlock {
+    glm::mat4 view;
+    glm::mat4 proj;
+    glm::mat4 viewProj;
+    glm::vec4 viewPos;   // xyz
+    glm::vec4 lightDir;  // xyz
+    glm::vec4 envSky;    // rgb, a = intensity
+    glm::vec4 envGround; // rgb
+    int32_t flags[4];    // lighting, environment
+    float wireWidth;     // wireframe edge width in target pixels
+    float pad[3];        // std140 rounds the block up to a vec4
+};
+static_assert(sizeof(FrameBlock) == 3 * 64 + 6 * 16, "Frame block must match std140 layout");
+
+struct MaterialBlock {
+    glm::vec4 baseColorFactor;
+    float normalScale;
+    uint32_t hasBaseColorTex;
+    uint32_t hasNormalTex;
+    uint32_t pad;
+};
+static_assert(sizeof(MaterialBlock) == 32, "Material block must match std140 layout");
+
+} // namespace
+
+FrameUniforms::~FrameUniforms()
+{
+    shutdown();
+}
+
+void FrameUniforms::init()
+{
+    if (ubo_) return;
+    glGenBuffers(1, &ubo_);
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameBlock), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void FrameUniforms::update(const Camera& cam, const Lighting& lighting)
+{
+    if (!ubo_) init();
+
+    FrameBlock b;
+    b.view = cam.view();
+    b.proj = cam.proj();
+    b.viewProj = cam.proj() * cam.view();
+    b.viewPos = glm::vec4(cam.eye(), 1.0f);
+    b.lightDir = glm::vec4(lighting.lightDir, 0.0f);
+    b.envSky = glm::vec4(lighting.envSky, lighting.envIntensity);
+    b.envGround = glm::vec4(lighting.envGround, 0.0f);
+    b.flags[0] = lighting.useLighting ? 1 : 0;
+    b.flags[1] = lighting.useEnv ? 1 : 0;
+    b.flags[2] = b.flags[3] = 0;
+    b.wireWidth = lighting.wireWidth;
+    b.pad[0] = b.pad[1] = b.pad[2] = 0.0f;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(b), &b);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, Shader::FrameBlockBinding, ubo_);
+}
+
+void FrameUniforms::shutdown()
+{
+    if (ubo_)
+    {
+        glDeleteBuffers(1, &ubo_);
+        ubo_ = 0;
+    }
+}
+
+MaterialBuffer::~MaterialBuffer()
+{
+    shutdown();
+}
+
+void MaterialBuffer::upload(const std::vector<Params>& materials)
+{
+    GLint align = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &align);
+    if (align <= 0) align = 256;
+    stride_ = (sizeof(MaterialBlock) + size_t(align) - 1) / size_t(align) * size_t(align);
+
+    // Always keep a default material so bind(0) is valid
+    const size_t n = materials.empty() ? 1 : materials.size();
+    std::vector<unsigned char> data(n * stride_, 0);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Params p = materials.empty() ? Params{} : materials[i];
+        MaterialBlock b;
+        b.baseColorFactor = p.baseColorFactor;
+        b.normalScale = p.normalScale;
+        b.hasBaseColorTex = p.hasBaseColorTex ? 1u : 0u;
+        b.hasNormalTex = p.hasNormalTex ? 1u : 0u;
+        b.pad = 0;
+        std::memcpy(data.data() + i * stride_, &b, sizeof(b));
+    }
+
+    if (!ubo_) glGenBuffers(1, &ubo_);
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+    glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr)data.size(), data.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    count_ = (int)n;
+}
+
+void MaterialBuffer::bind(int index) const
+{
+    if (!ubo_ || index < 0 || index >= count_) return;
+    glBindBufferRange(GL_UNIFORM_BUFFER, Shader::MaterialBlockBinding, ubo_,
+                      (GLintptr)(size_t(index) * stride_), (GLsizeiptr)sizeof(MaterialBlock));
+}
+
+void MaterialBuffer::shutdown()
+{
+    if (ubo_)
+    {
+        glDeleteBuffers(1, &ubo_);
+        ubo_ = 0;
+    }
+    count_ = 0;
+    stride_ = 0;
+}
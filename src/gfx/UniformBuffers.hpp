@@ -0,0 +1,64 @@
+#pragma once
+#include <vector>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "core/Camera.hpp"
+
+using GLuint = unsigned int;
+
+// Camera and lighting shared by every program through the "Frame" uniform block
+// (std140, declared in assets/shaders). Written and bound once per frame.
+class FrameUniforms {
+public:
+    struct Lighting {
+        glm::vec3 lightDir{-0.5934f, 0.5934f, -0.3560f}; // normalized (-1, 1, -0.6)
+        bool useLighting = true;
+        bool useEnv = false;                              // hemisphere + reflection tint
+        glm::vec3 envSky{0.70f, 0.78f, 0.95f};
+        glm::vec3 envGround{0.50f, 0.50f, 0.52f};
+        float envIntensity = 0.75f;
+        float wireWidth = 1.0f;                           // edge width in target pixels (Phong::Wireframe)
+    };
+
+    FrameUniforms() = default;
+    ~FrameUniforms();
+    FrameUniforms(const FrameUniforms&) = delete;
+    FrameUniforms& operator=(const FrameUniforms&) = delete;
+
+    void init();
+    void update(const Camera& cam, const Lighting& lighting);
+    void shutdown();
+
+private:
+    GLuint ubo_ = 0;
+};
+
+// Material parameters for the "Material" uniform block. All materials of an object
+// live in one buffer, each at an offset aligned to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT,
+// and a draw selects its range with bind().
+class MaterialBuffer {
+public:
+    struct Params {
+        glm::vec4 baseColorFactor{1.0f};
+        float normalScale = 1.0f;
+        bool hasBaseColorTex = false;
+        bool hasNormalTex = false;
+    };
+
+    MaterialBuffer() = default;
+    ~MaterialBuffer();
+    MaterialBuffer(const MaterialBuffer&) = delete;
+    MaterialBuffer& operator=(const MaterialBuffer&) = delete;
+
+    void upload(const std::vector<Params>& materials);
+    void bind(int index) const;
+    int count() const { return count_; }
+    void shutdown();
+
+private:
+    GLuint ubo_ = 0;
+    size_t stride_ = 0;
+    int count_ = 0;
+};
@@ -0,0 +1,131 @@
+#include "gfx/WeightedOit.hpp"
+#include "gfx/DynamicResolution.hpp"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+
+WeightedOit::~WeightedOit()
+{
+    shutdown();
+}
+
+void WeightedOit::init()
+{
+    if (composite_) return;
+    composite_ = Shader::FromFiles("assets/shaders/fullscreen.vert", "assets/shaders/oit.frag");
+    composite_->use();
+    glUniform1i(composite_->loc("uAccum"), 0);
+    glUniform1i(composite_->loc("uWeight"), 1);
+    glGenVertexArrays(1, &vao_);
+}
+
+void WeightedOit::resize(int width, int height)
+{
+    releaseTargets();
+    width_ = width;
+    height_ = height;
+
+    auto makeTarget = [&](GLuint& tex, GLenum internalFormat, GLenum format) {
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_HALF_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    };
+    makeTarget(accumTex_, GL_RGBA16F, GL_RGBA);
+    makeTarget(weightTex_, GL_R16F, GL_RED);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Same format as the DynamicResolution scene target's depth, the blit source in begin()
+    glGenRenderbuffers(1, &depthRbo_);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRbo_);
+    glRenderbufferStorage(GL_RENDERBUFFER, DynamicResolution::kDepthFormat, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &fbo_);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, accumTex_, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, weightTex_, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRbo_);
+    const GLenum buffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+    glDrawBuffers(2, buffers);
+    glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)prevFbo_);
+}
+
+void WeightedOit::begin()
+{
+    GLint viewport[4] = {};
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prevFbo_);
+    if (viewport[2] > width_ || viewport[3] > height_ || !fbo_)
+        resize(std::max(viewport[2], width_), std::max(viewport[3], height_));
+    viewWidth_ = viewport[2];
+    viewHeight_ = viewport[3];
+
+    // Opaque depth occludes transparent fragments; a multisampled source is resolved
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)prevFbo_);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo_);
+    glBlitFramebuffer(viewport[0], viewport[1], viewport[0] + viewWidth_, viewport[1] + viewHeight_,
+                      0, 0, viewWidth_, viewHeight_, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    glViewport(0, 0, viewWidth_, viewHeight_);
+
+    const GLfloat accumClear[4] = { 0.0f, 0.0f, 0.0f, 1.0f }; // alpha = revealage
+    const GLfloat weightClear[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    glClearBufferfv(GL_COLOR, 0, accumClear);
+    glClearBufferfv(GL_COLOR, 1, weightClear);
+
+    glDepthMask(GL_FALSE);
+    glEnable(GL_BLEND);
+    glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+    prevViewportX_ = viewport[0];
+    prevViewportY_ = viewport[1];
+}
+
+void WeightedOit::composite()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)prevFbo_);
+    glViewport(prevViewportX_, prevViewportY_, viewWidth_, viewHeight_);
+
+    const GLboolean depthWasOn = glIsEnabled(GL_DEPTH_TEST);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    composite_->use();
+    glUniform2i(composite_->loc("uOrigin"), prevViewportX_, prevViewportY_);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, accumTex_);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, weightTex_);
+    glBindVertexArray(vao_);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    if (depthWasOn) glEnable(GL_DEPTH_TEST);
+}
+
+void WeightedOit::releaseTargets()
+{
+    if (fbo_) glDeleteFramebuffers(1, &fbo_);
+    if (accumTex_) glDeleteTextures(1, &accumTex_);
+    if (weightTex_) glDeleteTextures(1, &weightTex_);
+    if (depthRbo_) glDeleteRenderbuffers(1, &depthRbo_);
+    fbo_ = accumTex_ = weightTex_ = depthRbo_ = 0;
+    width_ = height_ = 0;
+}
+
+void WeightedOit::shutdown()
+{
+    releaseTargets();
+    if (vao_)
+    {
+        glDeleteVertexArrays(1, &vao_);
+        vao_ = 0;
+    }
+    composite_.reset();
+}
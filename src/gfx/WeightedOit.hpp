@@ -0,0 +1,43 @@
+#pragma once
+#include <memory>
+
+#include "gfx/Shader.hpp"
+
+using GLuint = unsigned int;
+
+// Weighted blended order-independent transparency (McGuire and Bavoil 2013).
+//
+// Transparent fragments are accumulated unsorted into two float targets that share a
+// copy of the scene depth: target 0 sums depth-weighted premultiplied color and keeps
+// the product of (1 - alpha) in alpha, target 1 sums the weights. One global
+// glBlendFuncSeparate covers both, so this works on 3.3 without per-target blending.
+// A full-screen pass then resolves the average color over the opaque image.
+// Targets grow with the viewport and are (re)created on demand; a smaller viewport
+// (scaled scene target) uses their lower-left corner.
+class WeightedOit {
+public:
+    WeightedOit() = default;
+    ~WeightedOit();
+    WeightedOit(const WeightedOit&) = delete;
+    WeightedOit& operator=(const WeightedOit&) = delete;
+
+    void init();
+    // Copy the current framebuffer's depth, bind and clear the targets and set blending.
+    // Shaders write their OIT outputs until composite().
+    void begin();
+    // Return to the framebuffer bound at begin() and blend the resolved layers over it
+    void composite();
+    void shutdown();
+
+private:
+    GLuint fbo_ = 0, accumTex_ = 0, weightTex_ = 0, depthRbo_ = 0;
+    GLuint vao_ = 0;   // empty; the composite triangle comes from gl_VertexID
+    int width_ = 0, height_ = 0;               // allocated size
+    int viewWidth_ = 0, viewHeight_ = 0;       // viewport size at begin()
+    int prevFbo_ = 0;                          // framebuffer and viewport origin at begin()
+    int prevViewportX_ = 0, prevViewportY_ = 0;
+    std::unique_ptr<Shader> composite_;
+
+    void resize(int width, int height);
+    void releaseTargets();
+};
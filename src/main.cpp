@@ -1,7 +1,9 @@
 #include "platform/glfw/GlfwWindow.hpp"
 #include "app/ModelViewerApp.hpp"
 
-int main() {
+#include <cstring>
+
+int main(int argc, char** argv) {
     WindowProps props;
     props.title = "OpenGL — Model Viewer";
     props.width = 1280; props.height = 720;
@@ -9,5 +11,10 @@ int main() {
 
     auto window = std::make_unique<GlfwWindow>(props);
     ModelViewerApp app(std::move(window));
+    // --render-thread: GL on a dedicated thread, input and simulation on this one
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--render-thread") == 0) app.SetRenderThread(true);
+    }
     return app.Run();
 }
\ No newline at end of file
@@ -19,15 +19,22 @@ GlfwWindow::GlfwWindow(const WindowProps& props)
         if (!glfwInit()) throw std::runtime_error("GLFW init failed");
     }
 
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_DEPTH_BITS, 24);
     glfwWindowHint(GLFW_STENCIL_BITS, 8);
-    // Request 4x MSAA for smoother edges
-    glfwWindowHint(GLFW_SAMPLES, 4);
+    // MSAA lives in the scene target (DynamicResolution); the window only receives the
+    // upscaled image, and blits need a single-sampled default framebuffer
+    glfwWindowHint(GLFW_SAMPLES, 0);
 
-    m_Handle = glfwCreateWindow(props.width, props.height, props.title.c_str(), nullptr, nullptr);
+    // Prefer a 4.6/4.3 core context for the GPU-driven path; everything else needs 3.3
+    const int versions[][2] = { {4, 6}, {4, 3}, {3, 3} };
+    for (const auto& v : versions)
+    {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, v[0]);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, v[1]);
+        m_Handle = glfwCreateWindow(props.width, props.height, props.title.c_str(), nullptr, nullptr);
+        if (m_Handle) break;
+    }
 
     if (!m_Handle) 
     {
@@ -48,7 +55,8 @@ GlfwWindow::GlfwWindow(const WindowProps& props)
     // keyboard
     glfwSetKeyCallback(m_Handle, [](GLFWwindow* win, int key, int sc, int action, int mods)
     {
-        (void)win; (void)sc; (void)mods;
+        (void)sc; (void)mods;
+        MarkEvent(win);
         if (action == GLFW_PRESS)
         {
             Input::SetKeyState(key, true);
@@ -62,7 +70,8 @@ GlfwWindow::GlfwWindow(const WindowProps& props)
     // mouse buttons
     glfwSetMouseButtonCallback(m_Handle, [](GLFWwindow* win, int button, int action, int mods)
     {
-        (void)win; (void)mods;
+        (void)mods;
+        MarkEvent(win);
         if (action == GLFW_PRESS)  
         {
             Input::SetMouseButton(button, true);
@@ -76,15 +85,25 @@ GlfwWindow::GlfwWindow(const WindowProps& props)
     // cursor position
     glfwSetCursorPosCallback(m_Handle, [](GLFWwindow* win, double x, double y)
     {
-        (void)win; Input::SetMousePos(x, y);
+        Input::SetMousePos(x, y);
+        // Hovering changes nothing on screen; only drags move the camera
+        if (glfwGetMouseButton(win, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS ||
+            glfwGetMouseButton(win, GLFW_MOUSE_BUTTON_MIDDLE) == GLFW_PRESS)
+        {
+            MarkEvent(win);
+        }
     });
 
     // scroll
     glfwSetScrollCallback(m_Handle, [](GLFWwindow* win, double dx, double dy)
     {
-        (void)win; Input::AddScroll(dx, dy);
+        MarkEvent(win);
+        Input::AddScroll(dx, dy);
     });
 
+    // exposed or damaged by the window system
+    glfwSetWindowRefreshCallback(m_Handle, &GlfwWindow::MarkEvent);
+
     glfwSetFramebufferSizeCallback(m_Handle, &GlfwWindow::FramebufferSizeCallback);
     glfwGetFramebufferSize(m_Handle, &m_FBWidth, &m_FBHeight);
 }
@@ -107,11 +126,26 @@ void GlfwWindow::PollEvents()
     glfwPollEvents(); 
 }
 
+void GlfwWindow::WaitEvents(double timeout)
+{
+    glfwWaitEventsTimeout(timeout);
+}
+
+void GlfwWindow::PostEmptyEvent()
+{
+    glfwPostEmptyEvent();
+}
+
 void GlfwWindow::SwapBuffers() 
 { 
     glfwSwapBuffers(m_Handle); 
 }
 
+void GlfwWindow::MakeContextCurrent(bool current)
+{
+    glfwMakeContextCurrent(current ? m_Handle : nullptr);
+}
+
 bool GlfwWindow::ShouldClose() const 
 { 
     return glfwWindowShouldClose(m_Handle); 
@@ -133,4 +167,10 @@ void GlfwWindow::FramebufferSizeCallback(GLFWwindow* win, int w, int h)
     auto* self = static_cast<GlfwWindow*>(glfwGetWindowUserPointer(win));
     self->m_FBWidth = w; 
     self->m_FBHeight = h;
+    ++self->m_Events;
+}
+
+void GlfwWindow::MarkEvent(GLFWwindow* win)
+{
+    ++static_cast<GlfwWindow*>(glfwGetWindowUserPointer(win))->m_Events;
 }
@@ -11,7 +11,11 @@ public:
     ~GlfwWindow() override;
 
     void PollEvents() override;
+    void WaitEvents(double timeout) override;
+    uint64_t EventCount() const override { return m_Events; }
+    void PostEmptyEvent() override;
     void SwapBuffers() override;
+    void MakeContextCurrent(bool current) override;
     bool ShouldClose() const override;
 
     void SetTitle(const std::string& title) override;
@@ -22,10 +26,12 @@ public:
 
 private:
     static void FramebufferSizeCallback(GLFWwindow* win, int w, int h);
+    static void MarkEvent(GLFWwindow* win);
 
 private:
     GLFWwindow* m_Handle = nullptr;
     bool m_VSync = true;
     int m_FBWidth = 0;
     int m_FBHeight = 0;
+    uint64_t m_Events = 0;
 };
\ No newline at end of file
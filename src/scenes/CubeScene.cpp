@@ -80,7 +80,10 @@ void CubeScene::init()
 
     glBindVertexArray(0);
 
-    shader_ = Shader::FromFiles("assets/shaders/phong.vert", "assets/shaders/phong.frag");
+    shaders_ = Phong::Load();
+    shaders_->precompile({ Phong::Lighting, 0 }); // lighting on and off
+    // Phong shader defaults used by cube (no textures, factor=1)
+    material_.upload({MaterialBuffer::Params{}});
     initialized_ = true;
 }
 
@@ -90,41 +93,31 @@ void CubeScene::update(float dt)
     model_ = glm::rotate(glm::mat4(1.0f), angle_, glm::vec3(0.3f, 1.0f, 0.2f));
 }
 
-void CubeScene::render(const Camera& cam) 
+void CubeScene::submit(RenderQueue& queue, const Camera& cam, uint32_t features)
 {
     if (!initialized_) return;
+    shader_ = &shaders_->get(features);
+    const float depth = -(cam.view() * model_[3]).z;
+    queue.submit(RenderQueue::MakeKey(RenderQueue::Pass::Opaque, shader_->id(), 0, depth), this, 0);
+}
+
+void CubeScene::bind(RenderQueue::Pass) const
+{
     shader_->use();
 
     // normal matrix = transpose(inverse(mat3(model)))
     glm::mat3 normalMat = glm::transpose(glm::inverse(glm::mat3(model_)));
     glUniformMatrix4fv(shader_->loc("uModel"), 1, GL_FALSE, &model_[0][0]);
-    glUniformMatrix4fv(shader_->loc("uView"),  1, GL_FALSE, &cam.view()[0][0]);
-    glUniformMatrix4fv(shader_->loc("uProj"),  1, GL_FALSE, &cam.proj()[0][0]);
     glUniformMatrix3fv(shader_->loc("uNormalMat"), 1, GL_FALSE, &normalMat[0][0]);
 
-    // lighting uniforms
-    // Light coming from (−1,+1,−0.6) direction toward the origin
-    const float len = sqrtf(1.f * 1.f + 1.f * 1.f + 0.6f * 0.6f);
-    const float lx = -1.0f / len, ly = 1.0f / len, lz = -0.6f / len;
-    glUniform3f(shader_->loc("uLightDir"), lx, ly, lz);
-
-    // camera position: derive from inverse of view if you don't store it
-    // Here we reconstruct from view matrix (approx): inverse(view)*[0,0,0,1]
-    // Simpler: pass it from app via a uniform; but we'll keep it here as (0,0,0) in view space mapped to world.
-    // If your Camera doesn’t expose eye(), set your OrbitCamera to keep target & radius and compute eye similarly.
-    // For now, set a reasonable eye for specular highlight:
-    // (Optional TODO: expose Camera::eye())
-    glUniform3f(shader_->loc("uViewPos"), 4.0f, 3.0f, 4.0f);
-
-    glUniform1i(shader_->loc("uUseLighting"), lighting_ ? 1 : 0);
-    // Phong shader defaults used by cube (no textures, factor=1)
-    glUniform1i(shader_->loc("uHasBaseColorTex"), 0);
-    glUniform4f(shader_->loc("uBaseColorFactor"), 1.0f, 1.0f, 1.0f, 1.0f);
-    glUniform1i(shader_->loc("uUseEnv"), 0);
-
+    // Camera and lighting come from the per-frame uniform block; sampler units are set at link
+    material_.bind(0);
     glBindVertexArray(vao_);
+}
+
+void CubeScene::draw(uint32_t) const
+{
     glDrawArrays(GL_TRIANGLES, 0, vertexCount_);
-    glBindVertexArray(0);
 }
 
 void CubeScene::shutdown() 
@@ -139,7 +132,9 @@ void CubeScene::shutdown()
         glDeleteVertexArrays(1, &vao_); 
         vao_ = 0; 
     }
-    shader_.reset();
+    material_.shutdown();
+    shaders_.reset();
+    shader_ = nullptr;
     initialized_ = false;
 }
 
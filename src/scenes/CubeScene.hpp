@@ -5,6 +5,9 @@
 
 #include "core/Camera.hpp"
 #include "gfx/Shader.hpp"
+#include "gfx/ShaderVariants.hpp"
+#include "gfx/UniformBuffers.hpp"
+#include "gfx/RenderQueue.hpp"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -15,24 +18,28 @@
 
 using GLuint = unsigned int;
 
-class CubeScene {
+class CubeScene : public RenderQueue::Submitter {
 public:
     CubeScene() = default;
     ~CubeScene();
 
     void init();
     void update(float dt);
-    void render(const Camera& cam);
+    // features: Phong::Lighting / Phong::Environment for this frame
+    void submit(RenderQueue& queue, const Camera& cam, uint32_t features);
     void shutdown();
 
-    void setLighting(bool on) { lighting_ = on; }
+    // RenderQueue::Submitter
+    void bind(RenderQueue::Pass pass) const override;
+    void draw(uint32_t item) const override;
 
 private:
     bool initialized_ = false;
-    bool lighting_    = true;       // <- toggle via 'L'
     GLuint vao_ = 0, vbo_ = 0;
     int vertexCount_ = 0;          // non-indexed draw (36 verts)
-    std::unique_ptr<Shader> shader_;
+    std::shared_ptr<ShaderVariants> shaders_; // shared with the other phong scenes
+    const Shader* shader_ = nullptr; // variant of the current frame
+    MaterialBuffer material_;      // single default material
     glm::mat4 model_{1.0f};
     float angle_ = 0.0f;
 };
\ No newline at end of file
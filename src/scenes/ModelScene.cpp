@@ -1,6 +1,8 @@
 #include "scenes/ModelScene.hpp"
 #include "gfx/Model.hpp"
 #include "gfx/Shader.hpp"
+#include "gfx/ShaderVariants.hpp"
+#include "gfx/GLExt.hpp"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -14,9 +16,12 @@ ModelScene::~ModelScene()
 
 bool ModelScene::init(const std::string& objPath) 
 {
-    if (!shader_)
+    if (!shaders_)
     {
-        shader_ = Shader::FromFiles("assets/shaders/phong.vert", "assets/shaders/phong.frag");
+        shaders_ = Phong::Load();
+        // What lit meshes need on their first frame, built in one go
+        const uint32_t lit = Phong::Lighting | Phong::Environment;
+        shaders_->precompile({ lit, lit | Phong::BaseColorTex, lit | Phong::BaseColorTex | Phong::NormalTex });
     }
     if (!model_)
     {
@@ -27,9 +32,9 @@ bool ModelScene::init(const std::string& objPath)
 
 bool ModelScene::load(const std::string& objPath)
 {
-    if (!shader_)
+    if (!shaders_)
     {
-        shader_ = Shader::FromFiles("assets/shaders/phong.vert", "assets/shaders/phong.frag");
+        shaders_ = Phong::Load();
     }
     if (!model_)
     {
@@ -40,6 +45,8 @@ bool ModelScene::load(const std::string& objPath)
         model_->shutdown();
     }
 
+    path_ = objPath;
+    configure(*model_);
     if (!model_->load(objPath)) 
     {
         err_ = model_->lastError();
@@ -61,36 +68,109 @@ bool ModelScene::load(const std::string& objPath)
     return true;
 }
 
-void ModelScene::update(float dt) 
+bool ModelScene::reload()
 {
-    (void)dt; 
+    if (!initialized_) return false;
+    if (!model_->reloadsInPlace())
+    {
+        // Load next to the current model, which stays on screen if the file is bad
+        auto fresh = std::make_unique<Model>();
+        configure(*fresh);
+        if (!fresh->load(path_))
+        {
+            err_ = fresh->lastError();
+            return false;
+        }
+        model_ = std::move(fresh);
+        return true;
+    }
+    if (!model_->reload())
+    {
+        err_ = model_->lastError();
+        return false;
+    }
+    return true;
 }
 
-void ModelScene::render(const Camera& cam) 
+void ModelScene::configure(Model& model) const
 {
-    if (!initialized_) return;
+    model.setBatched(batched_);
+    model.setGpuDriven(gpuDriven_);
+    model.setOcclusionCulling(occlusion_);
+    model.setOcclusionQueries(queries_);
+    auto prepass = prepassByPath_.find(path_);
+    model.setDepthPrepass(prepass != prepassByPath_.end() && prepass->second);
+}
+
+const std::vector<std::string>& ModelScene::sourceFiles() const
+{
+    static const std::vector<std::string> none;
+    return model_ ? model_->sourceFiles() : none;
+}
+
+void ModelScene::setBatched(bool on)
+{
+    batched_ = on;
+    if (model_) model_->setBatched(on);
+}
+
+void ModelScene::setGpuDriven(bool on)
+{
+    gpuDriven_ = on && GLExt::HasComputeIndirect();
+    if (gpuDriven_ && !cullShader_)
+    {
+        cullShader_ = Shader::ComputeFromFile("assets/shaders/cull.comp");
+    }
+    if (model_) model_->setGpuDriven(gpuDriven_);
+}
+
+void ModelScene::setOcclusionCulling(bool on)
+{
+    occlusion_ = on;
+    if (model_) model_->setOcclusionCulling(on);
+}
+
+void ModelScene::setOcclusionQueries(bool on)
+{
+    queries_ = on;
+    if (model_) model_->setOcclusionQueries(on);
+}
+
+void ModelScene::setDepthPrepass(bool on)
+{
+    if (on && !depthShader_)
+    {
+        depthShader_ = Shader::FromFiles("assets/shaders/phong.vert", "assets/shaders/depth.frag");
+        Phong::SetSamplerUnits(*depthShader_);
+    }
+    prepassByPath_[path_] = on;
+    if (model_) model_->setDepthPrepass(on);
+}
 
-    shader_->use();
+void ModelScene::update(float dt) 
+{
+    if (!initialized_) return;
+    model_->update(dt);
+}
 
-    // set light and eye
-    const float len = sqrtf(1.f * 1.f + 1.f * 1.f + 0.6f * 0.6f);
-    glUniform3f(shader_->loc("uLightDir"), -1.0f / len, 1.0f / len, -0.6f / len);
-    glUniform3f(shader_->loc("uViewPos"), 4.0f, 3.0f, 4.0f); // TODO: supply real camera eye
-    glUniform1i(shader_->loc("uUseLighting"), lighting_ ? 1 : 0);
+void ModelScene::submit(RenderQueue& queue, const Camera& cam, uint32_t features)
+{
+    if (!initialized_) return;
 
-    // Environment lighting to brighten and add reflections
-    glUniform1i(shader_->loc("uUseEnv"), 1);
-    glUniform3f(shader_->loc("uEnvSkyColor"),   0.70f, 0.78f, 0.95f);
-    glUniform3f(shader_->loc("uEnvGroundColor"),0.50f, 0.50f, 0.52f);
-    glUniform1f(shader_->loc("uEnvIntensity"),  lighting_ ? 0.75f : 0.50f);
+    // Light, eye and environment come from the per-frame uniform block
+    model_->submit(queue, cam, modelM_, *shaders_, features, cullShader_.get(), depthShader_.get());
+}
 
-    model_->render(cam, modelM_, *shader_);
+size_t ModelScene::shaderVariants() const
+{
+    return shaders_ ? shaders_->compiledCount() : 0;
 }
 
 void ModelScene::shutdown() 
 {
     if (model_) model_->shutdown();
     model_.reset();
-    shader_.reset();
+    shaders_.reset();
+    cullShader_.reset();
     initialized_ = false;
 }
@@ -1,11 +1,14 @@
 #pragma once
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <glm/mat4x4.hpp>
 
 #include "gfx/Model.hpp"
 
 class Shader;
+class ShaderVariants;
 class Camera;
 class Model;
 
@@ -17,20 +20,49 @@ public:
     // call before first render
     bool init(const std::string& objPath);
 
-    // Load or reload a model file (.gltf/.glb). Keeps shader.
+    // Load or reload a model file (.gltf/.glb/.obj/.stl). Keeps shader.
     bool load(const std::string& objPath);
 
+    // Pick up on-disk changes to the current model, keeping the framing
+    bool reload();
+    const std::vector<std::string>& sourceFiles() const;
+    const Model* model() const { return model_.get(); }
+
+    // Texture-array batching (see Model::setBatched); kept across model switches
+    void setBatched(bool on);
+    // Compute-culled multi-draw-indirect path; ignored without GL 4.3
+    void setGpuDriven(bool on);
+    // CPU occlusion culling (see Model::setOcclusionCulling)
+    void setOcclusionCulling(bool on);
+    // Hardware occlusion queries (see Model::setOcclusionQueries)
+    void setOcclusionQueries(bool on);
+    // Depth pre-pass for the current model (see Model::setDepthPrepass); remembered per
+    // file, since it only pays off for models with heavy overdraw
+    void setDepthPrepass(bool on);
+
     void update(float dt);
-    void render(const Camera& cam);
+    // features: Phong::Lighting / Phong::Environment for this frame
+    void submit(RenderQueue& queue, const Camera& cam, uint32_t features);
+    // Phong variants built so far
+    size_t shaderVariants() const;
     void shutdown();
 
-    void setLighting(bool on) { lighting_ = on; }
     const std::string& lastError() const { return err_; }
 
 private:
+    // Apply the scene's toggles to a model before it loads
+    void configure(Model& model) const;
+
     bool initialized_ = false;
-    bool lighting_    = true;
-    std::unique_ptr<Shader> shader_;
+    bool batched_     = false;
+    bool gpuDriven_   = false;
+    bool occlusion_   = false;
+    bool queries_     = false;
+    std::shared_ptr<ShaderVariants> shaders_; // shared with the other phong scenes
+    std::unique_ptr<Shader> cullShader_;  // GPU-driven path only
+    std::unique_ptr<Shader> depthShader_; // depth pre-pass only
+    std::string path_;
+    std::unordered_map<std::string, bool> prepassByPath_;
     std::unique_ptr<Model>  model_;
 
     glm::mat4 modelM_{1.0f};
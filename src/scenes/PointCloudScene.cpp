@@ -0,0 +1,71 @@
+#include "scenes/PointCloudScene.hpp"
+#include "gfx/PointCloud.hpp"
+#include "gfx/Shader.hpp"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+PointCloudScene::~PointCloudScene()
+{
+    shutdown();
+}
+
+bool PointCloudScene::load(const std::string& path)
+{
+    if (!shader_)
+    {
+        shader_ = Shader::FromFiles("assets/shaders/points.vert", "assets/shaders/points.frag");
+    }
+    if (!cloud_)
+    {
+        cloud_ = std::make_unique<PointCloud>();
+    }
+
+    initialized_ = false;
+    if (!cloud_->load(path))
+    {
+        err_ = cloud_->lastError();
+        return false;
+    }
+
+    // center and scale to unit size like ModelScene; scans are usually Z-up
+    glm::vec3 mn, mx; cloud_->getBounds(mn, mx);
+    glm::vec3 center = 0.5f * (mn + mx);
+    glm::vec3 size = (mx - mn);
+    float maxSide = std::max(size.x, std::max(size.y, size.z));
+    float s = (maxSide > 1e-6f) ? (1.0f / maxSide) : 1.0f;
+
+    modelM_ = glm::mat4(1.0f);
+    if (cloud_->isZUp())
+    {
+        modelM_ = glm::rotate(modelM_, -glm::radians(90.0f), glm::vec3(1, 0, 0));
+    }
+    modelM_ = glm::scale(modelM_, glm::vec3(s));
+    modelM_ = glm::translate(modelM_, -center);
+
+    initialized_ = true;
+    return true;
+}
+
+void PointCloudScene::submit(RenderQueue& queue, const Camera& cam, int viewportHeight)
+{
+    if (!initialized_) return;
+    cam_ = &cam;
+    viewportHeight_ = viewportHeight;
+    queue.submit(RenderQueue::MakeKey(RenderQueue::Pass::Opaque, shader_->id(), 0, 0.0f), this, 0);
+}
+
+void PointCloudScene::draw(uint32_t) const
+{
+    cloud_->render(*cam_, modelM_, *shader_, viewportHeight_);
+}
+
+void PointCloudScene::shutdown()
+{
+    if (cloud_) cloud_->shutdown();
+    cloud_.reset();
+    shader_.reset();
+    initialized_ = false;
+}
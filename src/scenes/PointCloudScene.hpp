@@ -0,0 +1,39 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <glm/mat4x4.hpp>
+
+#include "gfx/PointCloud.hpp"
+#include "gfx/RenderQueue.hpp"
+
+class Shader;
+class Camera;
+
+class PointCloudScene : public RenderQueue::Submitter {
+public:
+    PointCloudScene() = default;
+    ~PointCloudScene();
+
+    // Load or reload a point cloud (.ply/.las). Builds the octree cache on first use.
+    bool load(const std::string& path);
+
+    // The cloud draws as one opaque packet; LOD selection runs when it executes
+    void submit(RenderQueue& queue, const Camera& cam, int viewportHeight);
+    void shutdown();
+
+    // RenderQueue::Submitter
+    void draw(uint32_t item) const override;
+
+    const PointCloud* cloud() const { return cloud_.get(); }
+    const std::string& lastError() const { return err_; }
+
+private:
+    bool initialized_ = false;
+    std::unique_ptr<Shader> shader_;
+    std::unique_ptr<PointCloud> cloud_;
+
+    glm::mat4 modelM_{1.0f};
+    const Camera* cam_ = nullptr; // camera and viewport of the pending submit
+    int viewportHeight_ = 0;
+    std::string err_;
+};
@@ -0,0 +1,68 @@
+#include "scenes/SplatScene.hpp"
+#include "gfx/SplatCloud.hpp"
+#include "gfx/Shader.hpp"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+SplatScene::~SplatScene()
+{
+    shutdown();
+}
+
+bool SplatScene::load(const std::string& path)
+{
+    if (!shader_)
+    {
+        shader_ = Shader::FromFiles("assets/shaders/splat.vert", "assets/shaders/splat.frag");
+    }
+    if (!splats_)
+    {
+        splats_ = std::make_unique<SplatCloud>();
+    }
+
+    initialized_ = false;
+    if (!splats_->load(path))
+    {
+        err_ = splats_->lastError();
+        return false;
+    }
+
+    // center and scale to unit size; trained captures use a Y-down camera convention
+    glm::vec3 mn, mx; splats_->getBounds(mn, mx);
+    glm::vec3 center = 0.5f * (mn + mx);
+    glm::vec3 size = (mx - mn);
+    float maxSide = std::max(size.x, std::max(size.y, size.z));
+    float s = (maxSide > 1e-6f) ? (1.0f / maxSide) : 1.0f;
+
+    modelM_ = glm::rotate(glm::mat4(1.0f), glm::radians(180.0f), glm::vec3(1, 0, 0));
+    modelM_ = glm::scale(modelM_, glm::vec3(s));
+    modelM_ = glm::translate(modelM_, -center);
+
+    initialized_ = true;
+    return true;
+}
+
+void SplatScene::submit(RenderQueue& queue, const Camera& cam, int viewportWidth, int viewportHeight)
+{
+    if (!initialized_) return;
+    cam_ = &cam;
+    viewportWidth_ = viewportWidth;
+    viewportHeight_ = viewportHeight;
+    queue.submit(RenderQueue::MakeKey(RenderQueue::Pass::Transparent, shader_->id(), 0, 0.0f), this, 0);
+}
+
+void SplatScene::draw(uint32_t) const
+{
+    splats_->render(*cam_, modelM_, *shader_, viewportWidth_, viewportHeight_);
+}
+
+void SplatScene::shutdown()
+{
+    if (splats_) splats_->shutdown();
+    splats_.reset();
+    shader_.reset();
+    initialized_ = false;
+}
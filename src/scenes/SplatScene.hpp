@@ -0,0 +1,39 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <glm/mat4x4.hpp>
+
+#include "gfx/SplatCloud.hpp"
+#include "gfx/RenderQueue.hpp"
+
+class Shader;
+class Camera;
+
+class SplatScene : public RenderQueue::Submitter {
+public:
+    SplatScene() = default;
+    ~SplatScene();
+
+    // Load a Gaussian splat scene (.splat or 3DGS .ply)
+    bool load(const std::string& path);
+
+    // Splats sort themselves and draw as one transparent packet
+    void submit(RenderQueue& queue, const Camera& cam, int viewportWidth, int viewportHeight);
+    void shutdown();
+
+    // RenderQueue::Submitter
+    void draw(uint32_t item) const override;
+
+    const SplatCloud* splats() const { return splats_.get(); }
+    const std::string& lastError() const { return err_; }
+
+private:
+    bool initialized_ = false;
+    std::unique_ptr<Shader> shader_;
+    std::unique_ptr<SplatCloud> splats_;
+
+    glm::mat4 modelM_{1.0f};
+    const Camera* cam_ = nullptr; // camera and viewport of the pending submit
+    int viewportWidth_ = 0, viewportHeight_ = 0;
+    std::string err_;
+};